@@ -24,6 +24,7 @@ CPPFLAGS = \
     -Wall \
     -Wtype-limits \
     -Wconversion \
+    -Wvla \
     -I/usr/local/include \
     -I$(INCLUDE_PATH) \
     $(CPPFLAGS_EXTRA)
@@ -8,6 +8,11 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <cstdint>
 
 /*
@@ -84,6 +89,106 @@ namespace c8 {
 
     const std::size_t natural_digit_bits = 8 * sizeof(natural_digit);
 
+    /*
+     * Results of to_chars() and from_chars().  These follow the conventions of std::to_chars()
+     * and std::from_chars(): ptr is one past the last character written or consumed, and ec is
+     * a default-constructed std::errc on success.
+     *
+     * to_chars() never allocates for power-of-2 bases, or for decimal values below the
+     * recursive conversion threshold (at least 69 decimal digits).
+     */
+    struct to_chars_result {
+        char *ptr;
+        std::errc ec;
+    };
+
+    struct from_chars_result {
+        const char *ptr;
+        std::errc ec;
+    };
+
+    /*
+     * An allocation policy for the digits of natural numbers.
+     *
+     * Each thread has a current allocator, which is used whenever a natural number needs more
+     * digits than it can hold internally.  Every natural number remembers which allocator
+     * provided its digits, and returns them to that same allocator.
+     */
+    class natural_allocator {
+    public:
+        virtual ~natural_allocator() = default;
+
+        virtual auto allocate(std::size_t num_digits) -> natural_digit * = 0;
+        virtual auto deallocate(natural_digit *p, std::size_t num_digits) noexcept -> void = 0;
+
+        static auto current() noexcept -> natural_allocator &;
+        static auto heap() noexcept -> natural_allocator &;
+    };
+
+    /*
+     * Install an allocator as the current thread's natural allocator for the lifetime of
+     * this object, restoring the previous one when it is destroyed.
+     */
+    class natural_allocator_scope {
+    public:
+        explicit natural_allocator_scope(natural_allocator &a) noexcept;
+        natural_allocator_scope(const natural_allocator_scope &v) = delete;
+
+        ~natural_allocator_scope();
+
+        auto operator =(const natural_allocator_scope &v) -> natural_allocator_scope & = delete;
+
+    private:
+        natural_allocator *previous_;   // Allocator that was current before this one
+    };
+
+    /*
+     * A natural allocator that carves digits from large blocks, and only frees them when it
+     * is itself destroyed.  Deallocating the most recent allocation makes that space available
+     * again, which suits the short-lived temporaries of most expressions.
+     *
+     * Every natural number using digits from an arena must be destroyed before the arena.
+     */
+    class natural_arena_allocator : public natural_allocator {
+    public:
+        explicit natural_arena_allocator(std::size_t block_digits = 65536) noexcept;
+        natural_arena_allocator(const natural_arena_allocator &v) = delete;
+
+        ~natural_arena_allocator() override = default;
+
+        auto operator =(const natural_arena_allocator &v) -> natural_arena_allocator & = delete;
+
+        auto allocate(std::size_t num_digits) -> natural_digit * override;
+        auto deallocate(natural_digit *p, std::size_t num_digits) noexcept -> void override;
+
+    private:
+        std::vector<std::unique_ptr<natural_digit[]>> blocks_;
+                                        // Blocks of digits we've allocated
+        std::size_t block_digits_;      // Default size of each block, in digits
+        natural_digit *next_;           // Next free digit in the current block
+        std::size_t remaining_;         // Number of free digits in the current block
+    };
+
+    /*
+     * Deleter that returns a natural number's digits to the allocator that provided them.
+     */
+    struct natural_digits_deleter {
+        natural_allocator *allocator_;  // Allocator that provided the digits
+        std::size_t num_digits_;        // Number of digits that were allocated
+
+        auto operator ()(natural_digit *p) const noexcept -> void {
+            allocator_->deallocate(p, num_digits_);
+        }
+    };
+
+    class natural_divisor;
+    class montgomery_context;
+    class barrett_context;
+
+    namespace expr {
+        struct access;
+    }
+
     class natural {
     public:
         /*
@@ -108,14 +213,27 @@ namespace c8 {
         auto operator >=(const natural &v) const noexcept -> bool;
         auto operator <(const natural &v) const noexcept -> bool;
         auto operator <=(const natural &v) const noexcept -> bool;
+        auto operator ==(unsigned long long v) const noexcept -> bool;
+        auto operator !=(unsigned long long v) const noexcept -> bool;
+        auto operator >(unsigned long long v) const noexcept -> bool;
+        auto operator >=(unsigned long long v) const noexcept -> bool;
+        auto operator <(unsigned long long v) const noexcept -> bool;
+        auto operator <=(unsigned long long v) const noexcept -> bool;
 
         auto operator +(const natural &v) const -> natural;
         auto operator -(const natural &v) const -> natural;
         auto operator *(const natural &v) const -> natural;
         auto operator /(const natural &v) const -> natural;
         auto operator %(const natural &v) const -> natural;
+        auto operator /(const natural_divisor &v) const -> natural;
+        auto operator %(const natural_divisor &v) const -> natural;
         auto operator <<(unsigned int count) const -> natural;
         auto operator >>(unsigned int count) const -> natural;
+        auto operator +(unsigned long long v) const -> natural;
+        auto operator -(unsigned long long v) const -> natural;
+        auto operator *(unsigned long long v) const -> natural;
+        auto operator /(unsigned long long v) const -> natural;
+        auto operator %(unsigned long long v) const -> natural;
 
         auto operator =(const natural &v) -> natural &;
         auto operator =(natural &&v) noexcept -> natural &;
@@ -126,10 +244,23 @@ namespace c8 {
         auto operator *=(const natural &v) -> natural &;
         auto operator /=(const natural &v) -> natural &;
         auto operator %=(const natural &v) -> natural &;
+        auto operator /=(const natural_divisor &v) -> natural &;
+        auto operator %=(const natural_divisor &v) -> natural &;
+        auto operator +=(unsigned long long v) -> natural &;
+        auto operator -=(unsigned long long v) -> natural &;
+        auto operator *=(unsigned long long v) -> natural &;
+        auto operator /=(unsigned long long v) -> natural &;
+        auto operator %=(unsigned long long v) -> natural &;
 
         auto size_bits() const noexcept -> std::size_t;
+        auto addmul(const natural &v, const natural &u) -> natural &;
+        auto submul(const natural &v, const natural &u) -> natural &;
+        auto square() const -> natural;
         auto divide_modulus(const natural &v) const -> std::pair<natural, natural>;
+        auto divide_modulus(const natural_divisor &v) const -> std::pair<natural, natural>;
         auto gcd(const natural &v) const -> natural;
+        auto inverse_mod(const natural &m) const -> natural;
+        auto pow_mod(const natural &e, const natural &m) const -> natural;
 
         /*
          * Is this number zero?
@@ -141,6 +272,8 @@ namespace c8 {
         auto to_unsigned_long_long() const -> unsigned long long;
 
         friend auto operator <<(std::ostream &outstr, const natural &v) -> std::ostream &;
+        friend auto to_chars(char *first, char *last, const natural &v, int base) -> to_chars_result;
+        friend auto from_chars(const char *first, const char *last, natural &v, int base) -> from_chars_result;
 
     private:
         std::size_t num_digits_;        // The number of digits in this number
@@ -148,27 +281,257 @@ namespace c8 {
         natural_digit *digits_;         // Digits of the natural number
         natural_digit small_digits_[64 / sizeof(natural_digit)];
                                         // Small fixed-size digit buffer
-        std::unique_ptr<natural_digit[]> large_digits_;
+        std::unique_ptr<natural_digit[], natural_digits_deleter> large_digits_;
                                         // Pointer to large digit buffer, if needed
 
         auto reserve(std::size_t new_digits) -> void;
         auto expand(std::size_t new_digits) -> void;
         auto copy_digits(const natural &v) -> void;
         auto steal_digits(natural &v) -> void;
+
+        struct hgcd_matrix;
+
+        static auto gcd_step(natural &a, natural &b, hgcd_matrix &t) -> void;
+        static auto hgcd_reduce(natural &a, natural &b, hgcd_matrix &t, std::size_t k) -> void;
+        static auto hgcd(natural &a, natural &b, hgcd_matrix &t) -> void;
+        static auto gcdext(const natural &a, const natural &b,
+                           natural &s, bool &s_negative, natural &t, bool &t_negative) -> natural;
+
+        auto to_decimal_basecase(char *res, std::size_t width) const -> void;
+        auto to_decimal(char *res, std::size_t width, const natural_divisor *powers, std::size_t num_powers) const -> void;
+        auto to_decimal(char *res, std::size_t width) const -> void;
+        auto to_power_of_2(char *res, std::size_t width, unsigned int bits, const char *digits) const -> void;
+        auto from_decimal_basecase(const char *v, std::size_t v_sz) -> void;
+        auto from_decimal(const char *v, std::size_t v_sz, const natural *powers, std::size_t num_powers) -> void;
+        auto from_decimal(const char *v, std::size_t v_sz) -> void;
+        auto from_power_of_2(const char *v, std::size_t v_sz, unsigned int bits) -> void;
+
+        auto assign_multiply(const natural &v, const natural &u) -> void;
+        auto multiply_subtract(const natural &v, const natural &u, bool allow_negative) -> bool;
+        auto multiply_modulus(const natural &v, const natural &u, const natural &m) -> void;
+
+        friend class integer;
+        friend class montgomery_context;
+        friend class barrett_context;
+        friend struct expr::access;
     };
 
     inline auto is_zero(const natural &v) -> bool {
         return v.is_zero();
     }
 
+    inline auto square(const natural &v) -> natural {
+        return v.square();
+    }
+
     inline auto gcd(const natural &v, const natural &u) -> natural {
         return v.gcd(u);
     }
 
+    inline auto inverse_mod(const natural &v, const natural &m) -> natural {
+        return v.inverse_mod(m);
+    }
+
+    inline auto pow_mod(const natural &v, const natural &e, const natural &m) -> natural {
+        return v.pow_mod(e, m);
+    }
+
     inline auto to_unsigned_long_long(const natural &v) -> unsigned long long {
         return v.to_unsigned_long_long();
     }
 
+    auto to_chars(char *first, char *last, const natural &v, int base = 10) -> to_chars_result;
+    auto from_chars(const char *first, const char *last, natural &v, int base = 10) -> from_chars_result;
+
+    /*
+     * Arithmetic operators for temporary naturals.  These reuse the temporary's digits for
+     * the result, so expressions such as a * b + c only need to allocate once.
+     */
+    inline auto operator +(natural &&v, const natural &u) -> natural {
+        v += u;
+        return std::move(v);
+    }
+
+    inline auto operator +(const natural &v, natural &&u) -> natural {
+        u += v;
+        return std::move(u);
+    }
+
+    inline auto operator +(natural &&v, natural &&u) -> natural {
+        v += u;
+        return std::move(v);
+    }
+
+    inline auto operator -(natural &&v, const natural &u) -> natural {
+        v -= u;
+        return std::move(v);
+    }
+
+    inline auto operator *(natural &&v, const natural &u) -> natural {
+        v *= u;
+        return std::move(v);
+    }
+
+    inline auto operator *(const natural &v, natural &&u) -> natural {
+        u *= v;
+        return std::move(u);
+    }
+
+    inline auto operator *(natural &&v, natural &&u) -> natural {
+        v *= u;
+        return std::move(v);
+    }
+
+    inline auto operator /(natural &&v, const natural &u) -> natural {
+        v /= u;
+        return std::move(v);
+    }
+
+    inline auto operator %(natural &&v, const natural &u) -> natural {
+        v %= u;
+        return std::move(v);
+    }
+
+    inline auto operator +(natural &&v, unsigned long long u) -> natural {
+        v += u;
+        return std::move(v);
+    }
+
+    inline auto operator -(natural &&v, unsigned long long u) -> natural {
+        v -= u;
+        return std::move(v);
+    }
+
+    inline auto operator *(natural &&v, unsigned long long u) -> natural {
+        v *= u;
+        return std::move(v);
+    }
+
+    inline auto operator /(natural &&v, unsigned long long u) -> natural {
+        v /= u;
+        return std::move(v);
+    }
+
+    inline auto operator %(natural &&v, unsigned long long u) -> natural {
+        v %= u;
+        return std::move(v);
+    }
+
+    inline auto operator <<(natural &&v, unsigned int count) -> natural {
+        v <<= count;
+        return std::move(v);
+    }
+
+    inline auto operator >>(natural &&v, unsigned int count) -> natural {
+        v >>= count;
+        return std::move(v);
+    }
+
+    /*
+     * A natural number divisor that has been prepared so that it can be used to divide many
+     * different dividends quickly.  The divisor is normalized once, when it is constructed,
+     * and large divisors also have their reciprocal computed at the same time.
+     */
+    class natural_divisor {
+    public:
+        natural_divisor(const natural &v);
+        natural_divisor(const natural_divisor &v) = default;
+        natural_divisor(natural_divisor &&v) noexcept = default;
+
+        ~natural_divisor() = default;
+
+        auto operator =(const natural_divisor &v) -> natural_divisor & = default;
+        auto operator =(natural_divisor &&v) noexcept -> natural_divisor & = default;
+
+        /*
+         * Return the value of this divisor.
+         */
+        auto divisor() const -> const natural & {
+            return divisor_;
+        }
+
+    private:
+        natural divisor_;               // The divisor
+        natural normalized_;            // The divisor, shifted so its top bit is set
+        natural reciprocal_;            // Reciprocal of the normalized divisor, if it is large
+        unsigned int normalize_shift_;  // Number of bits by which the divisor was shifted
+
+        friend class natural;
+    };
+
+    /*
+     * A Montgomery context, precomputed from an odd modulus.  Montgomery multiplication
+     * replaces the divide normally needed to reduce a product with a second multiply, so
+     * this is much faster when we need many modular multiplies with the same modulus, as
+     * we do in a modular exponentiation.
+     */
+    class montgomery_context {
+    public:
+        montgomery_context(const natural &m);
+        montgomery_context(const montgomery_context &v) = default;
+        montgomery_context(montgomery_context &&v) noexcept = default;
+
+        ~montgomery_context() = default;
+
+        auto operator =(const montgomery_context &v) -> montgomery_context & = default;
+        auto operator =(montgomery_context &&v) noexcept -> montgomery_context & = default;
+
+        /*
+         * Return the modulus of this context.
+         */
+        auto modulus() const -> const natural & {
+            return modulus_;
+        }
+
+        auto mul_mod(const natural &v, const natural &u) const -> natural;
+        auto sqr_mod(const natural &v) const -> natural;
+        auto pow_mod(const natural &v, const natural &e) const -> natural;
+
+    private:
+        natural modulus_;               // The modulus
+        natural r2_;                    // B^2n mod the modulus, where n is the modulus' size in digits
+        natural_digit inverse_;         // -1 / modulus mod B
+
+        auto load(natural_digit *res, const natural &v) const -> void;
+        auto store(const natural_digit *src) const -> natural;
+    };
+
+    /*
+     * A Barrett context, precomputed from a modulus.  Barrett reduction replaces the divide
+     * normally needed to reduce a product with two multiplies by a precomputed reciprocal of
+     * the modulus.  Unlike a Montgomery context, this works with even moduli too.
+     */
+    class barrett_context {
+    public:
+        barrett_context(const natural &m);
+        barrett_context(const barrett_context &v) = default;
+        barrett_context(barrett_context &&v) noexcept = default;
+
+        ~barrett_context() = default;
+
+        auto operator =(const barrett_context &v) -> barrett_context & = default;
+        auto operator =(barrett_context &&v) noexcept -> barrett_context & = default;
+
+        /*
+         * Return the modulus of this context.
+         */
+        auto modulus() const -> const natural & {
+            return modulus_;
+        }
+
+        auto reduce(const natural &v) const -> natural;
+        auto mul_mod(const natural &v, const natural &u) const -> natural;
+        auto sqr_mod(const natural &v) const -> natural;
+        auto pow_mod(const natural &v, const natural &e) const -> natural;
+
+    private:
+        natural modulus_;               // The modulus
+        natural mu_;                    // floor((B^2n - 1) / modulus), where n is the modulus' size in digits
+
+        auto load(natural_digit *res, const natural &v) const -> void;
+        auto store(const natural_digit *src) const -> natural;
+    };
+
     class integer {
     public:
         /*
@@ -178,7 +541,7 @@ namespace c8 {
             negative_ = false;
         }
 
-        integer(long long v) noexcept : magnitude_((v >= 0) ? static_cast<unsigned long long>(v) : static_cast<unsigned long long>(-v)) {
+        integer(long long v) noexcept : magnitude_((v >= 0) ? static_cast<unsigned long long>(v) : (0ULL - static_cast<unsigned long long>(v))) {
             negative_ = (v < 0) ? true : false;
         }
 
@@ -198,6 +561,12 @@ namespace c8 {
         auto operator >=(const integer &v) const noexcept -> bool;
         auto operator <(const integer &v) const noexcept -> bool;
         auto operator <=(const integer &v) const noexcept -> bool;
+        auto operator ==(long long v) const noexcept -> bool;
+        auto operator !=(long long v) const noexcept -> bool;
+        auto operator >(long long v) const noexcept -> bool;
+        auto operator >=(long long v) const noexcept -> bool;
+        auto operator <(long long v) const noexcept -> bool;
+        auto operator <=(long long v) const noexcept -> bool;
 
         auto operator +(const integer &v) const -> integer;
         auto operator -(const integer &v) const -> integer;
@@ -206,6 +575,11 @@ namespace c8 {
         auto operator %(const integer &v) const -> integer;
         auto operator >>(unsigned int count) const -> integer;
         auto operator <<(unsigned int count) const -> integer;
+        auto operator +(long long v) const -> integer;
+        auto operator -(long long v) const -> integer;
+        auto operator *(long long v) const -> integer;
+        auto operator /(long long v) const -> integer;
+        auto operator %(long long v) const -> integer;
 
         auto operator -() const -> integer {
             integer res = *this;
@@ -217,6 +591,11 @@ namespace c8 {
         auto operator =(integer &&v) -> integer & = default;
         auto operator +=(const integer &v) -> integer &;
         auto operator -=(const integer &v) -> integer &;
+        auto operator +=(long long v) -> integer &;
+        auto operator -=(long long v) -> integer &;
+        auto operator *=(long long v) -> integer &;
+        auto operator /=(long long v) -> integer &;
+        auto operator %=(long long v) -> integer &;
 
         /*
          * Multiply another integer with this one.
@@ -260,6 +639,18 @@ namespace c8 {
             return *this;
         }
 
+        /*
+         * Square this integer.
+         */
+        auto square() const -> integer {
+            integer res;
+            res.magnitude_ = magnitude_.square();
+
+            return res;
+        }
+
+        auto addmul(const integer &v, const integer &u) -> integer &;
+        auto submul(const integer &v, const integer &u) -> integer &;
         auto divide_modulus(const integer &v) const -> std::pair<integer, integer>;
 
         /*
@@ -298,13 +689,27 @@ namespace c8 {
             return res;
         }
 
+        auto gcdext(const integer &v) const -> std::tuple<integer, integer, integer>;
+        auto pow_mod(const integer &e, const integer &m) const -> integer;
+
         auto to_long_long() const -> long long;
 
         friend auto operator <<(std::ostream &outstr, const integer &v) -> std::ostream &;
+        friend auto to_chars(char *first, char *last, const integer &v, int base) -> to_chars_result;
+        friend auto from_chars(const char *first, const char *last, integer &v, int base) -> from_chars_result;
 
     private:
         bool negative_;                 // Is this big integer negative?
         natural magnitude_;             // The magnitude of the integer
+
+        auto compare(long long v) const noexcept -> int;
+        auto add(bool v_negative, unsigned long long v_magnitude) const -> integer;
+        auto add_assign(bool v_negative, unsigned long long v_magnitude) -> void;
+        auto assign_multiply(const integer &v, const integer &u) -> void;
+        auto multiply_modulus(const integer &v, const integer &u, const integer &m) -> void;
+
+        friend class rational;
+        friend struct expr::access;
     };
 
     inline auto is_zero(const integer &v) -> bool {
@@ -319,14 +724,119 @@ namespace c8 {
         return v.magnitude();
     }
 
+    inline auto square(const integer &v) -> integer {
+        return v.square();
+    }
+
     inline auto gcd(const integer &v, const integer &u) -> integer {
         return v.gcd(u);
     }
 
+    inline auto gcdext(const integer &v, const integer &u) -> std::tuple<integer, integer, integer> {
+        return v.gcdext(u);
+    }
+
+    inline auto pow_mod(const integer &v, const integer &e, const integer &m) -> integer {
+        return v.pow_mod(e, m);
+    }
+
     inline auto to_long_long(const integer &v) -> long long {
         return v.to_long_long();
     }
 
+    auto to_chars(char *first, char *last, const integer &v, int base = 10) -> to_chars_result;
+    auto from_chars(const char *first, const char *last, integer &v, int base = 10) -> from_chars_result;
+
+    /*
+     * Arithmetic operators for temporary integers.  These reuse the temporary's digits for
+     * the result, so expressions such as a * b + c only need to allocate once.
+     */
+    inline auto operator +(integer &&v, const integer &u) -> integer {
+        v += u;
+        return std::move(v);
+    }
+
+    inline auto operator +(const integer &v, integer &&u) -> integer {
+        u += v;
+        return std::move(u);
+    }
+
+    inline auto operator +(integer &&v, integer &&u) -> integer {
+        v += u;
+        return std::move(v);
+    }
+
+    inline auto operator -(integer &&v, const integer &u) -> integer {
+        v -= u;
+        return std::move(v);
+    }
+
+    inline auto operator *(integer &&v, const integer &u) -> integer {
+        v *= u;
+        return std::move(v);
+    }
+
+    inline auto operator *(const integer &v, integer &&u) -> integer {
+        u *= v;
+        return std::move(u);
+    }
+
+    inline auto operator *(integer &&v, integer &&u) -> integer {
+        v *= u;
+        return std::move(v);
+    }
+
+    inline auto operator /(integer &&v, const integer &u) -> integer {
+        v /= u;
+        return std::move(v);
+    }
+
+    inline auto operator %(integer &&v, const integer &u) -> integer {
+        v %= u;
+        return std::move(v);
+    }
+
+    inline auto operator +(integer &&v, long long u) -> integer {
+        v += u;
+        return std::move(v);
+    }
+
+    inline auto operator -(integer &&v, long long u) -> integer {
+        v -= u;
+        return std::move(v);
+    }
+
+    inline auto operator *(integer &&v, long long u) -> integer {
+        v *= u;
+        return std::move(v);
+    }
+
+    inline auto operator /(integer &&v, long long u) -> integer {
+        v /= u;
+        return std::move(v);
+    }
+
+    inline auto operator %(integer &&v, long long u) -> integer {
+        v %= u;
+        return std::move(v);
+    }
+
+    inline auto operator <<(integer &&v, unsigned int count) -> integer {
+        v <<= count;
+        return std::move(v);
+    }
+
+    inline auto operator >>(integer &&v, unsigned int count) -> integer {
+        v >>= count;
+        return std::move(v);
+    }
+
+    /*
+     * Used to select the rational operator overloads that take floating point operands.
+     */
+    template <typename T>
+    using enable_if_floating_point = typename std::enable_if<std::is_floating_point<T>::value, int>::type;
+
     class rational {
     public:
         /*
@@ -358,11 +868,21 @@ namespace c8 {
         auto operator >=(const rational &v) const -> bool;
         auto operator <(const rational &v) const -> bool;
         auto operator <=(const rational &v) const -> bool;
+        auto operator ==(long long v) const -> bool;
+        auto operator !=(long long v) const -> bool;
+        auto operator >(long long v) const -> bool;
+        auto operator >=(long long v) const -> bool;
+        auto operator <(long long v) const -> bool;
+        auto operator <=(long long v) const -> bool;
 
         auto operator +(const rational &v) const -> rational;
         auto operator -(const rational &v) const -> rational;
         auto operator *(const rational &v) const -> rational;
         auto operator /(const rational &v) const -> rational;
+        auto operator +(long long v) const -> rational;
+        auto operator -(long long v) const -> rational;
+        auto operator *(long long v) const -> rational;
+        auto operator /(long long v) const -> rational;
 
         auto operator -() const -> rational {
             rational res;
@@ -377,6 +897,85 @@ namespace c8 {
         auto operator -=(const rational &v) -> rational &;
         auto operator *=(const rational &v) -> rational &;
         auto operator /=(const rational &v) -> rational &;
+        auto operator +=(long long v) -> rational &;
+        auto operator -=(long long v) -> rational &;
+        auto operator *=(long long v) -> rational &;
+        auto operator /=(long long v) -> rational &;
+
+        /*
+         * Floating point operands are converted using rational(double), just as they would
+         * be for a rational operand.  Without these they would be truncated to match the
+         * long long overloads.
+         */
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator ==(T v) const -> bool {
+            return *this == rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator !=(T v) const -> bool {
+            return *this != rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator >(T v) const -> bool {
+            return *this > rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator >=(T v) const -> bool {
+            return *this >= rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator <(T v) const -> bool {
+            return *this < rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator <=(T v) const -> bool {
+            return *this <= rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator +(T v) const -> rational {
+            return *this + rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator -(T v) const -> rational {
+            return *this - rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator *(T v) const -> rational {
+            return *this * rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator /(T v) const -> rational {
+            return *this / rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator +=(T v) -> rational & {
+            return *this += rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator -=(T v) -> rational & {
+            return *this -= rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator *=(T v) -> rational & {
+            return *this *= rational(static_cast<double>(v));
+        }
+
+        template <typename T, enable_if_floating_point<T> = 0>
+        auto operator /=(T v) -> rational & {
+            return *this /= rational(static_cast<double>(v));
+        }
 
         /*
          * Is this number zero?
@@ -392,12 +991,18 @@ namespace c8 {
         }
 
         friend auto operator <<(std::ostream &outstr, const rational &v) -> std::ostream &;
+        friend auto to_chars(char *first, char *last, const rational &v, int base) -> to_chars_result;
+        friend auto from_chars(const char *first, const char *last, rational &v, int base) -> from_chars_result;
 
     private:
         integer numerator_;             // Numerator
         integer denominator_;           // Denominator
 
         auto normalize() -> void;
+        auto compare(const rational &v) const -> int;
+        auto compare(long long v) const -> int;
+        auto add_subtract(const rational &v, bool subtract) const -> rational;
+        static auto multiply(const integer &a, const integer &b, const integer &c, const integer &d) -> rational;
     };
 
     inline auto is_zero(const rational &v) -> bool {
@@ -411,6 +1016,55 @@ namespace c8 {
     inline auto to_parts(const rational &v) -> std::pair<integer, integer> {
         return v.to_parts();
     }
+
+    auto to_chars(char *first, char *last, const rational &v, int base = 10) -> to_chars_result;
+    auto from_chars(const char *first, const char *last, rational &v, int base = 10) -> from_chars_result;
+
+    /*
+     * Add and subtract operators for temporary rationals.  When both values are integers
+     * these reuse the temporary's numerator for the result.
+     */
+    inline auto operator +(rational &&v, const rational &u) -> rational {
+        v += u;
+        return std::move(v);
+    }
+
+    inline auto operator +(const rational &v, rational &&u) -> rational {
+        u += v;
+        return std::move(u);
+    }
+
+    inline auto operator +(rational &&v, rational &&u) -> rational {
+        v += u;
+        return std::move(v);
+    }
+
+    inline auto operator -(rational &&v, const rational &u) -> rational {
+        v -= u;
+        return std::move(v);
+    }
+
+    inline auto operator +(rational &&v, long long u) -> rational {
+        v += u;
+        return std::move(v);
+    }
+
+    inline auto operator -(rational &&v, long long u) -> rational {
+        v -= u;
+        return std::move(v);
+    }
+
+    template <typename T, enable_if_floating_point<T> = 0>
+    inline auto operator +(rational &&v, T u) -> rational {
+        v += rational(static_cast<double>(u));
+        return std::move(v);
+    }
+
+    template <typename T, enable_if_floating_point<T> = 0>
+    inline auto operator -(rational &&v, T u) -> rational {
+        v -= rational(static_cast<double>(u));
+        return std::move(v);
+    }
 }
 
 #endif // __C8_H
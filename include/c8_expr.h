@@ -0,0 +1,448 @@
+/*
+ * c8_expr.h
+ *
+ * Opt-in expression templates for natural and integer arithmetic.
+ *
+ * Wrapping an operand with c8::expr::lazy() makes the arithmetic operators build an
+ * expression, rather than computing a value.  The expression is then evaluated by
+ * c8::expr::assign(), or c8::expr::eval(), directly into its destination:
+ *
+ *     c8::expr::assign(x, c8::expr::lazy(x) * y % m);
+ *     c8::expr::assign(r, c8::expr::lazy(a) * b + c8::expr::lazy(c) * d);
+ *
+ * Products that are added to, subtracted from, or reduced by another value are never
+ * stored in a temporary natural or integer.  They are fused with the following operation,
+ * and if they need storage at all it comes from per-thread scratch space.
+ *
+ * Expressions hold references to their operands, so they must be evaluated before any
+ * of those operands are destroyed.  It's safest not to store them at all.
+ */
+#ifndef __C8_EXPR_H
+#define __C8_EXPR_H
+
+#include <type_traits>
+#include <utility>
+
+#include "c8.h"
+
+namespace c8 {
+    namespace expr {
+        /*
+         * Access to the fused arithmetic operations of natural and integer.
+         */
+        struct access {
+            template <typename T>
+            static auto size_digits(const T &v) noexcept -> std::size_t {
+                return magnitude_of(v).num_digits_;
+            }
+
+            template <typename T>
+            static auto multiply(T &res, const T &v, const T &u) -> void {
+                res.assign_multiply(v, u);
+            }
+
+            template <typename T>
+            static auto multiply_modulus(T &res, const T &v, const T &u, const T &m) -> void {
+                res.multiply_modulus(v, u, m);
+            }
+
+        private:
+            static auto magnitude_of(const natural &v) noexcept -> const natural & {
+                return v;
+            }
+
+            static auto magnitude_of(const integer &v) noexcept -> const natural & {
+                return v.magnitude_;
+            }
+        };
+
+        /*
+         * A reference to a natural or integer value within an expression.
+         */
+        template <typename T>
+        class ref {
+        public:
+            typedef T value_type;
+
+            explicit ref(const T &v) noexcept : v_(v) {
+            }
+
+            auto value() const noexcept -> const T & {
+                return v_;
+            }
+
+        private:
+            const T &v_;                    // The value we refer to
+        };
+
+        /*
+         * Base for the binary operation nodes of an expression.
+         */
+        template <typename L, typename R>
+        class binary {
+        public:
+            static_assert(std::is_same<typename L::value_type, typename R::value_type>::value,
+                          "expression operands must have the same type");
+
+            typedef typename L::value_type value_type;
+
+            binary(const L &l, const R &r) : left_(l), right_(r) {
+            }
+
+            auto left() const noexcept -> const L & {
+                return left_;
+            }
+
+            auto right() const noexcept -> const R & {
+                return right_;
+            }
+
+        private:
+            L left_;                        // Left-hand operand
+            R right_;                       // Right-hand operand
+        };
+
+        template <typename L, typename R>
+        class add : public binary<L, R> {
+        public:
+            using binary<L, R>::binary;
+        };
+
+        template <typename L, typename R>
+        class subtract : public binary<L, R> {
+        public:
+            using binary<L, R>::binary;
+        };
+
+        template <typename L, typename R>
+        class multiply : public binary<L, R> {
+        public:
+            using binary<L, R>::binary;
+        };
+
+        template <typename L, typename R>
+        class modulus : public binary<L, R> {
+        public:
+            using binary<L, R>::binary;
+        };
+
+        /*
+         * Traits that identify expression nodes, and the values that can be used with them.
+         */
+        template <typename E>
+        struct is_node : std::false_type {
+        };
+
+        template <typename T>
+        struct is_node<ref<T>> : std::true_type {
+        };
+
+        template <typename L, typename R>
+        struct is_node<add<L, R>> : std::true_type {
+        };
+
+        template <typename L, typename R>
+        struct is_node<subtract<L, R>> : std::true_type {
+        };
+
+        template <typename L, typename R>
+        struct is_node<multiply<L, R>> : std::true_type {
+        };
+
+        template <typename L, typename R>
+        struct is_node<modulus<L, R>> : std::true_type {
+        };
+
+        template <typename V>
+        struct is_value : std::integral_constant<bool, std::is_same<V, natural>::value
+                                                       || std::is_same<V, integer>::value> {
+        };
+
+        template <typename V>
+        using node_type = typename std::conditional<is_node<V>::value, V, ref<V>>::type;
+
+        template <typename L, typename R>
+        using enable_if_expr = typename std::enable_if<(is_node<L>::value || is_node<R>::value)
+                                                       && (is_node<L>::value || is_value<L>::value)
+                                                       && (is_node<R>::value || is_value<R>::value)>::type;
+
+        /*
+         * Start an expression from a natural or integer value.
+         */
+        template <typename T, typename = typename std::enable_if<is_value<T>::value>::type>
+        inline auto lazy(const T &v) noexcept -> ref<T> {
+            return ref<T>(v);
+        }
+
+        template <typename V>
+        inline auto as_node(const V &v, std::true_type) -> const V & {
+            return v;
+        }
+
+        template <typename V>
+        inline auto as_node(const V &v, std::false_type) -> ref<V> {
+            return ref<V>(v);
+        }
+
+        template <typename L, typename R, typename = enable_if_expr<L, R>>
+        inline auto operator +(const L &l, const R &r) -> add<node_type<L>, node_type<R>> {
+            return add<node_type<L>, node_type<R>>(as_node(l, is_node<L>()), as_node(r, is_node<R>()));
+        }
+
+        template <typename L, typename R, typename = enable_if_expr<L, R>>
+        inline auto operator -(const L &l, const R &r) -> subtract<node_type<L>, node_type<R>> {
+            return subtract<node_type<L>, node_type<R>>(as_node(l, is_node<L>()), as_node(r, is_node<R>()));
+        }
+
+        template <typename L, typename R, typename = enable_if_expr<L, R>>
+        inline auto operator *(const L &l, const R &r) -> multiply<node_type<L>, node_type<R>> {
+            return multiply<node_type<L>, node_type<R>>(as_node(l, is_node<L>()), as_node(r, is_node<R>()));
+        }
+
+        template <typename L, typename R, typename = enable_if_expr<L, R>>
+        inline auto operator %(const L &l, const R &r) -> modulus<node_type<L>, node_type<R>> {
+            return modulus<node_type<L>, node_type<R>>(as_node(l, is_node<L>()), as_node(r, is_node<R>()));
+        }
+
+        template <typename T>
+        inline auto evaluate(T &res, const ref<T> &e) -> void;
+
+        /*
+         * An evaluated operand.  Values are used in place, unless they are the value
+         * we've been asked to avoid (because it's about to be overwritten), while
+         * sub-expressions are evaluated into a temporary.
+         */
+        template <typename T>
+        class operand {
+        public:
+            operand(const ref<T> &e, const T *avoid) : p_(&e.value()) {
+                if (C8_UNLIKELY(p_ == avoid)) {
+                    tmp_ = *p_;
+                    p_ = &tmp_;
+                }
+            }
+
+            template <typename E>
+            operand(const E &e, const T *) : p_(&tmp_) {
+                evaluate(tmp_, e);
+            }
+
+            operand(const operand &) = delete;
+            auto operator =(const operand &) -> operand & = delete;
+
+            auto get() const noexcept -> const T & {
+                return *p_;
+            }
+
+        private:
+            T tmp_;                         // Storage for an evaluated sub-expression
+            const T *p_;                    // The operand's value
+        };
+
+        /*
+         * Evaluate expressions into a result.  Wherever we evaluate one operand into the
+         * result and then apply the other, we evaluate the other operand first, as it
+         * may refer to the result.
+         */
+        template <typename T>
+        inline auto evaluate(T &res, const ref<T> &e) -> void {
+            if (&res != &e.value()) {
+                res = e.value();
+            }
+        }
+
+        template <typename T, typename L, typename R>
+        inline auto evaluate(T &res, const multiply<L, R> &e) -> void {
+            operand<T> r(e.right(), &res);
+            evaluate(res, e.left());
+            access::multiply(res, res, r.get());
+        }
+
+        template <typename T, typename R>
+        inline auto evaluate(T &res, const multiply<ref<T>, R> &e) -> void {
+            operand<T> r(e.right(), nullptr);
+            access::multiply(res, e.left().value(), r.get());
+        }
+
+        template <typename T, typename L>
+        inline auto evaluate(T &res, const multiply<L, ref<T>> &e) -> void {
+            operand<T> l(e.left(), nullptr);
+            access::multiply(res, l.get(), e.right().value());
+        }
+
+        template <typename T>
+        inline auto evaluate(T &res, const multiply<ref<T>, ref<T>> &e) -> void {
+            access::multiply(res, e.left().value(), e.right().value());
+        }
+
+        template <typename T, typename L, typename R>
+        inline auto evaluate(T &res, const add<L, R> &e) -> void {
+            operand<T> r(e.right(), &res);
+            evaluate(res, e.left());
+            res += r.get();
+        }
+
+        /*
+         * The sum of a product and another operand.  If the other operand is a value then
+         * we normally form the product directly in the result and add the value to it, but
+         * if the value is the result itself then we accumulate the product instead.
+         */
+        template <typename T, typename A, typename B, typename O>
+        inline auto evaluate_multiply_add(T &res, const multiply<A, B> &p, const O &o) -> void {
+            operand<T> a(p.left(), &res);
+            operand<T> b(p.right(), &res);
+            evaluate(res, o);
+            res.addmul(a.get(), b.get());
+        }
+
+        template <typename T, typename A, typename B>
+        inline auto evaluate_multiply_add(T &res, const multiply<A, B> &p, const ref<T> &o) -> void {
+            if (&o.value() == &res) {
+                operand<T> a(p.left(), &res);
+                operand<T> b(p.right(), &res);
+                res.addmul(a.get(), b.get());
+                return;
+            }
+
+            operand<T> a(p.left(), nullptr);
+            operand<T> b(p.right(), nullptr);
+            access::multiply(res, a.get(), b.get());
+            res += o.value();
+        }
+
+        template <typename T, typename L, typename A, typename B>
+        inline auto evaluate(T &res, const add<L, multiply<A, B>> &e) -> void {
+            evaluate_multiply_add(res, e.right(), e.left());
+        }
+
+        template <typename T, typename A, typename B, typename R>
+        inline auto evaluate(T &res, const add<multiply<A, B>, R> &e) -> void {
+            evaluate_multiply_add(res, e.left(), e.right());
+        }
+
+        /*
+         * The sum of two products.  We form the larger product first, directly in the
+         * result, so that the smaller one can then be accumulated without needing to
+         * grow the result.  Whichever product refers to the result must be formed first,
+         * however, and if both do then we have to use a temporary.
+         */
+        template <typename T, typename A, typename B, typename C, typename D>
+        inline auto evaluate(T &res, const add<multiply<A, B>, multiply<C, D>> &e) -> void {
+            operand<T> a(e.left().left(), nullptr);
+            operand<T> b(e.left().right(), nullptr);
+            operand<T> c(e.right().left(), nullptr);
+            operand<T> d(e.right().right(), nullptr);
+
+            bool ab_alias = (&a.get() == &res) || (&b.get() == &res);
+            bool cd_alias = (&c.get() == &res) || (&d.get() == &res);
+            if (C8_UNLIKELY(ab_alias && cd_alias)) {
+                T tmp;
+                access::multiply(tmp, a.get(), b.get());
+                tmp.addmul(c.get(), d.get());
+                res = std::move(tmp);
+                return;
+            }
+
+            std::size_t ab_num_digits = access::size_digits(a.get()) + access::size_digits(b.get());
+            std::size_t cd_num_digits = access::size_digits(c.get()) + access::size_digits(d.get());
+            if (ab_alias || (!cd_alias && (ab_num_digits >= cd_num_digits))) {
+                access::multiply(res, a.get(), b.get());
+                res.addmul(c.get(), d.get());
+                return;
+            }
+
+            access::multiply(res, c.get(), d.get());
+            res.addmul(a.get(), b.get());
+        }
+
+        /*
+         * Differences.  A natural difference that would be negative throws not_a_number,
+         * and that must leave the result unchanged.  Subtracting in place already does
+         * this, but if the result isn't the value we subtract from then we evaluate that
+         * value into a temporary, and only move the difference into the result once we
+         * know it's valid.  Integer differences can't fail, so they're always formed in
+         * the result.
+         */
+        template <typename T>
+        using checked_difference = std::is_same<T, natural>;
+
+        template <typename T, typename L, typename F>
+        inline auto evaluate_subtract(T &res, const L &l, const F &sub, std::false_type) -> void {
+            evaluate(res, l);
+            sub(res);
+        }
+
+        template <typename T, typename L, typename F>
+        inline auto evaluate_subtract(T &res, const L &l, const F &sub, std::true_type) -> void {
+            T tmp;
+            evaluate(tmp, l);
+            sub(tmp);
+            res = std::move(tmp);
+        }
+
+        template <typename T, typename F>
+        inline auto evaluate_subtract(T &res, const ref<T> &l, const F &sub, std::true_type) -> void {
+            if (&l.value() == &res) {
+                sub(res);
+                return;
+            }
+
+            T tmp(l.value());
+            sub(tmp);
+            res = std::move(tmp);
+        }
+
+        template <typename T, typename L, typename R>
+        inline auto evaluate(T &res, const subtract<L, R> &e) -> void {
+            operand<T> r(e.right(), &res);
+            evaluate_subtract(res, e.left(), [&r](T &v) { v -= r.get(); }, checked_difference<T>());
+        }
+
+        template <typename T, typename L, typename A, typename B>
+        inline auto evaluate(T &res, const subtract<L, multiply<A, B>> &e) -> void {
+            operand<T> a(e.right().left(), &res);
+            operand<T> b(e.right().right(), &res);
+            evaluate_subtract(res, e.left(), [&a, &b](T &v) { v.submul(a.get(), b.get()); }, checked_difference<T>());
+        }
+
+        template <typename T, typename L, typename R>
+        inline auto evaluate(T &res, const modulus<L, R> &e) -> void {
+            operand<T> r(e.right(), &res);
+            evaluate(res, e.left());
+            res %= r.get();
+        }
+
+        template <typename T, typename A, typename B, typename R>
+        inline auto evaluate(T &res, const modulus<multiply<A, B>, R> &e) -> void {
+            operand<T> a(e.left().left(), nullptr);
+            operand<T> b(e.left().right(), nullptr);
+            operand<T> m(e.right(), nullptr);
+            access::multiply_modulus(res, a.get(), b.get(), m.get());
+        }
+
+        /*
+         * Evaluate an expression into an existing natural or integer.  The destination
+         * may also appear within the expression.
+         */
+        template <typename T, typename E>
+        inline auto assign(T &res, const E &e) -> T & {
+            static_assert(std::is_same<T, typename E::value_type>::value,
+                          "expression must have the same type as its destination");
+
+            evaluate(res, e);
+            return res;
+        }
+
+        /*
+         * Evaluate an expression into a new natural or integer.
+         */
+        template <typename E>
+        inline auto eval(const E &e) -> typename E::value_type {
+            typename E::value_type res;
+            evaluate(res, e);
+            return res;
+        }
+    }
+}
+
+#endif // __C8_EXPR_H
@@ -4,11 +4,156 @@
 #ifndef __C8___DIGIT_ARRAY_H
 #define __C8___DIGIT_ARRAY_H
 
+#include <type_traits>
+#include <utility>
+
 #include "c8.h"
 
 #define C8_USE_ASM 1
 
 namespace c8 {
+    /*
+     * Operand size, in digits, at which multiplication switches from Comba to Karatsuba.
+     */
+    const std::size_t __digit_array_karatsuba_threshold = 32;
+
+    /*
+     * Operand size, in digits, at which multiplication switches from Karatsuba to Toom-Cook 3-way.
+     */
+    const std::size_t __digit_array_toom3_threshold = 120;
+
+    /*
+     * Operand size, in digits, at which multiplication switches from Toom-Cook 3-way to 4-way.
+     */
+    const std::size_t __digit_array_toom4_threshold = 400;
+
+    /*
+     * Operand size, in digits, at which multiplication switches from Toom-Cook 4-way to
+     * a number-theoretic transform.
+     */
+    const std::size_t __digit_array_ntt_threshold = 1500;
+
+    /*
+     * Operand sizes, in digits, at which squaring switches between algorithms.  Squaring
+     * with Comba needs only about half the digit multiplies of a general multiply, so it
+     * remains competitive for longer.
+     */
+    const std::size_t __digit_array_square_karatsuba_threshold = 48;
+    const std::size_t __digit_array_square_toom3_threshold = 150;
+    const std::size_t __digit_array_square_toom4_threshold = 1500;
+    const std::size_t __digit_array_square_ntt_threshold = 2000;
+
+    /*
+     * Divisor size, in digits, at which division switches from long division to
+     * Burnikel-Ziegler recursive division.  The recursion itself bottoms out in long
+     * division once blocks are smaller than this.
+     */
+    const std::size_t __digit_array_bz_threshold = 40;
+
+    /*
+     * Divisor size, in digits, at which a precomputed divisor switches from Burnikel-Ziegler
+     * division to Barrett-style division using the divisor's reciprocal.  Below this the two
+     * multiplies needed for each block of the quotient cost more than a recursive divide.
+     */
+    const std::size_t __digit_array_reciprocal_threshold = 1000;
+
+    /*
+     * Operand size, in digits, at which GCDs switch from Lehmer's algorithm to the recursive
+     * half-GCD.
+     */
+    const std::size_t __digit_array_gcd_hgcd_threshold = 500;
+
+    /*
+     * Operand size, in digits, below which the half-GCD recursion bottoms out in Lehmer steps.
+     */
+    const std::size_t __digit_array_hgcd_threshold = 100;
+
+    /*
+     * Size, in digits, below which decimal conversions stop splitting a number by powers of 10
+     * and just divide it by the largest power of 10 that fits in a single digit.
+     */
+    const std::size_t __digit_array_decimal_threshold = 30;
+
+    /*
+     * Size, in digits, of each thread's scratch arena.  Scratch requests that don't fit in
+     * what remains of the arena are allocated from the heap instead.
+     */
+    const std::size_t __digit_array_scratch_arena_digits = 32768;
+
+    /*
+     * A thread's scratch arena.  Scratch space is always released in the reverse order to
+     * that in which it was acquired, so all we need is a bump pointer.
+     */
+    struct __digit_array_scratch_arena {
+        std::unique_ptr<natural_digit[]> digits_;
+                                        // The arena's digits, allocated on first use
+        std::size_t used_ = 0;          // Number of digits currently in use
+    };
+
+    /*
+     * Return the current thread's scratch arena.
+     */
+    inline auto __digit_array_get_scratch_arena() -> __digit_array_scratch_arena & {
+        static thread_local __digit_array_scratch_arena arena;
+        return arena;
+    }
+
+    /*
+     * Temporary digit storage for the digit array kernels.
+     *
+     * Small requests are carved from a per-thread arena, which avoids both large stack frames
+     * and repeated trips to the heap.  Anything too large for the arena comes from the heap.
+     * Scratch objects must be destroyed in the reverse order to their construction, which is
+     * always the case when they are local variables.
+     */
+    class __digit_array_scratch {
+    public:
+        explicit __digit_array_scratch(std::size_t num_digits) {
+            auto &arena = __digit_array_get_scratch_arena();
+            if (C8_LIKELY(num_digits <= (__digit_array_scratch_arena_digits - arena.used_))) {
+                if (C8_UNLIKELY(!arena.digits_ && num_digits)) {
+                    arena.digits_ = std::unique_ptr<natural_digit[]>(new natural_digit[__digit_array_scratch_arena_digits]);
+                }
+
+                arena_ = &arena;
+                num_digits_ = num_digits;
+                digits_ = arena.digits_.get() + arena.used_;
+                arena.used_ += num_digits;
+                return;
+            }
+
+            arena_ = nullptr;
+            num_digits_ = num_digits;
+            heap_digits_ = std::unique_ptr<natural_digit[]>(new natural_digit[num_digits]);
+            digits_ = heap_digits_.get();
+        }
+
+        __digit_array_scratch(const __digit_array_scratch &v) = delete;
+
+        ~__digit_array_scratch() {
+            if (arena_) {
+                arena_->used_ -= num_digits_;
+            }
+        }
+
+        auto operator =(const __digit_array_scratch &v) -> __digit_array_scratch & = delete;
+
+        /*
+         * Return a pointer to the scratch digits.
+         */
+        auto get() const noexcept -> natural_digit * {
+            return digits_;
+        }
+
+    private:
+        __digit_array_scratch_arena *arena_;
+                                        // Arena we came from, or nullptr if on the heap
+        std::size_t num_digits_;        // Number of digits we hold
+        natural_digit *digits_;         // The scratch digits
+        std::unique_ptr<natural_digit[]> heap_digits_;
+                                        // Heap allocation, if we didn't fit in the arena
+    };
+
     /*
      * Return the number of bits actually used within this digit array.
      */
@@ -509,6 +654,273 @@ namespace c8 {
         res_num_digits = r_num_digits + 1;
     }
 
+    /*
+     * Add a digit array into another, in place.
+     *
+     * Returns the carry out of the most significant digit of res.  Unlike the more
+     * generic add operations, the number of digits in res is fixed, and leading zero
+     * digits are allowed in both arrays.  src_num_digits must be less than, or equal
+     * to, res_num_digits.
+     */
+    inline auto __digit_array_add_in_place(natural_digit *res, std::size_t res_num_digits,
+                                           const natural_digit *src, std::size_t src_num_digits) -> natural_digit {
+        natural_digit acc_c = 0;
+
+        std::size_t i = 0;
+        while (i < src_num_digits) {
+            auto acc = static_cast<natural_double_digit>(res[i]) + static_cast<natural_double_digit>(src[i]);
+            acc += static_cast<natural_double_digit>(acc_c);
+            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
+            res[i++] = static_cast<natural_digit>(acc);
+        }
+
+        /*
+         * Propagate any carry.  We can stop as soon as it's been absorbed.
+         */
+        while (acc_c && (i < res_num_digits)) {
+            auto acc = static_cast<natural_double_digit>(res[i]) + static_cast<natural_double_digit>(acc_c);
+            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
+            res[i++] = static_cast<natural_digit>(acc);
+        }
+
+        return acc_c;
+    }
+
+    /*
+     * Subtract a digit array from another, in place.
+     *
+     * Returns the borrow out of the most significant digit of res.  Unlike the more
+     * generic subtract operations, the number of digits in res is fixed, and leading zero
+     * digits are allowed in both arrays.  src_num_digits must be less than, or equal
+     * to, res_num_digits.
+     */
+    inline auto __digit_array_subtract_in_place(natural_digit *res, std::size_t res_num_digits,
+                                                const natural_digit *src, std::size_t src_num_digits) -> natural_digit {
+        natural_digit acc_c = 0;
+
+        std::size_t i = 0;
+        while (i < src_num_digits) {
+            auto acc = static_cast<natural_double_digit>(res[i]) - static_cast<natural_double_digit>(src[i]);
+            acc -= static_cast<natural_double_digit>(acc_c);
+            acc_c = static_cast<natural_digit>((acc >> natural_digit_bits) & 1);
+            res[i++] = static_cast<natural_digit>(acc);
+        }
+
+        /*
+         * Propagate any borrow.  We can stop as soon as it's been absorbed.
+         */
+        while (acc_c && (i < res_num_digits)) {
+            auto acc = static_cast<natural_double_digit>(res[i]) - static_cast<natural_double_digit>(acc_c);
+            acc_c = static_cast<natural_digit>((acc >> natural_digit_bits) & 1);
+            res[i++] = static_cast<natural_digit>(acc);
+        }
+
+        return acc_c;
+    }
+
+    /*
+     * Compute the absolute difference between two digit arrays.
+     *
+     * Returns true if src2 was larger than src1 (i.e. the difference is really negative).  The
+     * result always has exactly src1_num_digits digits, and src2_num_digits must be less than,
+     * or equal to, src1_num_digits.  Leading zero digits are allowed in both arrays.
+     *
+     * Note: res must not overlap either src1 or src2.
+     */
+    inline auto __digit_array_abs_difference(natural_digit *res,
+                                             const natural_digit *src1, std::size_t src1_num_digits,
+                                             const natural_digit *src2, std::size_t src2_num_digits) -> bool {
+        /*
+         * Work out which is the larger value.  If src1 has any non-zero digits above the
+         * top of src2 then it's definitely the larger one.
+         */
+        bool negative = false;
+        bool src1_larger = false;
+        for (std::size_t i = src2_num_digits; i < src1_num_digits; i++) {
+            if (src1[i]) {
+                src1_larger = true;
+                break;
+            }
+        }
+
+        if (!src1_larger) {
+            std::size_t i = src2_num_digits;
+            while (i--) {
+                if (src1[i] != src2[i]) {
+                    negative = (src1[i] < src2[i]);
+                    break;
+                }
+            }
+        }
+
+        if (!negative) {
+            __digit_array_copy(res, src1, src1_num_digits);
+            __digit_array_subtract_in_place(res, src1_num_digits, src2, src2_num_digits);
+            return false;
+        }
+
+        /*
+         * src2 is the larger, so by definition src1's upper digits are all zero.
+         */
+        __digit_array_copy(res, src2, src2_num_digits);
+        __digit_array_zero(&res[src2_num_digits], src1_num_digits - src2_num_digits);
+        __digit_array_subtract_in_place(res, src2_num_digits, src1, src2_num_digits);
+        return true;
+    }
+
+    /*
+     * Add a signed digit array into another signed digit array, in place.
+     *
+     * Both arrays are represented as a magnitude and a sign (true if negative).  The number
+     * of digits in res is fixed, and must be large enough to hold the result.  src_num_digits
+     * must be less than, or equal to, res_num_digits.  To subtract, simply invert src_neg.
+     */
+    inline auto __digit_array_signed_add_in_place(natural_digit *res, bool &res_neg, std::size_t res_num_digits,
+                                                  const natural_digit *src, bool src_neg, std::size_t src_num_digits) -> void {
+        /*
+         * If our signs are the same then this is just an addition of the magnitudes.
+         */
+        if (res_neg == src_neg) {
+            __digit_array_add_in_place(res, res_num_digits, src, src_num_digits);
+            return;
+        }
+
+        /*
+         * Our signs differ so we subtract the smaller magnitude from the larger one.  If
+         * res has any non-zero digits above the top of src then it's definitely the larger.
+         */
+        bool res_larger = false;
+        for (std::size_t i = src_num_digits; i < res_num_digits; i++) {
+            if (res[i]) {
+                res_larger = true;
+                break;
+            }
+        }
+
+        if (!res_larger) {
+            res_larger = true;
+            std::size_t i = src_num_digits;
+            while (i--) {
+                if (res[i] != src[i]) {
+                    res_larger = (res[i] > src[i]);
+                    break;
+                }
+            }
+        }
+
+        if (res_larger) {
+            __digit_array_subtract_in_place(res, res_num_digits, src, src_num_digits);
+            return;
+        }
+
+        /*
+         * src is the larger, so res's upper digits must all be zero, and we want
+         * res = src - res.
+         */
+        natural_digit acc_c = 0;
+        for (std::size_t j = 0; j < src_num_digits; j++) {
+            auto acc = static_cast<natural_double_digit>(src[j]) - static_cast<natural_double_digit>(res[j]);
+            acc -= static_cast<natural_double_digit>(acc_c);
+            acc_c = static_cast<natural_digit>((acc >> natural_digit_bits) & 1);
+            res[j] = static_cast<natural_digit>(acc);
+        }
+
+        res_neg = src_neg;
+    }
+
+    /*
+     * Add a digit array into another, in place, starting offset digits into res.
+     *
+     * Any part of src, or any carry, that would extend beyond the end of res is discarded,
+     * so this can only be used when we know that the final result fits within res.
+     */
+    inline auto __digit_array_add_at(natural_digit *res, std::size_t res_num_digits, std::size_t offset,
+                                     const natural_digit *src, std::size_t src_num_digits) -> void {
+        std::size_t n = res_num_digits - offset;
+        if (src_num_digits > n) {
+            src_num_digits = n;
+        }
+
+        __digit_array_add_in_place(&res[offset], n, src, src_num_digits);
+    }
+
+    /*
+     * Left shift a digit array by less than a digit's worth of bits, keeping the same number
+     * of digits.
+     *
+     * Returns the bits shifted out of the most significant digit.  shift_bits must be greater
+     * than zero and less than natural_digit_bits.
+     *
+     * Note: It is OK for res and src to be the same pointer.
+     */
+    inline auto __digit_array_left_shift_fixed(natural_digit *res, const natural_digit *src, std::size_t src_num_digits,
+                                               std::size_t shift_bits) -> natural_digit {
+        auto c = static_cast<natural_digit>(src[src_num_digits - 1] >> (natural_digit_bits - shift_bits));
+        for (std::size_t i = src_num_digits - 1; i > 0; i--) {
+            res[i] = static_cast<natural_digit>((src[i] << shift_bits) | (src[i - 1] >> (natural_digit_bits - shift_bits)));
+        }
+
+        res[0] = static_cast<natural_digit>(src[0] << shift_bits);
+        return c;
+    }
+
+    /*
+     * Right shift a digit array by less than a digit's worth of bits, keeping the same number
+     * of digits.
+     *
+     * shift_bits must be greater than zero and less than natural_digit_bits.
+     *
+     * Note: It is OK for res and src to be the same pointer.
+     */
+    inline auto __digit_array_right_shift_fixed(natural_digit *res, const natural_digit *src, std::size_t src_num_digits,
+                                                std::size_t shift_bits) -> void {
+        for (std::size_t i = 0; i < (src_num_digits - 1); i++) {
+            res[i] = static_cast<natural_digit>((src[i] >> shift_bits) | (src[i + 1] << (natural_digit_bits - shift_bits)));
+        }
+
+        res[src_num_digits - 1] = static_cast<natural_digit>(src[src_num_digits - 1] >> shift_bits);
+    }
+
+    /*
+     * Compute the inverse of an odd digit, modulo the digit base.
+     *
+     * We use Newton's method.  For any odd v, v is its own inverse to 3 bits of precision,
+     * and each iteration doubles the number of correct bits.
+     */
+    inline auto __digit_array_inverse_1(natural_digit v) -> natural_digit {
+        natural_digit inv = v;
+        for (unsigned int i = 0; i < 6; i++) {
+            inv = static_cast<natural_digit>(inv * static_cast<natural_digit>(2 - static_cast<natural_digit>(v * inv)));
+        }
+
+        return inv;
+    }
+
+    /*
+     * Divide a digit array by a small odd digit, where we know in advance that there will
+     * be no remainder.
+     *
+     * Rather than dividing we multiply by the inverse of the divisor, modulo the digit base,
+     * working upwards from the least significant digit.  This avoids any divide instructions.
+     *
+     * Note: It is OK for res and src to be the same pointer.
+     */
+    inline auto __digit_array_divide_exact_1(natural_digit *res, const natural_digit *src, std::size_t src_num_digits,
+                                             natural_digit v) -> void {
+        auto inv = __digit_array_inverse_1(v);
+
+        natural_digit borrow = 0;
+        for (std::size_t i = 0; i < src_num_digits; i++) {
+            auto s = src[i];
+            natural_digit b = (s < borrow) ? 1 : 0;
+            s = static_cast<natural_digit>(s - borrow);
+            auto q = static_cast<natural_digit>(s * inv);
+            res[i] = q;
+            auto acc = static_cast<natural_double_digit>(q) * static_cast<natural_double_digit>(v);
+            borrow = static_cast<natural_digit>(static_cast<natural_digit>(acc >> natural_digit_bits) + b);
+        }
+    }
+
     /*
      * Left shift a digit.
      */
@@ -691,22 +1103,71 @@ namespace c8 {
     }
 
     /*
-     * Multiply two digit arrays.
+     * Multiply a digit array by a single digit and add the product to another digit array
+     * of the same size, returning the carry out of the most significant digit.
+     *
+     * Note: res must not overlap src1.
      */
-    inline auto __digit_array_multiply_m_n(natural_digit *res, std::size_t &res_num_digits,
-                                           const natural_digit *src1, std::size_t src1_num_digits,
-                                           const natural_digit *src2, std::size_t src2_num_digits) -> void {
+    inline auto __digit_array_addmul_1(natural_digit *res,
+                                       const natural_digit *src1, std::size_t src1_num_digits,
+                                       natural_digit src2) -> natural_digit {
         /*
-         * If we're going to update in place then we actually have to copy the source array
-         * because we'll overwrite it.
+         * The product of two digits, plus two more digits, always fits in a double digit.
          */
-        auto src1_1 = src1;
-        natural_digit src1_copy[src1_num_digits];
-        if (res == src1) {
-            __digit_array_copy(src1_copy, src1, src1_num_digits);
-            src1_1 = src1_copy;
+        natural_digit acc_c = 0;
+        for (std::size_t i = 0; i < src1_num_digits; i++) {
+            auto acc = static_cast<natural_double_digit>(src1[i]) * static_cast<natural_double_digit>(src2);
+            acc += static_cast<natural_double_digit>(res[i]);
+            acc += static_cast<natural_double_digit>(acc_c);
+            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
+            res[i] = static_cast<natural_digit>(acc);
+        }
+
+        return acc_c;
+    }
+
+    /*
+     * Multiply a digit array by a single digit and subtract the product from another digit
+     * array of the same size, returning the borrow out of the most significant digit.
+     *
+     * Note: res must not overlap src1.
+     */
+    inline auto __digit_array_submul_1(natural_digit *res,
+                                       const natural_digit *src1, std::size_t src1_num_digits,
+                                       natural_digit src2) -> natural_digit {
+        /*
+         * Our borrow combines the upper digit of each product with the borrow from the
+         * subtraction.  The upper digit can only be the largest possible digit value if
+         * the lower one is zero, so the sum never overflows.
+         */
+        natural_digit acc_c = 0;
+        for (std::size_t i = 0; i < src1_num_digits; i++) {
+            auto macc = static_cast<natural_double_digit>(src1[i]) * static_cast<natural_double_digit>(src2);
+            macc += static_cast<natural_double_digit>(acc_c);
+            auto macc_d = static_cast<natural_digit>(macc);
+            acc_c = static_cast<natural_digit>(macc >> natural_digit_bits);
+
+            auto r = res[i];
+            res[i] = static_cast<natural_digit>(r - macc_d);
+            if (r < macc_d) {
+                acc_c++;
+            }
         }
 
+        return acc_c;
+    }
+
+    /*
+     * Comba multiply two digit arrays.
+     *
+     * The result always has exactly src1_num_digits + src2_num_digits digits, so the most
+     * significant one may be zero.  Leading zero digits are allowed in both source arrays.
+     *
+     * Note: res must not overlap either src1 or src2.
+     */
+    inline auto __digit_array_multiply_comba(natural_digit *res,
+                                             const natural_digit *src1, std::size_t src1_num_digits,
+                                             const natural_digit *src2, std::size_t src2_num_digits) -> void {
         /*
          * Comba multiply.
          *
@@ -729,7 +1190,7 @@ namespace c8 {
             auto acc0 = static_cast<natural_double_digit>(static_cast<natural_digit>(acc1));
             acc1 = static_cast<natural_double_digit>(acc1 >> natural_digit_bits);
             for (std::size_t j = 0; j < num_multiplies; j++) {
-                auto a = static_cast<natural_double_digit>(src1_1[ti++]);
+                auto a = static_cast<natural_double_digit>(src1[ti++]);
                 auto b = static_cast<natural_double_digit>(src2[tj--]);
                 auto d0 = acc0 + (a * b);
                 acc0 = static_cast<natural_double_digit>(static_cast<natural_digit>(d0));
@@ -739,441 +1200,2743 @@ namespace c8 {
             res[res_column] = static_cast<natural_digit>(acc0);
         }
 
+        res[r_num_digits] = static_cast<natural_digit>(acc1);
+    }
+
+    /*
+     * Multiply two digit arrays.
+     */
+    inline auto __digit_array_multiply_m_n(natural_digit *res, std::size_t &res_num_digits,
+                                           const natural_digit *src1, std::size_t src1_num_digits,
+                                           const natural_digit *src2, std::size_t src2_num_digits) -> void {
+        /*
+         * If we're going to update in place then we actually have to copy the source array
+         * because we'll overwrite it.
+         */
+        auto src1_1 = src1;
+        __digit_array_scratch src1_copy((res == src1) ? src1_num_digits : 0);
+        if (res == src1) {
+            __digit_array_copy(src1_copy.get(), src1, src1_num_digits);
+            src1_1 = src1_copy.get();
+        }
+
+        __digit_array_multiply_comba(res, src1_1, src1_num_digits, src2, src2_num_digits);
+
         /*
-         * We may have an extra upper digit, so account for this.
+         * We may not have needed the extra upper digit, so account for this.
          */
-        auto c = static_cast<natural_digit>(acc1);
-        if (c) {
-            res[r_num_digits++] = c;
+        std::size_t r_num_digits = src1_num_digits + src2_num_digits;
+        if (!res[r_num_digits - 1]) {
+            r_num_digits--;
         }
 
         res_num_digits = r_num_digits;
     }
 
     /*
-     * Divide/modulus a single digit by another single digit.
+     * Multiply two digit arrays and add the product to res, accumulating each row of the
+     * long multiply directly into res's digits.
+     *
+     * res must have space for one more digit than the larger of res_num_digits and
+     * src1_num_digits + src2_num_digits.  Both src1_num_digits and src2_num_digits must be
+     * >= 1, and this is most efficient if src2 is the shorter of the two.
+     *
+     * Note: res must not overlap src1 or src2.
      */
-    inline auto __digit_array_divide_modulus_1_1(natural_digit *quotient, std::size_t &quotient_num_digits,
-                                                 natural_digit *remainder, std::size_t &remainder_num_digits,
-                                                 const natural_digit *src1,
-                                                 const natural_digit *src2) -> void {
-        auto v1 = src1[0];
-        auto v2 = src2[0];
-
-        auto q = v1 / v2;
-        auto r = v1 % v2;
+    inline auto __digit_array_addmul_m_n(natural_digit *res, std::size_t &res_num_digits,
+                                         const natural_digit *src1, std::size_t src1_num_digits,
+                                         const natural_digit *src2, std::size_t src2_num_digits) -> void {
+        std::size_t r_num_digits = res_num_digits;
+        std::size_t prod_num_digits = src1_num_digits + src2_num_digits;
+        std::size_t max_num_digits = (r_num_digits > prod_num_digits) ? r_num_digits : prod_num_digits;
+        __digit_array_zero(&res[r_num_digits], max_num_digits + 1 - r_num_digits);
 
-        std::size_t r_num_digits = 0;
+        for (std::size_t j = 0; j < src2_num_digits; j++) {
+            auto acc_c = __digit_array_addmul_1(&res[j], src1, src1_num_digits, src2[j]);
 
-        if (r) {
-            remainder[0] = static_cast<natural_digit>(r);
-            r_num_digits = 1;
+            /*
+             * Propagate our carry.  Our result always fits, so this must terminate.
+             */
+            std::size_t k = j + src1_num_digits;
+            while (acc_c) {
+                auto r = static_cast<natural_digit>(res[k] + acc_c);
+                acc_c = (r < acc_c) ? 1 : 0;
+                res[k++] = r;
+            }
         }
 
-        remainder_num_digits = r_num_digits;
-
-        std::size_t q_num_digits = 0;
-        if (q) {
-            quotient[0] = static_cast<natural_digit>(q);
-            q_num_digits = 1;
+        r_num_digits = max_num_digits + 1;
+        while (r_num_digits && !res[r_num_digits - 1]) {
+            r_num_digits--;
         }
 
-        quotient_num_digits = q_num_digits;
+        res_num_digits = r_num_digits;
     }
 
     /*
-     * Divide/modulus a digit array by a single digit.
+     * Multiply two digit arrays and subtract the product from res, accumulating each row of
+     * the long multiply directly into res's digits.
      *
-     * Note: It is OK for res and src1 to be the same pointer.
+     * If the product is larger than res then res is left holding the magnitude of the
+     * (negative) difference and we return true, otherwise we return false.
+     *
+     * res must have space for the larger of res_num_digits and src1_num_digits +
+     * src2_num_digits.  Both src1_num_digits and src2_num_digits must be >= 1, and this is
+     * most efficient if src2 is the shorter of the two.
+     *
+     * Note: res must not overlap src1 or src2.
      */
-    inline auto __digit_array_divide_modulus_m_1(natural_digit *quotient, std::size_t &quotient_num_digits,
-                                                 natural_digit *remainder, std::size_t &remainder_num_digits,
-                                                 const natural_digit *src1, std::size_t src1_num_digits,
-                                                 const natural_digit *src2) -> void {
-        auto v = src2[0];
+    inline auto __digit_array_submul_m_n(natural_digit *res, std::size_t &res_num_digits,
+                                         const natural_digit *src1, std::size_t src1_num_digits,
+                                         const natural_digit *src2, std::size_t src2_num_digits) -> bool {
+        std::size_t r_num_digits = res_num_digits;
+        std::size_t prod_num_digits = src1_num_digits + src2_num_digits;
+        std::size_t max_num_digits = (r_num_digits > prod_num_digits) ? r_num_digits : prod_num_digits;
+        __digit_array_zero(&res[r_num_digits], max_num_digits - r_num_digits);
 
         /*
-         * Long divide.  Start with the most significant digit.
+         * Both res and our product are less than B^max_num_digits, so the true difference
+         * is too.  We're working modulo B^max_num_digits, so a borrow out of the most
+         * significant digit means the difference is negative.
          */
-        std::size_t q_num_digits = src1_num_digits;
-        std::size_t i = src1_num_digits - 1;
+        bool underflow = false;
+        for (std::size_t j = 0; j < src2_num_digits; j++) {
+            auto acc_c = __digit_array_submul_1(&res[j], src1, src1_num_digits, src2[j]);
+
+            std::size_t k = j + src1_num_digits;
+            while (acc_c && (k < max_num_digits)) {
+                auto r = res[k];
+                res[k++] = static_cast<natural_digit>(r - acc_c);
+                acc_c = (r < acc_c) ? 1 : 0;
+            }
 
-        auto d = src1[i];
-        auto q = d / v;
-        auto r = d % v;
+            if (acc_c) {
+                underflow = true;
+            }
+        }
 
-        quotient[i] = static_cast<natural_digit>(q);
-        if (q == 0) {
-            q_num_digits--;
+        /*
+         * If the difference was negative then we hold its two's complement, so negate it.
+         */
+        if (underflow) {
+            std::size_t i = 0;
+            while (!res[i]) {
+                i++;
+            }
+
+            res[i] = static_cast<natural_digit>(-res[i]);
+            while (++i < max_num_digits) {
+                res[i] = static_cast<natural_digit>(~res[i]);
+            }
         }
 
-        quotient_num_digits = q_num_digits;
+        r_num_digits = max_num_digits;
+        while (r_num_digits && !res[r_num_digits - 1]) {
+            r_num_digits--;
+        }
+
+        res_num_digits = r_num_digits;
+        return underflow;
+    }
 
+    /*
+     * Return the number of scratch digits required by the recursive multiply, or square,
+     * algorithms for operands of src_num_digits, given the thresholds at which each is used.
+     */
+    inline auto __digit_array_scratch_size(std::size_t src_num_digits, std::size_t karatsuba_threshold,
+                                           std::size_t toom3_threshold, std::size_t toom4_threshold) -> std::size_t {
         /*
-         * Loop over all the remaining digits.
+         * Each level of Karatsuba recursion needs 4h + 1 digits (where h is half the
+         * operand size, rounded up).  Toom-Cook 3-way needs 14(k + 1) digits and 4-way
+         * needs 26(k + 1) (where k is a third, or a quarter, of the operand size, rounded
+         * up).  We don't know which algorithm will be picked at each level, so we allow
+         * for the largest.  The largest subproblem is never more than h digits.
          */
-        while (i--) {
-            q = src1[i];
-
-            /*
-             * We need to do a divide, but a large natural_double_digit will typically be
-             * more than a single machine register in size.  The compiler typically won't be
-             * able to generate the most optimal code in such cases so we have to resort to
-             * inline assembler.
-             *
-             * The do/while loop here isn't actually a loop - it just lets us use break to
-             * early-out.  The compiler will invariably recognize that only one path is ever
-             * taken and optimize everything else away.
-             */
-            do {
-                if (sizeof(natural_digit) == 8) {
-#if defined(C8_USE_ASM) && defined(__x86_64__)
-                    asm volatile (
-                    "       divq    %[v]                                \n\t"
-                            : [q] "+a" (q), [r] "+d" (r)
-                            : [v] "r" (v)
-                            : "cc"
-                    );
+        std::size_t sz = 0;
+        while (src_num_digits >= karatsuba_threshold) {
+            std::size_t h = (src_num_digits + 1) / 2;
+            std::size_t level_sz = (4 * h) + 1;
+
+            if (src_num_digits >= toom3_threshold) {
+                std::size_t k3 = (src_num_digits + 2) / 3;
+                std::size_t toom3_sz = 14 * (k3 + 1);
+                if (toom3_sz > level_sz) {
+                    level_sz = toom3_sz;
+                }
+            }
 
-                    break;
-#endif
+            if (src_num_digits >= toom4_threshold) {
+                std::size_t k4 = (src_num_digits + 3) / 4;
+                std::size_t toom4_sz = 26 * (k4 + 1);
+                if (toom4_sz > level_sz) {
+                    level_sz = toom4_sz;
                 }
+            }
 
-                auto acc = (static_cast<natural_double_digit>(r) << natural_digit_bits) + static_cast<natural_double_digit>(q);
-                q = static_cast<natural_digit>(acc / v);
-                r = static_cast<natural_digit>(acc % v);
-            } while (false);
+            sz += level_sz;
+            src_num_digits = h;
+        }
+
+        return sz;
+    }
+
+    /*
+     * Return the number of scratch digits required to multiply a digit array of
+     * src_num_digits by one of the same size, or smaller.
+     */
+    inline auto __digit_array_multiply_scratch_size(std::size_t src_num_digits) -> std::size_t {
+        return __digit_array_scratch_size(src_num_digits, __digit_array_karatsuba_threshold,
+                                          __digit_array_toom3_threshold, __digit_array_toom4_threshold);
+    }
+
+    /*
+     * Return the number of scratch digits required to square a digit array of src_num_digits.
+     */
+    inline auto __digit_array_square_scratch_size(std::size_t src_num_digits) -> std::size_t {
+        return __digit_array_scratch_size(src_num_digits, __digit_array_square_karatsuba_threshold,
+                                          __digit_array_square_toom3_threshold, __digit_array_square_toom4_threshold);
+    }
+
+    inline auto __digit_array_multiply_fixed(natural_digit *res,
+                                             const natural_digit *src1, std::size_t src1_num_digits,
+                                             const natural_digit *src2, std::size_t src2_num_digits,
+                                             natural_digit *scratch) -> void;
 
-            quotient[i] = static_cast<natural_digit>(q);
+    /*
+     * Return true if __digit_array_multiply_fixed() will use the unbalanced multiply for
+     * operands of these sizes.  src1_num_digits must be greater than, or equal to,
+     * src2_num_digits.
+     */
+    inline auto __digit_array_multiply_is_unbalanced(std::size_t src1_num_digits, std::size_t src2_num_digits) -> bool {
+        if (src2_num_digits < __digit_array_karatsuba_threshold) {
+            return false;
         }
 
-        std::size_t r_num_digits = 0;
-        if (r) {
-            remainder[0] = static_cast<natural_digit>(r);
-            r_num_digits = 1;
+        if ((src2_num_digits >= __digit_array_toom3_threshold) && (src2_num_digits > ((src1_num_digits + 2) / 3))) {
+            return false;
         }
 
-        remainder_num_digits = r_num_digits;
+        return (2 * src2_num_digits) <= (src1_num_digits + 1);
     }
 
     /*
-     * Subtract a shifted digit array from another.
+     * Multiply two digit arrays of very different sizes.
      *
-     * Returns true if the subtraction underflows, false if it does not.
+     * None of the sub-quadratic algorithms work well when one operand is much larger than
+     * the other, and a Comba multiply walks the whole of the larger operand for every
+     * column.  Instead we split src1 into chunks of src2_num_digits digits, multiply each
+     * chunk by src2 using whichever algorithm suits that balanced multiply, and accumulate
+     * the partial products into the result.
      *
-     * Unlike the more generic subtract operation above, this one is specifically only for use with
-     * the divide/modulus operation.  This handles underflowing subtraction.
+     * src1_num_digits must be greater than, or equal to, src2_num_digits.  The result always
+     * has exactly src1_num_digits + src2_num_digits digits.  The scratch space must have at
+     * least 2 * src2_num_digits + __digit_array_multiply_scratch_size(src2_num_digits) digits.
+     *
+     * Note: res must not overlap either src1 or src2.
      */
-    inline auto __digit_array_subtract_m_n_shifted(natural_digit *res, std::size_t res_num_digits,
-                                                   const natural_digit *src2, std::size_t src2_num_digits,
-                                                   std::size_t src2_shift) -> bool {
+    inline auto __digit_array_multiply_unbalanced(natural_digit *res,
+                                                  const natural_digit *src1, std::size_t src1_num_digits,
+                                                  const natural_digit *src2, std::size_t src2_num_digits,
+                                                  natural_digit *scratch) -> void {
+        natural_digit *t = scratch;
+        natural_digit *sub_scratch = &scratch[2 * src2_num_digits];
+
         /*
-         * Subtract the first digit.
+         * Our first partial product goes straight into the result.
          */
-        auto acc = static_cast<natural_double_digit>(res[src2_shift]) - static_cast<natural_double_digit>(src2[0]);
-        auto acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
-        res[src2_shift] = static_cast<natural_digit>(acc);
+        __digit_array_multiply_fixed(res, src1, src2_num_digits, src2, src2_num_digits, sub_scratch);
 
         /*
-         * Subtract the remaining digits.
+         * Each subsequent partial product overlaps the upper src2_num_digits of the previous
+         * one, so we add that part, and copy the rest.
          */
-        std::size_t r_num_digits = src2_shift + 1;
-        do {
-            acc = static_cast<natural_double_digit>(res[r_num_digits]) - static_cast<natural_double_digit>(src2[r_num_digits - src2_shift]);
-            acc -= static_cast<natural_double_digit>(acc_c & 1);
-            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
-            res[r_num_digits++] = static_cast<natural_digit>(acc);
-        } while (r_num_digits < (src2_num_digits + src2_shift));
+        for (std::size_t i = src2_num_digits; i < src1_num_digits; i += src2_num_digits) {
+            std::size_t chunk_num_digits = src1_num_digits - i;
+            if (chunk_num_digits > src2_num_digits) {
+                chunk_num_digits = src2_num_digits;
+            }
+
+            __digit_array_multiply_fixed(t, &src1[i], chunk_num_digits, src2, src2_num_digits, sub_scratch);
+            __digit_array_copy(&res[i + src2_num_digits], &t[src2_num_digits], chunk_num_digits);
+            __digit_array_add_in_place(&res[i], src2_num_digits + chunk_num_digits, t, src2_num_digits);
+        }
+    }
+
+    /*
+     * Karatsuba multiply two digit arrays.
+     *
+     * The principle here is that if we split each of our numbers into two halves, a = a1.B + a0
+     * and b = b1.B + b0, then:
+     *
+     * a.b = a1.b1.B^2 + (a1.b0 + a0.b1).B + a0.b0
+     *
+     * and the middle term can be computed from the other two with only one more multiply:
+     *
+     * a1.b0 + a0.b1 = a1.b1 + a0.b0 - (a0 - a1).(b0 - b1)
+     *
+     * Three half-sized multiplies replace four, so, applied recursively, we end up needing
+     * O(n^1.585) digit multiplies rather than O(n^2).
+     *
+     * src1_num_digits must be greater than, or equal to, src2_num_digits, and src2_num_digits
+     * must be greater than half of src1_num_digits (rounded up).  The result always has exactly
+     * src1_num_digits + src2_num_digits digits.  The scratch space must have at least
+     * __digit_array_multiply_scratch_size(src1_num_digits) digits.
+     *
+     * Note: res must not overlap either src1 or src2.
+     */
+    inline auto __digit_array_multiply_karatsuba(natural_digit *res,
+                                                 const natural_digit *src1, std::size_t src1_num_digits,
+                                                 const natural_digit *src2, std::size_t src2_num_digits,
+                                                 natural_digit *scratch) -> void {
+        std::size_t h = (src1_num_digits + 1) / 2;
+        std::size_t a1_num_digits = src1_num_digits - h;
+        std::size_t b1_num_digits = src2_num_digits - h;
+        std::size_t r_num_digits = src1_num_digits + src2_num_digits;
 
         /*
-         * Subtract any carries.
+         * Lay out our scratch space.  Our two differences are later reused to hold the
+         * sum of the low and high products, which is why z1 starts one digit further on.
          */
-        while (r_num_digits < res_num_digits) {
-            acc = static_cast<natural_double_digit>(res[r_num_digits]);
-            acc -= static_cast<natural_double_digit>(acc_c & 1);
-            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
-            res[r_num_digits++] = static_cast<natural_digit>(acc);
+        natural_digit *da = scratch;
+        natural_digit *db = &scratch[h];
+        natural_digit *t = scratch;
+        natural_digit *z1 = &scratch[(2 * h) + 1];
+        natural_digit *sub_scratch = &scratch[(4 * h) + 1];
+
+        /*
+         * Compute |a0 - a1| and |b0 - b1|, and their product.
+         */
+        bool da_neg = __digit_array_abs_difference(da, src1, h, &src1[h], a1_num_digits);
+        bool db_neg = __digit_array_abs_difference(db, src2, h, &src2[h], b1_num_digits);
+        __digit_array_multiply_fixed(z1, da, h, db, h, sub_scratch);
+
+        /*
+         * Compute the low and high products directly into the result.
+         */
+        __digit_array_multiply_fixed(res, src1, h, src2, h, sub_scratch);
+        __digit_array_multiply_fixed(&res[2 * h], &src1[h], a1_num_digits, &src2[h], b1_num_digits, sub_scratch);
+
+        /*
+         * Form the middle term, a0.b0 + a1.b1 -/+ z1, which needs at most 2h + 1 digits.
+         */
+        __digit_array_copy(t, res, 2 * h);
+        t[2 * h] = 0;
+        __digit_array_add_in_place(t, (2 * h) + 1, &res[2 * h], r_num_digits - (2 * h));
+        if (da_neg == db_neg) {
+            __digit_array_subtract_in_place(t, (2 * h) + 1, z1, 2 * h);
+        } else {
+            __digit_array_add_in_place(t, (2 * h) + 1, z1, 2 * h);
         }
 
-        res[r_num_digits] = acc_c;
-        return acc_c ? true : false;
+        /*
+         * Add the middle term into the result.  If the middle term reaches past the end
+         * of our result then the digit it would add must be zero.
+         */
+        __digit_array_add_at(res, r_num_digits, h, t, (2 * h) + 1);
     }
 
     /*
-     * Subtract a multiplied and shifted digit array from another.
+     * Evaluate a 3-part split digit array, a2.x^2 + a1.x + a0, at x = 1, -1 and -2.
      *
-     * Returns true if the subtraction underflows, false if it does not.
+     * a0 and a1 have k digits, while a2 has a2_num_digits (no more than k).  All of the
+     * results have exactly k + 1 digits.
      */
-    inline auto __digit_array_subtract_multiplied_m_n_shifted(natural_digit *res, std::size_t res_num_digits,
-                                                              const natural_digit *src2, std::size_t src2_num_digits,
-                                                              natural_digit src2_multiplier, std::size_t src2_shift) -> bool {
+    inline auto __digit_array_toom3_evaluate(natural_digit *p1, natural_digit *pm1, bool &pm1_neg,
+                                             natural_digit *pm2, bool &pm2_neg,
+                                             const natural_digit *src, std::size_t k, std::size_t a2_num_digits) -> void {
+        const natural_digit *a0 = src;
+        const natural_digit *a1 = &src[k];
+        const natural_digit *a2 = &src[2 * k];
+        std::size_t e_num_digits = k + 1;
+
         /*
-         * Multiply and subtract the first digit.
+         * p1 = a0 + a2, pm1 = a0 + a2 - a1, then p1 = a0 + a1 + a2.
          */
-        auto macc = (static_cast<natural_double_digit>(src2[0]) * static_cast<natural_double_digit>(src2_multiplier));
-        auto macc_c = static_cast<natural_digit>(macc >> natural_digit_bits);
-        auto macc_d = static_cast<natural_digit>(macc);
-        auto sacc = static_cast<natural_double_digit>(res[src2_shift]) - static_cast<natural_double_digit>(macc_d);
-        auto sacc_c = static_cast<natural_digit>(sacc >> natural_digit_bits);
-        res[src2_shift] = static_cast<natural_digit>(sacc);
+        __digit_array_copy(p1, a0, k);
+        p1[k] = 0;
+        __digit_array_add_in_place(p1, e_num_digits, a2, a2_num_digits);
+
+        __digit_array_copy(pm1, p1, e_num_digits);
+        pm1_neg = false;
+        __digit_array_signed_add_in_place(pm1, pm1_neg, e_num_digits, a1, true, k);
+
+        __digit_array_add_in_place(p1, e_num_digits, a1, k);
 
         /*
-         * Multiply and subtract the remaining digits of src2.
+         * pm2 = 2.(pm1 + a2) - a0 = a0 - 2.a1 + 4.a2.
          */
-        std::size_t r_num_digits = src2_shift + 1;
-        do {
-            macc = (static_cast<natural_double_digit>(src2[r_num_digits - src2_shift]) * static_cast<natural_double_digit>(src2_multiplier));
-            macc += static_cast<natural_double_digit>(macc_c);
-            macc_c = static_cast<natural_digit>(macc >> natural_digit_bits);
-            macc_d = static_cast<natural_digit>(macc);
-            sacc = static_cast<natural_double_digit>(res[r_num_digits]) - static_cast<natural_double_digit>(macc_d);
-            sacc -= static_cast<natural_double_digit>(sacc_c & 1);
-            sacc_c = static_cast<natural_digit>(sacc >> natural_digit_bits);
-            res[r_num_digits++] = static_cast<natural_digit>(sacc);
-        } while (r_num_digits < (src2_num_digits + src2_shift));
+        __digit_array_copy(pm2, pm1, e_num_digits);
+        pm2_neg = pm1_neg;
+        __digit_array_signed_add_in_place(pm2, pm2_neg, e_num_digits, a2, false, a2_num_digits);
+        __digit_array_left_shift_fixed(pm2, pm2, e_num_digits, 1);
+        __digit_array_signed_add_in_place(pm2, pm2_neg, e_num_digits, a0, true, k);
+    }
+
+    /*
+     * Complete a Toom-Cook 3-way multiply, or square, by interpolating the products of the
+     * evaluated values to find the coefficients of the product polynomial.
+     *
+     * On entry res holds the value at 0 in its lowest 2k digits, zeros in the next 2k, and
+     * the value at infinity (rinf_num_digits digits) above that.  r1, rm1 and rm2 hold the
+     * products at 1, -1 and -2, each of 2(k + 1) digits, and t is a temporary of the same
+     * size.  We use Bodrato's sequence:
+     *
+     * rm2 = (rm2 - r1) / 3
+     * r1 = (r1 - rm1) / 2
+     * rm1 = rm1 - r0
+     * rm2 = (rm1 - rm2) / 2 + 2.rinf
+     * rm1 = rm1 + r1 - rinf
+     * r1 = r1 - rm2
+     *
+     * after which r1, rm1 and rm2 hold the coefficients of x, x^2 and x^3 respectively, and
+     * we add them into the result.
+     */
+    inline auto __digit_array_toom3_interpolate(natural_digit *res, std::size_t r_num_digits, std::size_t k,
+                                                std::size_t rinf_num_digits, natural_digit *r1,
+                                                natural_digit *rm1, bool rm1_neg, natural_digit *rm2, bool rm2_neg,
+                                                natural_digit *t) -> void {
+        std::size_t w = 2 * (k + 1);
+        const natural_digit *r0 = res;
+        const natural_digit *rinf = &res[4 * k];
+        bool r1_neg = false;
+
+        __digit_array_signed_add_in_place(rm2, rm2_neg, w, r1, true, w);
+        __digit_array_divide_exact_1(rm2, rm2, w, 3);
+
+        __digit_array_signed_add_in_place(r1, r1_neg, w, rm1, !rm1_neg, w);
+        __digit_array_right_shift_fixed(r1, r1, w, 1);
+
+        __digit_array_signed_add_in_place(rm1, rm1_neg, w, r0, true, 2 * k);
+
+        __digit_array_signed_add_in_place(rm2, rm2_neg, w, rm1, !rm1_neg, w);
+        rm2_neg = !rm2_neg;
+        __digit_array_right_shift_fixed(rm2, rm2, w, 1);
+        __digit_array_copy(t, rinf, rinf_num_digits);
+        __digit_array_zero(&t[rinf_num_digits], w - rinf_num_digits);
+        __digit_array_left_shift_fixed(t, t, w, 1);
+        __digit_array_signed_add_in_place(rm2, rm2_neg, w, t, false, w);
+
+        __digit_array_signed_add_in_place(rm1, rm1_neg, w, r1, r1_neg, w);
+        __digit_array_signed_add_in_place(rm1, rm1_neg, w, rinf, true, rinf_num_digits);
+
+        __digit_array_signed_add_in_place(r1, r1_neg, w, rm2, !rm2_neg, w);
 
         /*
-         * Subtract any remaining carries.
+         * Add the middle coefficients into the result.
          */
-        while (r_num_digits < res_num_digits) {
-            sacc = static_cast<natural_double_digit>(res[r_num_digits]) - static_cast<natural_double_digit>(macc_c);
-            macc_c = 0;
-            sacc -= static_cast<natural_double_digit>(sacc_c & 1);
-            sacc_c = static_cast<natural_digit>(sacc >> natural_digit_bits);
-            res[r_num_digits++] = static_cast<natural_digit>(sacc);
-        }
-
-        res[r_num_digits] = sacc_c;
-        return sacc_c ? true : false;
+        __digit_array_add_at(res, r_num_digits, k, r1, w);
+        __digit_array_add_at(res, r_num_digits, 2 * k, rm1, w);
+        __digit_array_add_at(res, r_num_digits, 3 * k, rm2, w);
     }
 
     /*
-     * Add a shifted digit array to another.
+     * Toom-Cook 3-way multiply two digit arrays.
      *
-     * Returns true if the addition has not yet cleared an underflow from a previous subtraction,
-     * false if it has.
+     * This generalizes Karatsuba's approach.  We split both numbers into 3 parts, treat them
+     * as polynomials in x = B^k, evaluate those at 5 points (0, 1, -1, -2 and infinity), and
+     * multiply the values pairwise.  The 5 products uniquely determine the 5 coefficients of
+     * the product polynomial, which we recover by interpolation (using Bodrato's sequence).
+     * Five third-sized multiplies replace nine, so we need O(n^1.465) digit multiplies.
      *
-     * Unlike the more generic add operation above, this one is specifically only for use with
-     * the divide/modulus operation.  This handles compensating for underflowing subtraction.
+     * src1_num_digits must be greater than, or equal to, src2_num_digits, and src2_num_digits
+     * must be greater than 2k, where k is a third of src1_num_digits (rounded up).  The result
+     * always has exactly src1_num_digits + src2_num_digits digits.
+     *
+     * Note: res must not overlap either src1 or src2.
      */
-    inline auto __digit_array_add_m_n_shifted(natural_digit *res, std::size_t res_num_digits,
+    inline auto __digit_array_multiply_toom33(natural_digit *res,
+                                              const natural_digit *src1, std::size_t src1_num_digits,
                                               const natural_digit *src2, std::size_t src2_num_digits,
-                                              std::size_t src2_shift) -> bool {
+                                              natural_digit *scratch) -> void {
+        std::size_t k = (src1_num_digits + 2) / 3;
+        std::size_t a2_num_digits = src1_num_digits - (2 * k);
+        std::size_t b2_num_digits = src2_num_digits - (2 * k);
+        std::size_t r_num_digits = src1_num_digits + src2_num_digits;
+        std::size_t e_num_digits = k + 1;
+        std::size_t w = 2 * e_num_digits;
+
         /*
-         * Add the first digits together.
+         * Lay out our scratch space.
          */
-        auto acc = static_cast<natural_double_digit>(res[src2_shift]) + static_cast<natural_double_digit>(src2[0]);
-        auto acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
-        res[src2_shift] = static_cast<natural_digit>(acc);
-
-        std::size_t r_num_digits = src2_shift + 1;
-        do {
-            acc = static_cast<natural_double_digit>(res[r_num_digits]) + static_cast<natural_double_digit>(src2[r_num_digits - src2_shift]);
-            acc += static_cast<natural_double_digit>(acc_c);
-            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
-            res[r_num_digits++] = static_cast<natural_digit>(acc);
-        } while (r_num_digits < (src2_num_digits + src2_shift));
+        natural_digit *p1 = scratch;
+        natural_digit *pm1 = &scratch[e_num_digits];
+        natural_digit *pm2 = &scratch[2 * e_num_digits];
+        natural_digit *q1 = &scratch[3 * e_num_digits];
+        natural_digit *qm1 = &scratch[4 * e_num_digits];
+        natural_digit *qm2 = &scratch[5 * e_num_digits];
+        natural_digit *r1 = &scratch[6 * e_num_digits];
+        natural_digit *rm1 = &r1[w];
+        natural_digit *rm2 = &r1[2 * w];
+        natural_digit *t = &r1[3 * w];
+        natural_digit *sub_scratch = &r1[4 * w];
 
         /*
-         * Add the remaining digits and any carries.
+         * Evaluate and multiply at 1, -1 and -2.
          */
-        while (r_num_digits < res_num_digits) {
-            acc = static_cast<natural_double_digit>(res[r_num_digits]);
-            acc += static_cast<natural_double_digit>(acc_c);
-            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
-            res[r_num_digits++] = static_cast<natural_digit>(acc);
-        }
+        bool pm1_neg;
+        bool pm2_neg;
+        bool qm1_neg;
+        bool qm2_neg;
+        __digit_array_toom3_evaluate(p1, pm1, pm1_neg, pm2, pm2_neg, src1, k, a2_num_digits);
+        __digit_array_toom3_evaluate(q1, qm1, qm1_neg, qm2, qm2_neg, src2, k, b2_num_digits);
+
+        __digit_array_multiply_fixed(r1, p1, e_num_digits, q1, e_num_digits, sub_scratch);
+        __digit_array_multiply_fixed(rm1, pm1, e_num_digits, qm1, e_num_digits, sub_scratch);
+        __digit_array_multiply_fixed(rm2, pm2, e_num_digits, qm2, e_num_digits, sub_scratch);
+        bool rm1_neg = (pm1_neg != qm1_neg);
+        bool rm2_neg = (pm2_neg != qm2_neg);
 
         /*
-         * If we had a borrow from an earlier subtract then account for that now.
+         * The values at 0 and infinity are the lowest and highest coefficients, so we can
+         * compute those directly into the result.
          */
-        acc_c = static_cast<natural_digit>(acc_c + res[r_num_digits]);
-        res[r_num_digits] = acc_c;
-        return acc_c ? true : false;
+        std::size_t rinf_num_digits = a2_num_digits + b2_num_digits;
+        __digit_array_multiply_fixed(res, src1, k, src2, k, sub_scratch);
+        __digit_array_zero(&res[2 * k], 2 * k);
+        __digit_array_multiply_fixed(&res[4 * k], &src1[2 * k], a2_num_digits, &src2[2 * k], b2_num_digits, sub_scratch);
+
+        __digit_array_toom3_interpolate(res, r_num_digits, k, rinf_num_digits, r1, rm1, rm1_neg, rm2, rm2_neg, t);
     }
 
     /*
-     * Divide two digit arrays.
+     * Toom-Cook 3-way by 2-way multiply two digit arrays.
      *
-     * This function requires quite a lot of temporary digit arrays and so can
-     * consume quite large amounts of stack space.
+     * This is the unbalanced version of Toom-Cook 3-way, for when one operand is roughly
+     * one and a half times the size of the other.  We split the larger number into 3 parts
+     * and the smaller into 2, giving a product polynomial with 4 coefficients that we can
+     * recover from its values at 0, 1, -1 and infinity.
+     *
+     * src1_num_digits must be greater than, or equal to, src2_num_digits, and src2_num_digits
+     * must be greater than k, but no more than 2k, where k is a third of src1_num_digits
+     * (rounded up).  The result always has exactly src1_num_digits + src2_num_digits digits.
+     *
+     * Note: res must not overlap either src1 or src2.
      */
-    inline auto __digit_array_divide_modulus_m_n(natural_digit *quotient, std::size_t &quotient_num_digits,
-                                                 natural_digit *remainder, std::size_t &remainder_num_digits,
-                                                 const natural_digit *src1, std::size_t src1_num_digits,
-                                                 const natural_digit *src2, std::size_t src2_num_digits) -> void {
+    inline auto __digit_array_multiply_toom32(natural_digit *res,
+                                              const natural_digit *src1, std::size_t src1_num_digits,
+                                              const natural_digit *src2, std::size_t src2_num_digits,
+                                              natural_digit *scratch) -> void {
+        std::size_t k = (src1_num_digits + 2) / 3;
+        std::size_t a2_num_digits = src1_num_digits - (2 * k);
+        std::size_t b1_num_digits = src2_num_digits - k;
+        std::size_t r_num_digits = src1_num_digits + src2_num_digits;
+        std::size_t e_num_digits = k + 1;
+        std::size_t w = 2 * e_num_digits;
+
+        const natural_digit *a0 = src1;
+        const natural_digit *a1 = &src1[k];
+        const natural_digit *a2 = &src1[2 * k];
+        const natural_digit *b0 = src2;
+        const natural_digit *b1 = &src2[k];
+
         /*
-         * Normalize the divisor and dividend.  We want our divisor to be aligned such
-         * that it's most significant digit has its top bit set.  This may seem a little odd,
-         * but we want to ensure that any quotient estimates are as accurate as possible.
+         * Lay out our scratch space.
          */
-        auto divisor_bits = __digit_array_size_bits(src2, src2_num_digits);
-        auto divisor_digit_bits = divisor_bits & (natural_digit_bits - 1);
-        unsigned int normalize_shift = static_cast<unsigned int>((natural_digit_bits - divisor_digit_bits) & (natural_digit_bits - 1));
+        natural_digit *p1 = scratch;
+        natural_digit *pm1 = &scratch[e_num_digits];
+        natural_digit *q1 = &scratch[2 * e_num_digits];
+        natural_digit *qm1 = &scratch[3 * e_num_digits];
+        natural_digit *r1 = &scratch[4 * e_num_digits];
+        natural_digit *rm1 = &r1[w];
+        natural_digit *t = &r1[2 * w];
+        natural_digit *sub_scratch = &r1[3 * w];
 
         /*
-         * By definition when we normalize the divisor it keeps the same number of digits.
+         * Evaluate and multiply at 1 and -1.
          */
-        natural_digit divisor[src2_num_digits];
-        std::size_t divisor_num_digits;
-        __digit_array_left_shift_m(divisor, divisor_num_digits, src2, src2_num_digits, 0, normalize_shift);
+        __digit_array_copy(p1, a0, k);
+        p1[k] = 0;
+        __digit_array_add_in_place(p1, e_num_digits, a2, a2_num_digits);
+        __digit_array_copy(pm1, p1, e_num_digits);
+        bool pm1_neg = false;
+        __digit_array_signed_add_in_place(pm1, pm1_neg, e_num_digits, a1, true, k);
+        __digit_array_add_in_place(p1, e_num_digits, a1, k);
+
+        __digit_array_copy(q1, b0, k);
+        q1[k] = 0;
+        __digit_array_copy(qm1, q1, e_num_digits);
+        __digit_array_add_in_place(q1, e_num_digits, b1, b1_num_digits);
+        bool qm1_neg = false;
+        __digit_array_signed_add_in_place(qm1, qm1_neg, e_num_digits, b1, true, b1_num_digits);
+
+        __digit_array_multiply_fixed(r1, p1, e_num_digits, q1, e_num_digits, sub_scratch);
+        __digit_array_multiply_fixed(rm1, pm1, e_num_digits, qm1, e_num_digits, sub_scratch);
+        bool rm1_neg = (pm1_neg != qm1_neg);
 
         /*
-         * Our dividend may end up one digit larger after the normalization and we want one
-         * extra beyond that for handling any overflows.
+         * The values at 0 and infinity are the lowest and highest coefficients.
          */
-        natural_digit dividend[src1_num_digits + 2];
-        std::size_t dividend_num_digits;
-        __digit_array_left_shift_m(dividend, dividend_num_digits, src1, src1_num_digits, 0, normalize_shift);
-        dividend[dividend_num_digits] = 0;
+        const natural_digit *r0 = res;
+        const natural_digit *rinf = &res[3 * k];
+        std::size_t rinf_num_digits = a2_num_digits + b1_num_digits;
+        __digit_array_multiply_fixed(res, a0, k, b0, k, sub_scratch);
+        __digit_array_zero(&res[2 * k], k);
+        __digit_array_multiply_fixed(&res[3 * k], a2, a2_num_digits, b1, b1_num_digits, sub_scratch);
 
         /*
-         * Is our result going to be zero?  If yes then take a shortcut.
+         * Interpolate.  The coefficient of x^2 is (r1 + rm1) / 2 - r0, and that of x is
+         * (r1 - rm1) / 2 - rinf.
          */
-        if (divisor_num_digits > dividend_num_digits) {
-            quotient_num_digits = 0;
-            remainder_num_digits = src1_num_digits;
-            __digit_array_copy(remainder, src1, src1_num_digits);
-            return;
-        }
+        __digit_array_copy(t, r1, w);
+        bool t_neg = false;
+        __digit_array_signed_add_in_place(t, t_neg, w, rm1, rm1_neg, w);
+        __digit_array_right_shift_fixed(t, t, w, 1);
+        __digit_array_signed_add_in_place(t, t_neg, w, r0, true, 2 * k);
+
+        bool r1_neg = false;
+        __digit_array_signed_add_in_place(r1, r1_neg, w, rm1, !rm1_neg, w);
+        __digit_array_right_shift_fixed(r1, r1, w, 1);
+        __digit_array_signed_add_in_place(r1, r1_neg, w, rinf, true, rinf_num_digits);
+
+        __digit_array_add_at(res, r_num_digits, k, r1, w);
+        __digit_array_add_at(res, r_num_digits, 2 * k, t, w);
+    }
 
-        std::size_t next_res_digit = dividend_num_digits - divisor_num_digits;
+    /*
+     * Evaluate a 4-part split digit array, a3.x^3 + a2.x^2 + a1.x + a0, at x = 1, -1, 2 and -2,
+     * and evaluate 8 times its value at x = 1/2.
+     *
+     * a0, a1 and a2 have k digits, while a3 has a3_num_digits (no more than k).  All of the
+     * results have exactly k + 1 digits.
+     */
+    inline auto __digit_array_toom4_evaluate(natural_digit *p1, natural_digit *pm1, bool &pm1_neg,
+                                             natural_digit *p2, natural_digit *pm2, bool &pm2_neg, natural_digit *ph,
+                                             const natural_digit *src, std::size_t k, std::size_t a3_num_digits) -> void {
+        const natural_digit *a0 = src;
+        const natural_digit *a1 = &src[k];
+        const natural_digit *a2 = &src[2 * k];
+        const natural_digit *a3 = &src[3 * k];
+        std::size_t e_num_digits = k + 1;
 
         /*
-         * All of our quotient estimates are done with the most significant digit of our divisor.
+         * With e = a0 + a2 and o = a1 + a3, p1 = e + o and pm1 = e - o.  We use p2 as a
+         * temporary.
          */
-        auto divisor_most_sig_digit = divisor[divisor_num_digits - 1];
+        __digit_array_copy(p1, a0, k);
+        p1[k] = 0;
+        __digit_array_add_in_place(p1, e_num_digits, a2, k);
+        __digit_array_copy(p2, p1, e_num_digits);
+
+        __digit_array_copy(pm1, a1, k);
+        pm1[k] = 0;
+        __digit_array_add_in_place(pm1, e_num_digits, a3, a3_num_digits);
+        __digit_array_add_in_place(p1, e_num_digits, pm1, e_num_digits);
+        pm1_neg = true;
+        __digit_array_signed_add_in_place(pm1, pm1_neg, e_num_digits, p2, false, e_num_digits);
 
         /*
-         * Our first estimate is trivial - the digit will either be 0 or 1.  We handle
-         * this as a special case.
+         * With e = a0 + 4.a2 and o = 2.a1 + 8.a3, p2 = e + o and pm2 = e - o.  We use ph as a
+         * temporary.
          */
-        natural_digit q = 0;
-        if (dividend[dividend_num_digits - 1] >= divisor_most_sig_digit) {
-            /*
-             * There's a good chance that our digit is a 1.  Try subtracting the effect of
-             * a 1 and see if we underflow.  If we do then add the effect of the 1 back.
-             */
-            q = 1;
-            auto underflow = __digit_array_subtract_m_n_shifted(dividend, dividend_num_digits,
-                                                                divisor, divisor_num_digits, next_res_digit);
-            if (C8_UNLIKELY(underflow)) {
-                __digit_array_add_m_n_shifted(dividend, dividend_num_digits,
-                                              divisor, divisor_num_digits, next_res_digit);
-                q = 0;
-            }
-        }
+        __digit_array_copy(p2, a0, k);
+        p2[k] = 0;
+        __digit_array_copy(ph, a2, k);
+        ph[k] = 0;
+        __digit_array_left_shift_fixed(ph, ph, e_num_digits, 2);
+        __digit_array_add_in_place(p2, e_num_digits, ph, e_num_digits);
+
+        __digit_array_copy(pm2, a1, k);
+        pm2[k] = 0;
+        __digit_array_copy(ph, a3, a3_num_digits);
+        __digit_array_zero(&ph[a3_num_digits], e_num_digits - a3_num_digits);
+        __digit_array_left_shift_fixed(ph, ph, e_num_digits, 2);
+        __digit_array_add_in_place(pm2, e_num_digits, ph, e_num_digits);
+        __digit_array_left_shift_fixed(pm2, pm2, e_num_digits, 1);
+
+        __digit_array_copy(ph, p2, e_num_digits);
+        __digit_array_add_in_place(p2, e_num_digits, pm2, e_num_digits);
+        pm2_neg = true;
+        __digit_array_signed_add_in_place(pm2, pm2_neg, e_num_digits, ph, false, e_num_digits);
 
-        quotient[next_res_digit] = q;
+        /*
+         * ph = 8.a0 + 4.a1 + 2.a2 + a3, computed using Horner's rule.
+         */
+        __digit_array_copy(ph, a0, k);
+        ph[k] = 0;
+        __digit_array_left_shift_fixed(ph, ph, e_num_digits, 1);
+        __digit_array_add_in_place(ph, e_num_digits, a1, k);
+        __digit_array_left_shift_fixed(ph, ph, e_num_digits, 1);
+        __digit_array_add_in_place(ph, e_num_digits, a2, k);
+        __digit_array_left_shift_fixed(ph, ph, e_num_digits, 1);
+        __digit_array_add_in_place(ph, e_num_digits, a3, a3_num_digits);
+    }
+
+    /*
+     * Complete a Toom-Cook 4-way multiply, or square, by interpolating the products of the
+     * evaluated values to find the coefficients of the product polynomial.
+     *
+     * On entry res holds the value at 0 in its lowest 2k digits, zeros in the next 4k, and
+     * the value at infinity (rinf_num_digits digits) above that.  r1, rm1, r2, rm2 and rh hold
+     * the products at 1, -1, 2, -2 and 1/2 (the last scaled by 64), each of 2(k + 1) digits,
+     * and x, y and z are temporaries of the same size.
+     *
+     * With c0..c6 being the coefficients of the product, we use:
+     *
+     * c2 + c4 = (r1 + rm1) / 2 - c0 - c6
+     * c2 + 4.c4 = ((r2 + rm2) / 2 - c0 - 64.c6) / 4
+     * c1 + c3 + c5 = (r1 - rm1) / 2
+     * c1 + 4.c3 + 16.c5 = (r2 - rm2) / 4
+     * 16.c1 + 4.c3 + c5 = (rh - 64.c0 - 16.c2 - 4.c4 - c6) / 2
+     */
+    inline auto __digit_array_toom4_interpolate(natural_digit *res, std::size_t r_num_digits, std::size_t k,
+                                                std::size_t rinf_num_digits, natural_digit *r1,
+                                                natural_digit *rm1, bool rm1_neg, natural_digit *r2,
+                                                natural_digit *rm2, bool rm2_neg, natural_digit *rh,
+                                                natural_digit *x, natural_digit *y, natural_digit *z) -> void {
+        std::size_t w = 2 * (k + 1);
+        const natural_digit *r0 = res;
+        const natural_digit *rinf = &res[6 * k];
+        bool r1_neg = false;
+        bool r2_neg = false;
+        bool rh_neg = false;
 
         /*
-         * Now we run our "long divide" algorithm over the remaining digits.
+         * x = c1 + c3 + c5, r1 = c2 + c4.
          */
-        while (next_res_digit--) {
-            auto d_hi = dividend[dividend_num_digits - 1];
+        __digit_array_copy(x, r1, w);
+        bool x_neg = false;
+        __digit_array_signed_add_in_place(x, x_neg, w, rm1, !rm1_neg, w);
+        __digit_array_right_shift_fixed(x, x, w, 1);
 
-            /*
-             * Is the upper digit of our dividend the same as the first digit our of divisor?  If
-             * it is then we know the result is, at most, the largest possible digit value,
-             * because we've already handled all situations in which the result would be larger.
-             */
-            if (C8_UNLIKELY(d_hi == divisor_most_sig_digit)) {
-                q = static_cast<natural_digit>(-1);
-            } else {
-                /*
-                 * Estimate the next digit of the result by dividing the most significant two
-                 * digits of our dividend by the most significant digit of our divisor.
-                 */
-                q = dividend[dividend_num_digits - 2];
+        __digit_array_signed_add_in_place(r1, r1_neg, w, rm1, rm1_neg, w);
+        __digit_array_right_shift_fixed(r1, r1, w, 1);
+        __digit_array_signed_add_in_place(r1, r1_neg, w, r0, true, 2 * k);
+        __digit_array_signed_add_in_place(r1, r1_neg, w, rinf, true, rinf_num_digits);
 
-                /*
-                 * We need to do a divide, but a large natural_double_digit will typically be
-                 * more than a single machine register in size.  The compiler typically won't be
-                 * able to generate the most optimal code in such cases so we have to resort to
-                 * inline assembler.
-                 *
-                 * The do/while loop here isn't actually a loop - it just lets us use break to
-                 * early-out.  The compiler will invariably recognize that only one path is ever
-                 * taken and optimize everything else away.
-                 */
-                do {
-                    if (sizeof(natural_digit) == 8) {
-#if defined(C8_USE_ASM) && defined(__x86_64__)
-                        asm volatile (
-                        "       divq    %[divisor_most_sig_digit]       \n\t"
-                                : [q] "+a" (q), [d_hi] "+d" (d_hi)
-                                : [divisor_most_sig_digit] "r" (divisor_most_sig_digit)
-                                : "cc"
-                        );
-
-                        break;
-#endif
-                    }
+        /*
+         * y = c1 + 4.c3 + 16.c5, r2 = c2 + 4.c4.
+         */
+        __digit_array_copy(y, r2, w);
+        bool y_neg = false;
+        __digit_array_signed_add_in_place(y, y_neg, w, rm2, !rm2_neg, w);
+        __digit_array_right_shift_fixed(y, y, w, 2);
+
+        __digit_array_signed_add_in_place(r2, r2_neg, w, rm2, rm2_neg, w);
+        __digit_array_right_shift_fixed(r2, r2, w, 1);
+        __digit_array_signed_add_in_place(r2, r2_neg, w, r0, true, 2 * k);
+        __digit_array_copy(z, rinf, rinf_num_digits);
+        __digit_array_zero(&z[rinf_num_digits], w - rinf_num_digits);
+        __digit_array_left_shift_fixed(z, z, w, 6);
+        __digit_array_signed_add_in_place(r2, r2_neg, w, z, true, w);
+        __digit_array_right_shift_fixed(r2, r2, w, 2);
 
-                    auto d_lo_d = static_cast<natural_double_digit>(q);
-                    auto d_hi_d = static_cast<natural_double_digit>(d_hi);
-                    auto d = static_cast<natural_double_digit>(d_hi_d << natural_digit_bits) + d_lo_d;
-                    q = static_cast<natural_digit>(d / static_cast<natural_double_digit>(divisor_most_sig_digit));
-                } while (false);
-            }
+        /*
+         * r2 = c4, r1 = c2.
+         */
+        __digit_array_signed_add_in_place(r2, r2_neg, w, r1, !r1_neg, w);
+        __digit_array_divide_exact_1(r2, r2, w, 3);
+        __digit_array_signed_add_in_place(r1, r1_neg, w, r2, !r2_neg, w);
 
-            /*
-             * Did we estimate that there was a non-zero digit?  If yes, then we want to refine
-             * the estimate and subtract it from our dividend, but if we estimated zero then
+        /*
+         * rh = 16.c1 + 4.c3 + c5.
+         */
+        __digit_array_copy(z, r0, 2 * k);
+        __digit_array_zero(&z[2 * k], w - (2 * k));
+        __digit_array_left_shift_fixed(z, z, w, 6);
+        __digit_array_signed_add_in_place(rh, rh_neg, w, z, true, w);
+        __digit_array_left_shift_fixed(z, r1, w, 4);
+        __digit_array_signed_add_in_place(rh, rh_neg, w, z, !r1_neg, w);
+        __digit_array_left_shift_fixed(z, r2, w, 2);
+        __digit_array_signed_add_in_place(rh, rh_neg, w, z, !r2_neg, w);
+        __digit_array_signed_add_in_place(rh, rh_neg, w, rinf, true, rinf_num_digits);
+        __digit_array_right_shift_fixed(rh, rh, w, 1);
+
+        /*
+         * y = (y - x) / 3 = c3 + 5.c5, rh = (16.x - rh) / 3 = 4.c3 + 5.c5.
+         */
+        __digit_array_signed_add_in_place(y, y_neg, w, x, !x_neg, w);
+        __digit_array_divide_exact_1(y, y, w, 3);
+
+        __digit_array_left_shift_fixed(z, x, w, 4);
+        __digit_array_signed_add_in_place(rh, rh_neg, w, z, !x_neg, w);
+        rh_neg = !rh_neg;
+        __digit_array_divide_exact_1(rh, rh, w, 3);
+
+        /*
+         * rh = c3, y = c5, x = c1.
+         */
+        __digit_array_signed_add_in_place(rh, rh_neg, w, y, !y_neg, w);
+        __digit_array_divide_exact_1(rh, rh, w, 3);
+        __digit_array_signed_add_in_place(y, y_neg, w, rh, !rh_neg, w);
+        __digit_array_divide_exact_1(y, y, w, 5);
+        __digit_array_signed_add_in_place(x, x_neg, w, rh, !rh_neg, w);
+        __digit_array_signed_add_in_place(x, x_neg, w, y, !y_neg, w);
+
+        /*
+         * Add the middle coefficients into the result.
+         */
+        __digit_array_add_at(res, r_num_digits, k, x, w);
+        __digit_array_add_at(res, r_num_digits, 2 * k, r1, w);
+        __digit_array_add_at(res, r_num_digits, 3 * k, rh, w);
+        __digit_array_add_at(res, r_num_digits, 4 * k, r2, w);
+        __digit_array_add_at(res, r_num_digits, 5 * k, y, w);
+    }
+
+    /*
+     * Toom-Cook 4-way multiply two digit arrays.
+     *
+     * We split both numbers into 4 parts, evaluate at 7 points (0, 1, -1, 2, -2, 1/2 and
+     * infinity), multiply pairwise, and interpolate to find the 7 coefficients of the product.
+     * Seven quarter-sized multiplies replace sixteen, so we need O(n^1.404) digit multiplies.
+     *
+     * src1_num_digits must be greater than, or equal to, src2_num_digits, and src2_num_digits
+     * must be greater than 3k, where k is a quarter of src1_num_digits (rounded up).  The result
+     * always has exactly src1_num_digits + src2_num_digits digits.
+     *
+     * Note: res must not overlap either src1 or src2.
+     */
+    inline auto __digit_array_multiply_toom44(natural_digit *res,
+                                              const natural_digit *src1, std::size_t src1_num_digits,
+                                              const natural_digit *src2, std::size_t src2_num_digits,
+                                              natural_digit *scratch) -> void {
+        std::size_t k = (src1_num_digits + 3) / 4;
+        std::size_t a3_num_digits = src1_num_digits - (3 * k);
+        std::size_t b3_num_digits = src2_num_digits - (3 * k);
+        std::size_t r_num_digits = src1_num_digits + src2_num_digits;
+        std::size_t e_num_digits = k + 1;
+        std::size_t w = 2 * e_num_digits;
+
+        /*
+         * Lay out our scratch space.
+         */
+        natural_digit *p1 = scratch;
+        natural_digit *pm1 = &scratch[e_num_digits];
+        natural_digit *p2 = &scratch[2 * e_num_digits];
+        natural_digit *pm2 = &scratch[3 * e_num_digits];
+        natural_digit *ph = &scratch[4 * e_num_digits];
+        natural_digit *q1 = &scratch[5 * e_num_digits];
+        natural_digit *qm1 = &scratch[6 * e_num_digits];
+        natural_digit *q2 = &scratch[7 * e_num_digits];
+        natural_digit *qm2 = &scratch[8 * e_num_digits];
+        natural_digit *qh = &scratch[9 * e_num_digits];
+        natural_digit *r1 = &scratch[10 * e_num_digits];
+        natural_digit *rm1 = &r1[w];
+        natural_digit *r2 = &r1[2 * w];
+        natural_digit *rm2 = &r1[3 * w];
+        natural_digit *rh = &r1[4 * w];
+        natural_digit *x = &r1[5 * w];
+        natural_digit *y = &r1[6 * w];
+        natural_digit *z = &r1[7 * w];
+        natural_digit *sub_scratch = &r1[8 * w];
+
+        /*
+         * Evaluate and multiply at 1, -1, 2, -2 and 1/2.
+         */
+        bool pm1_neg;
+        bool pm2_neg;
+        bool qm1_neg;
+        bool qm2_neg;
+        __digit_array_toom4_evaluate(p1, pm1, pm1_neg, p2, pm2, pm2_neg, ph, src1, k, a3_num_digits);
+        __digit_array_toom4_evaluate(q1, qm1, qm1_neg, q2, qm2, qm2_neg, qh, src2, k, b3_num_digits);
+
+        __digit_array_multiply_fixed(r1, p1, e_num_digits, q1, e_num_digits, sub_scratch);
+        __digit_array_multiply_fixed(rm1, pm1, e_num_digits, qm1, e_num_digits, sub_scratch);
+        __digit_array_multiply_fixed(r2, p2, e_num_digits, q2, e_num_digits, sub_scratch);
+        __digit_array_multiply_fixed(rm2, pm2, e_num_digits, qm2, e_num_digits, sub_scratch);
+        __digit_array_multiply_fixed(rh, ph, e_num_digits, qh, e_num_digits, sub_scratch);
+        bool rm1_neg = (pm1_neg != qm1_neg);
+        bool rm2_neg = (pm2_neg != qm2_neg);
+
+        /*
+         * The values at 0 and infinity are the lowest and highest coefficients, so we can
+         * compute those directly into the result.
+         */
+        std::size_t rinf_num_digits = a3_num_digits + b3_num_digits;
+        __digit_array_multiply_fixed(res, src1, k, src2, k, sub_scratch);
+        __digit_array_zero(&res[2 * k], 4 * k);
+        __digit_array_multiply_fixed(&res[6 * k], &src1[3 * k], a3_num_digits, &src2[3 * k], b3_num_digits, sub_scratch);
+
+        __digit_array_toom4_interpolate(res, r_num_digits, k, rinf_num_digits, r1, rm1, rm1_neg, r2, rm2, rm2_neg, rh, x, y, z);
+    }
+
+    /*
+     * Multiply two digit arrays, selecting the most appropriate algorithm for the sizes
+     * of the operands.
+     *
+     * The result always has exactly src1_num_digits + src2_num_digits digits, so the most
+     * significant one may be zero.  Leading zero digits are allowed in both source arrays.
+     * The scratch space must have at least __digit_array_multiply_scratch_size() digits for
+     * the larger of the two operands.
+     *
+     * Note: res must not overlap either src1 or src2.
+     */
+    inline auto __digit_array_multiply_fixed(natural_digit *res,
+                                             const natural_digit *src1, std::size_t src1_num_digits,
+                                             const natural_digit *src2, std::size_t src2_num_digits,
+                                             natural_digit *scratch) -> void {
+        if (src1_num_digits < src2_num_digits) {
+            std::swap(src1, src2);
+            std::swap(src1_num_digits, src2_num_digits);
+        }
+
+        /*
+         * The sub-quadratic algorithms only help if both operands are reasonably large.  Each
+         * also needs the operands to be of broadly similar sizes.
+         */
+        if (src2_num_digits < __digit_array_karatsuba_threshold) {
+            __digit_array_multiply_comba(res, src1, src1_num_digits, src2, src2_num_digits);
+            return;
+        }
+
+        if (src2_num_digits >= __digit_array_toom3_threshold) {
+            std::size_t k4 = (src1_num_digits + 3) / 4;
+            if ((src2_num_digits >= __digit_array_toom4_threshold) && (src2_num_digits > (3 * k4))) {
+                __digit_array_multiply_toom44(res, src1, src1_num_digits, src2, src2_num_digits, scratch);
+                return;
+            }
+
+            std::size_t k3 = (src1_num_digits + 2) / 3;
+            if (src2_num_digits > (2 * k3)) {
+                __digit_array_multiply_toom33(res, src1, src1_num_digits, src2, src2_num_digits, scratch);
+                return;
+            }
+
+            if (src2_num_digits > k3) {
+                __digit_array_multiply_toom32(res, src1, src1_num_digits, src2, src2_num_digits, scratch);
+                return;
+            }
+        }
+
+        if ((2 * src2_num_digits) > (src1_num_digits + 1)) {
+            __digit_array_multiply_karatsuba(res, src1, src1_num_digits, src2, src2_num_digits, scratch);
+            return;
+        }
+
+        __digit_array_multiply_unbalanced(res, src1, src1_num_digits, src2, src2_num_digits, scratch);
+    }
+
+    /*
+     * Details of one of the primes used by our number-theoretic transforms.
+     *
+     * Each prime is of the form c.2^k + 1, with k >= 55, so we can find roots of unity for
+     * any transform length we could ever need.  All are below 2^62, which lets us use
+     * Montgomery multiplication (with R = 2^64) without worrying about overflows.
+     */
+    struct __digit_array_ntt_prime {
+        uint64_t p;                     // The prime itself
+        uint64_t p_inv;                 // -1/p mod 2^64
+        uint64_t r2;                    // R^2 mod p
+        uint64_t g;                     // A primitive root mod p
+    };
+
+    /*
+     * Montgomery multiply two values mod p, returning a.b/R mod p.
+     *
+     * If either a or b is held in Montgomery form (i.e. multiplied by R) then the result
+     * will be in normal form.
+     */
+    inline auto __digit_array_ntt_mont_mul(uint64_t a, uint64_t b, const __digit_array_ntt_prime &pr) -> uint64_t {
+        auto t = static_cast<unsigned __int128>(a) * static_cast<unsigned __int128>(b);
+        auto m = static_cast<uint64_t>(static_cast<uint64_t>(t) * pr.p_inv);
+        auto u = static_cast<uint64_t>((t + static_cast<unsigned __int128>(m) * static_cast<unsigned __int128>(pr.p)) >> 64);
+        return (u >= pr.p) ? (u - pr.p) : u;
+    }
+
+    /*
+     * Convert a value mod p into Montgomery form.
+     */
+    inline auto __digit_array_ntt_to_mont(uint64_t a, const __digit_array_ntt_prime &pr) -> uint64_t {
+        return __digit_array_ntt_mont_mul(a, pr.r2, pr);
+    }
+
+    /*
+     * Raise a value mod p to a power.  Both the value and the result are in normal form.
+     */
+    inline auto __digit_array_ntt_pow(uint64_t a, uint64_t e, const __digit_array_ntt_prime &pr) -> uint64_t {
+        uint64_t a_m = __digit_array_ntt_to_mont(a, pr);
+        uint64_t r = 1;
+        while (e) {
+            if (e & 1) {
+                r = __digit_array_ntt_mont_mul(r, a_m, pr);
+            }
+
+            a_m = __digit_array_ntt_mont_mul(a_m, a_m, pr);
+            e >>= 1;
+        }
+
+        return r;
+    }
+
+    /*
+     * Set up the details for one of our transform primes.
+     */
+    inline auto __digit_array_ntt_init_prime(__digit_array_ntt_prime &pr, uint64_t p, uint64_t g) -> void {
+        pr.p = p;
+        pr.g = g;
+
+        /*
+         * Compute 1/p mod 2^64 using Newton's method, then negate it.
+         */
+        uint64_t inv = p;
+        for (unsigned int i = 0; i < 6; i++) {
+            inv = static_cast<uint64_t>(inv * static_cast<uint64_t>(2 - static_cast<uint64_t>(p * inv)));
+        }
+
+        pr.p_inv = static_cast<uint64_t>(0 - inv);
+
+        auto r = static_cast<unsigned __int128>(1) << 64;
+        auto r_mod_p = static_cast<uint64_t>(r % p);
+        pr.r2 = static_cast<uint64_t>((static_cast<unsigned __int128>(r_mod_p) * r_mod_p) % p);
+    }
+
+    /*
+     * Compute a number-theoretic transform of n values mod p, in place.  n must be a power
+     * of 2.  tw must have space for n / 2 values, and is used to hold the twiddle factors.
+     *
+     * The forward transform uses decimation-in-frequency, taking its input in natural order
+     * and leaving its output in bit-reversed order.  The inverse transform uses
+     * decimation-in-time, taking its input in bit-reversed order and leaving its output in
+     * natural order.  This means we never need to do any bit-reversal permutations.  The
+     * inverse transform does not scale its output by 1/n.
+     */
+    inline auto __digit_array_ntt_transform(uint64_t *a, std::size_t n, bool inverse, uint64_t *tw,
+                                            const __digit_array_ntt_prime &pr) -> void {
+        uint64_t p = pr.p;
+
+        /*
+         * Compute the powers of our principal n-th root of unity, in Montgomery form.
+         */
+        uint64_t w = __digit_array_ntt_pow(pr.g, (p - 1) / n, pr);
+        if (inverse) {
+            w = __digit_array_ntt_pow(w, n - 1, pr);
+        }
+
+        uint64_t w_m = __digit_array_ntt_to_mont(w, pr);
+        uint64_t t_m = __digit_array_ntt_to_mont(1, pr);
+        for (std::size_t j = 0; j < n / 2; j++) {
+            tw[j] = t_m;
+            t_m = __digit_array_ntt_mont_mul(t_m, w_m, pr);
+        }
+
+        if (!inverse) {
+            for (std::size_t len = n / 2; len >= 1; len >>= 1) {
+                std::size_t stride = n / (2 * len);
+                for (std::size_t i = 0; i < n; i += 2 * len) {
+                    for (std::size_t j = 0; j < len; j++) {
+                        uint64_t u = a[i + j];
+                        uint64_t v = a[i + j + len];
+                        uint64_t s = u + v;
+                        a[i + j] = (s >= p) ? (s - p) : s;
+                        uint64_t d = (u >= v) ? (u - v) : (u + p - v);
+                        a[i + j + len] = __digit_array_ntt_mont_mul(d, tw[j * stride], pr);
+                    }
+                }
+            }
+
+            return;
+        }
+
+        for (std::size_t len = 1; len < n; len <<= 1) {
+            std::size_t stride = n / (2 * len);
+            for (std::size_t i = 0; i < n; i += 2 * len) {
+                for (std::size_t j = 0; j < len; j++) {
+                    uint64_t u = a[i + j];
+                    uint64_t v = __digit_array_ntt_mont_mul(a[i + j + len], tw[j * stride], pr);
+                    uint64_t s = u + v;
+                    a[i + j] = (s >= p) ? (s - p) : s;
+                    a[i + j + len] = (u >= v) ? (u - v) : (u + p - v);
+                }
+            }
+        }
+    }
+
+    /*
+     * Load a digit array into an array of n values mod p, packing the digits into 64-bit
+     * words and zero padding.
+     */
+    inline auto __digit_array_ntt_load(uint64_t *a, std::size_t n, const natural_digit *src, std::size_t src_num_digits,
+                                       const __digit_array_ntt_prime &pr) -> void {
+        const std::size_t word_digits = 64 / natural_digit_bits;
+        std::size_t i = 0;
+        for (std::size_t j = 0; j < src_num_digits; j += word_digits) {
+            uint64_t v = 0;
+            for (std::size_t k = 0; (k < word_digits) && ((j + k) < src_num_digits); k++) {
+                v |= static_cast<uint64_t>(src[j + k]) << (k * natural_digit_bits);
+            }
+
+            a[i++] = v % pr.p;
+        }
+
+        while (i < n) {
+            a[i++] = 0;
+        }
+    }
+
+    /*
+     * Multiply two digit arrays using number-theoretic transforms.
+     *
+     * We split each number into 64-bit words and compute the cyclic convolution of those
+     * words modulo three different primes, via transforms of length n.  The three primes
+     * have a product greater than 2^183, so as long as n is less than 2^55 each coefficient
+     * of the convolution can be recovered exactly, using the Chinese Remainder Theorem.
+     * This costs O(n log n) word operations.
+     *
+     * The result always has exactly src1_num_digits + src2_num_digits digits.
+     *
+     * Note: It is OK for res and either src1, or src2, to be the same pointer.
+     */
+    inline auto __digit_array_multiply_ntt(natural_digit *res,
+                                           const natural_digit *src1, std::size_t src1_num_digits,
+                                           const natural_digit *src2, std::size_t src2_num_digits) -> void {
+        const std::size_t word_digits = 64 / natural_digit_bits;
+        std::size_t src1_num_words = (src1_num_digits + word_digits - 1) / word_digits;
+        std::size_t src2_num_words = (src2_num_digits + word_digits - 1) / word_digits;
+        std::size_t conv_num_words = src1_num_words + src2_num_words - 1;
+        std::size_t r_num_digits = src1_num_digits + src2_num_digits;
+
+        std::size_t n = 1;
+        while (n < conv_num_words) {
+            n <<= 1;
+        }
+
+        /*
+         * If we're squaring then we only need one forward transform per prime.
+         */
+        bool square = ((src1 == src2) && (src1_num_digits == src2_num_digits));
+
+        /*
+         * Our primes are in ascending order, which simplifies the CRT reconstruction.
+         */
+        __digit_array_ntt_prime pr[3];
+        __digit_array_ntt_init_prime(pr[0], 0x1b00000000000001ULL, 5);
+        __digit_array_ntt_init_prime(pr[1], 0x2280000000000001ULL, 5);
+        __digit_array_ntt_init_prime(pr[2], 0x3a00000000000001ULL, 3);
+
+        /*
+         * We need space for the convolution modulo each prime, plus space for the transform
+         * of our second operand, and for the twiddle factors.
+         */
+        std::unique_ptr<uint64_t[]> buf(new uint64_t[(4 * n) + (n / 2)]);
+        uint64_t *b = &buf[3 * n];
+        uint64_t *tw = &buf[4 * n];
+
+        for (std::size_t k = 0; k < 3; k++) {
+            uint64_t *a = &buf[k * n];
+            __digit_array_ntt_load(a, n, src1, src1_num_digits, pr[k]);
+            __digit_array_ntt_transform(a, n, false, tw, pr[k]);
+
+            const uint64_t *bk = a;
+            if (!square) {
+                __digit_array_ntt_load(b, n, src2, src2_num_digits, pr[k]);
+                __digit_array_ntt_transform(b, n, false, tw, pr[k]);
+                bk = b;
+            }
+
+            /*
+             * Multiply pointwise.  Our Montgomery multiplies introduce a factor of 1/R^2, so
+             * we correct for that and the 1/n scaling of the inverse transform with one more
+             * multiply by R^2/n.
+             */
+            uint64_t p = pr[k].p;
+            uint64_t n_inv = p - ((p - 1) / n);
+            auto scale = static_cast<uint64_t>((static_cast<unsigned __int128>(pr[k].r2) * n_inv) % p);
+            for (std::size_t i = 0; i < n; i++) {
+                a[i] = __digit_array_ntt_mont_mul(__digit_array_ntt_mont_mul(a[i], bk[i], pr[k]), scale, pr[k]);
+            }
+
+            __digit_array_ntt_transform(a, n, true, tw, pr[k]);
+        }
+
+        /*
+         * Recombine the three residues of each coefficient using Garner's algorithm, giving
+         * x = v0 + v1.p0 + v2.p0.p1, then add each into our result, propagating carries
+         * upwards.  We hold the inverses we need in Montgomery form.
+         */
+        uint64_t p0 = pr[0].p;
+        uint64_t p1 = pr[1].p;
+        uint64_t p2 = pr[2].p;
+        uint64_t inv01_m = __digit_array_ntt_to_mont(__digit_array_ntt_pow(p0, p1 - 2, pr[1]), pr[1]);
+        uint64_t inv02_m = __digit_array_ntt_to_mont(__digit_array_ntt_pow(p0, p2 - 2, pr[2]), pr[2]);
+        uint64_t inv12_m = __digit_array_ntt_to_mont(__digit_array_ntt_pow(p1, p2 - 2, pr[2]), pr[2]);
+        auto p01 = static_cast<unsigned __int128>(p0) * p1;
+        auto p01_lo = static_cast<uint64_t>(p01);
+        auto p01_hi = static_cast<uint64_t>(p01 >> 64);
+
+        uint64_t acc0 = 0;
+        uint64_t acc1 = 0;
+        uint64_t acc2 = 0;
+        for (std::size_t j = 0; j < r_num_digits; j += word_digits) {
+            std::size_t i = j / word_digits;
+            if (i < conv_num_words) {
+                uint64_t v0 = buf[i];
+                uint64_t r1 = buf[n + i];
+                uint64_t r2 = buf[(2 * n) + i];
+                uint64_t v1 = (r1 >= v0) ? (r1 - v0) : (r1 + p1 - v0);
+                v1 = __digit_array_ntt_mont_mul(v1, inv01_m, pr[1]);
+                uint64_t v2 = (r2 >= v0) ? (r2 - v0) : (r2 + p2 - v0);
+                v2 = __digit_array_ntt_mont_mul(v2, inv02_m, pr[2]);
+                v2 = (v2 >= v1) ? (v2 - v1) : (v2 + p2 - v1);
+                v2 = __digit_array_ntt_mont_mul(v2, inv12_m, pr[2]);
+
+                /*
+                 * x = v0 + v1.p0 + v2.p01, as a 192-bit value, x2:x1:x0.
+                 */
+                auto t = static_cast<unsigned __int128>(v1) * p0 + v0;
+                uint64_t x0 = static_cast<uint64_t>(t);
+                uint64_t x1 = static_cast<uint64_t>(t >> 64);
+                auto m = static_cast<unsigned __int128>(v2) * p01_lo;
+                auto s = static_cast<unsigned __int128>(x0) + static_cast<uint64_t>(m);
+                x0 = static_cast<uint64_t>(s);
+                s = (s >> 64) + x1 + (m >> 64);
+                x1 = static_cast<uint64_t>(s);
+                uint64_t x2 = static_cast<uint64_t>(s >> 64);
+                m = static_cast<unsigned __int128>(v2) * p01_hi;
+                s = static_cast<unsigned __int128>(x1) + static_cast<uint64_t>(m);
+                x1 = static_cast<uint64_t>(s);
+                x2 = static_cast<uint64_t>(x2 + static_cast<uint64_t>(s >> 64) + static_cast<uint64_t>(m >> 64));
+
+                s = static_cast<unsigned __int128>(acc0) + x0;
+                acc0 = static_cast<uint64_t>(s);
+                s = (s >> 64) + acc1 + x1;
+                acc1 = static_cast<uint64_t>(s);
+                acc2 = static_cast<uint64_t>(acc2 + x2 + static_cast<uint64_t>(s >> 64));
+            }
+
+            for (std::size_t k = 0; (k < word_digits) && ((j + k) < r_num_digits); k++) {
+                res[j + k] = static_cast<natural_digit>(acc0 >> (k * natural_digit_bits));
+            }
+
+            acc0 = acc1;
+            acc1 = acc2;
+            acc2 = 0;
+        }
+    }
+
+    /*
+     * Multiply two large digit arrays.
+     *
+     * Note: It is OK for res and either src1, or src2, to be the same pointer.
+     */
+    inline auto __digit_array_multiply_large_m_n(natural_digit *res, std::size_t &res_num_digits,
+                                                 const natural_digit *src1, std::size_t src1_num_digits,
+                                                 const natural_digit *src2, std::size_t src2_num_digits) -> void {
+        std::size_t max_num_digits = (src1_num_digits > src2_num_digits) ? src1_num_digits : src2_num_digits;
+        std::size_t min_num_digits = (src1_num_digits > src2_num_digits) ? src2_num_digits : src1_num_digits;
+        std::size_t r_num_digits = src1_num_digits + src2_num_digits;
+
+        /*
+         * Very large operands are best handled using number-theoretic transforms.
+         */
+        if ((src1_num_digits >= __digit_array_ntt_threshold) && (src2_num_digits >= __digit_array_ntt_threshold)) {
+            __digit_array_multiply_ntt(res, src1, src1_num_digits, src2, src2_num_digits);
+            if (!res[r_num_digits - 1]) {
+                r_num_digits--;
+            }
+
+            res_num_digits = r_num_digits;
+            return;
+        }
+
+        /*
+         * Allocate all of our scratch space in one go.  If we're going to update in place
+         * then we also need space to build our result before we copy it back.
+         */
+        bool in_place = ((res == src1) || (res == src2));
+        std::size_t scratch_sz;
+        if (__digit_array_multiply_is_unbalanced(max_num_digits, min_num_digits)) {
+            scratch_sz = (2 * min_num_digits) + __digit_array_multiply_scratch_size(min_num_digits);
+        } else {
+            scratch_sz = __digit_array_multiply_scratch_size(max_num_digits);
+        }
+        if (in_place) {
+            scratch_sz += r_num_digits;
+        }
+
+        __digit_array_scratch scratch(scratch_sz);
+        natural_digit *r = res;
+        natural_digit *s = scratch.get();
+        if (in_place) {
+            r = s;
+            s = &s[r_num_digits];
+        }
+
+        __digit_array_multiply_fixed(r, src1, src1_num_digits, src2, src2_num_digits, s);
+
+        if (in_place) {
+            __digit_array_copy(res, r, r_num_digits);
+        }
+
+        /*
+         * We may not have needed the extra upper digit, so account for this.
+         */
+        if (!res[r_num_digits - 1]) {
+            r_num_digits--;
+        }
+
+        res_num_digits = r_num_digits;
+    }
+
+    /*
+     * Comba square a digit array.
+     *
+     * Every product a[i].a[j], where i != j, appears twice in a square, so we compute each
+     * of these cross products only once, double their sum with a single left shift, and then
+     * add in the squares of each digit.  This needs about half the digit multiplies of a
+     * general multiply.
+     *
+     * The result always has exactly 2 * src_num_digits digits.
+     *
+     * Note: res must not overlap src.
+     */
+    inline auto __digit_array_square_comba(natural_digit *res, const natural_digit *src, std::size_t src_num_digits) -> void {
+        std::size_t r_num_digits = 2 * src_num_digits;
+
+        /*
+         * Sum the cross products.
+         */
+        __digit_array_zero(res, r_num_digits);
+        for (std::size_t i = 0; i < src_num_digits; i++) {
+            auto a = static_cast<natural_double_digit>(src[i]);
+            natural_digit c = 0;
+            for (std::size_t j = i + 1; j < src_num_digits; j++) {
+                auto acc = a * static_cast<natural_double_digit>(src[j]);
+                acc += static_cast<natural_double_digit>(res[i + j]);
+                acc += static_cast<natural_double_digit>(c);
+                res[i + j] = static_cast<natural_digit>(acc);
+                c = static_cast<natural_digit>(acc >> natural_digit_bits);
+            }
+
+            res[i + src_num_digits] = c;
+        }
+
+        /*
+         * Double the cross products, then add the squares of each digit.
+         */
+        __digit_array_left_shift_fixed(res, res, r_num_digits, 1);
+
+        natural_digit c = 0;
+        for (std::size_t i = 0; i < src_num_digits; i++) {
+            auto a = static_cast<natural_double_digit>(src[i]);
+            auto sq = a * a;
+            auto acc = static_cast<natural_double_digit>(res[2 * i]) + static_cast<natural_double_digit>(static_cast<natural_digit>(sq));
+            acc += static_cast<natural_double_digit>(c);
+            res[2 * i] = static_cast<natural_digit>(acc);
+            acc = static_cast<natural_double_digit>(res[(2 * i) + 1]) + (sq >> natural_digit_bits) + (acc >> natural_digit_bits);
+            res[(2 * i) + 1] = static_cast<natural_digit>(acc);
+            c = static_cast<natural_digit>(acc >> natural_digit_bits);
+        }
+    }
+
+    /*
+     * Square a digit array.
+     */
+    inline auto __digit_array_square_m(natural_digit *res, std::size_t &res_num_digits,
+                                       const natural_digit *src, std::size_t src_num_digits) -> void {
+        /*
+         * If we're going to update in place then we actually have to copy the source array
+         * because we'll overwrite it.
+         */
+        auto src_1 = src;
+        __digit_array_scratch src_copy((res == src) ? src_num_digits : 0);
+        if (res == src) {
+            __digit_array_copy(src_copy.get(), src, src_num_digits);
+            src_1 = src_copy.get();
+        }
+
+        __digit_array_square_comba(res, src_1, src_num_digits);
+
+        /*
+         * We may not have needed the extra upper digit, so account for this.
+         */
+        std::size_t r_num_digits = 2 * src_num_digits;
+        if (!res[r_num_digits - 1]) {
+            r_num_digits--;
+        }
+
+        res_num_digits = r_num_digits;
+    }
+
+    inline auto __digit_array_square_fixed(natural_digit *res, const natural_digit *src, std::size_t src_num_digits,
+                                           natural_digit *scratch) -> void;
+
+    /*
+     * Karatsuba square a digit array.
+     *
+     * With a = a1.B + a0, the middle term of a^2 is 2.a1.a0 = a1^2 + a0^2 - (a0 - a1)^2, so
+     * we only need three half-sized squares.
+     *
+     * The result always has exactly 2 * src_num_digits digits.  The scratch space must have
+     * at least __digit_array_square_scratch_size(src_num_digits) digits.
+     *
+     * Note: res must not overlap src.
+     */
+    inline auto __digit_array_square_karatsuba(natural_digit *res, const natural_digit *src, std::size_t src_num_digits,
+                                               natural_digit *scratch) -> void {
+        std::size_t h = (src_num_digits + 1) / 2;
+        std::size_t a1_num_digits = src_num_digits - h;
+        std::size_t r_num_digits = 2 * src_num_digits;
+
+        /*
+         * Lay out our scratch space in the same way as for the Karatsuba multiply.
+         */
+        natural_digit *da = scratch;
+        natural_digit *t = scratch;
+        natural_digit *z1 = &scratch[(2 * h) + 1];
+        natural_digit *sub_scratch = &scratch[(4 * h) + 1];
+
+        __digit_array_abs_difference(da, src, h, &src[h], a1_num_digits);
+        __digit_array_square_fixed(z1, da, h, sub_scratch);
+
+        __digit_array_square_fixed(res, src, h, sub_scratch);
+        __digit_array_square_fixed(&res[2 * h], &src[h], a1_num_digits, sub_scratch);
+
+        /*
+         * Form the middle term, a0^2 + a1^2 - z1, which needs at most 2h + 1 digits.
+         */
+        __digit_array_copy(t, res, 2 * h);
+        t[2 * h] = 0;
+        __digit_array_add_in_place(t, (2 * h) + 1, &res[2 * h], r_num_digits - (2 * h));
+        __digit_array_subtract_in_place(t, (2 * h) + 1, z1, 2 * h);
+
+        __digit_array_add_at(res, r_num_digits, h, t, (2 * h) + 1);
+    }
+
+    /*
+     * Toom-Cook 3-way square a digit array.
+     *
+     * This works in the same way as the Toom-Cook 3-way multiply, but we only need to
+     * evaluate one polynomial, and all of the products are squares.
+     *
+     * Note: res must not overlap src.
+     */
+    inline auto __digit_array_square_toom3(natural_digit *res, const natural_digit *src, std::size_t src_num_digits,
+                                           natural_digit *scratch) -> void {
+        std::size_t k = (src_num_digits + 2) / 3;
+        std::size_t a2_num_digits = src_num_digits - (2 * k);
+        std::size_t r_num_digits = 2 * src_num_digits;
+        std::size_t e_num_digits = k + 1;
+        std::size_t w = 2 * e_num_digits;
+
+        /*
+         * Lay out our scratch space.
+         */
+        natural_digit *p1 = scratch;
+        natural_digit *pm1 = &scratch[e_num_digits];
+        natural_digit *pm2 = &scratch[2 * e_num_digits];
+        natural_digit *r1 = &scratch[3 * e_num_digits];
+        natural_digit *rm1 = &r1[w];
+        natural_digit *rm2 = &r1[2 * w];
+        natural_digit *t = &r1[3 * w];
+        natural_digit *sub_scratch = &r1[4 * w];
+
+        bool pm1_neg;
+        bool pm2_neg;
+        __digit_array_toom3_evaluate(p1, pm1, pm1_neg, pm2, pm2_neg, src, k, a2_num_digits);
+
+        __digit_array_square_fixed(r1, p1, e_num_digits, sub_scratch);
+        __digit_array_square_fixed(rm1, pm1, e_num_digits, sub_scratch);
+        __digit_array_square_fixed(rm2, pm2, e_num_digits, sub_scratch);
+
+        std::size_t rinf_num_digits = 2 * a2_num_digits;
+        __digit_array_square_fixed(res, src, k, sub_scratch);
+        __digit_array_zero(&res[2 * k], 2 * k);
+        __digit_array_square_fixed(&res[4 * k], &src[2 * k], a2_num_digits, sub_scratch);
+
+        __digit_array_toom3_interpolate(res, r_num_digits, k, rinf_num_digits, r1, rm1, false, rm2, false, t);
+    }
+
+    /*
+     * Toom-Cook 4-way square a digit array.
+     *
+     * This works in the same way as the Toom-Cook 4-way multiply, but we only need to
+     * evaluate one polynomial, and all of the products are squares.
+     *
+     * Note: res must not overlap src.
+     */
+    inline auto __digit_array_square_toom4(natural_digit *res, const natural_digit *src, std::size_t src_num_digits,
+                                           natural_digit *scratch) -> void {
+        std::size_t k = (src_num_digits + 3) / 4;
+        std::size_t a3_num_digits = src_num_digits - (3 * k);
+        std::size_t r_num_digits = 2 * src_num_digits;
+        std::size_t e_num_digits = k + 1;
+        std::size_t w = 2 * e_num_digits;
+
+        /*
+         * Lay out our scratch space.
+         */
+        natural_digit *p1 = scratch;
+        natural_digit *pm1 = &scratch[e_num_digits];
+        natural_digit *p2 = &scratch[2 * e_num_digits];
+        natural_digit *pm2 = &scratch[3 * e_num_digits];
+        natural_digit *ph = &scratch[4 * e_num_digits];
+        natural_digit *r1 = &scratch[5 * e_num_digits];
+        natural_digit *rm1 = &r1[w];
+        natural_digit *r2 = &r1[2 * w];
+        natural_digit *rm2 = &r1[3 * w];
+        natural_digit *rh = &r1[4 * w];
+        natural_digit *x = &r1[5 * w];
+        natural_digit *y = &r1[6 * w];
+        natural_digit *z = &r1[7 * w];
+        natural_digit *sub_scratch = &r1[8 * w];
+
+        bool pm1_neg;
+        bool pm2_neg;
+        __digit_array_toom4_evaluate(p1, pm1, pm1_neg, p2, pm2, pm2_neg, ph, src, k, a3_num_digits);
+
+        __digit_array_square_fixed(r1, p1, e_num_digits, sub_scratch);
+        __digit_array_square_fixed(rm1, pm1, e_num_digits, sub_scratch);
+        __digit_array_square_fixed(r2, p2, e_num_digits, sub_scratch);
+        __digit_array_square_fixed(rm2, pm2, e_num_digits, sub_scratch);
+        __digit_array_square_fixed(rh, ph, e_num_digits, sub_scratch);
+
+        std::size_t rinf_num_digits = 2 * a3_num_digits;
+        __digit_array_square_fixed(res, src, k, sub_scratch);
+        __digit_array_zero(&res[2 * k], 4 * k);
+        __digit_array_square_fixed(&res[6 * k], &src[3 * k], a3_num_digits, sub_scratch);
+
+        __digit_array_toom4_interpolate(res, r_num_digits, k, rinf_num_digits, r1, rm1, false, r2, rm2, false, rh, x, y, z);
+    }
+
+    /*
+     * Square a digit array, selecting the most appropriate algorithm for the operand size.
+     *
+     * The result always has exactly 2 * src_num_digits digits.  The scratch space must have
+     * at least __digit_array_square_scratch_size() digits for the operand size.
+     *
+     * Note: res must not overlap src.
+     */
+    inline auto __digit_array_square_fixed(natural_digit *res, const natural_digit *src, std::size_t src_num_digits,
+                                           natural_digit *scratch) -> void {
+        if (src_num_digits < __digit_array_square_karatsuba_threshold) {
+            __digit_array_square_comba(res, src, src_num_digits);
+            return;
+        }
+
+        if (src_num_digits >= __digit_array_square_toom4_threshold) {
+            __digit_array_square_toom4(res, src, src_num_digits, scratch);
+            return;
+        }
+
+        if (src_num_digits >= __digit_array_square_toom3_threshold) {
+            __digit_array_square_toom3(res, src, src_num_digits, scratch);
+            return;
+        }
+
+        __digit_array_square_karatsuba(res, src, src_num_digits, scratch);
+    }
+
+    /*
+     * Square a large digit array.
+     *
+     * Note: It is OK for res and src to be the same pointer.
+     */
+    inline auto __digit_array_square_large_m(natural_digit *res, std::size_t &res_num_digits,
+                                             const natural_digit *src, std::size_t src_num_digits) -> void {
+        std::size_t r_num_digits = 2 * src_num_digits;
+
+        if (src_num_digits >= __digit_array_square_ntt_threshold) {
+            __digit_array_multiply_ntt(res, src, src_num_digits, src, src_num_digits);
+        } else {
+            /*
+             * Allocate all of our scratch space in one go.  If we're going to update in
+             * place then we also need space to build our result before we copy it back.
+             */
+            bool in_place = (res == src);
+            std::size_t scratch_sz = __digit_array_square_scratch_size(src_num_digits);
+            if (in_place) {
+                scratch_sz += r_num_digits;
+            }
+
+            __digit_array_scratch scratch(scratch_sz);
+            natural_digit *r = res;
+            natural_digit *s = scratch.get();
+            if (in_place) {
+                r = s;
+                s = &s[r_num_digits];
+            }
+
+            __digit_array_square_fixed(r, src, src_num_digits, s);
+
+            if (in_place) {
+                __digit_array_copy(res, r, r_num_digits);
+            }
+        }
+
+        /*
+         * We may not have needed the extra upper digit, so account for this.
+         */
+        if (!res[r_num_digits - 1]) {
+            r_num_digits--;
+        }
+
+        res_num_digits = r_num_digits;
+    }
+
+    /*
+     * Divide/modulus a single digit by another single digit.
+     */
+    inline auto __digit_array_divide_modulus_1_1(natural_digit *quotient, std::size_t &quotient_num_digits,
+                                                 natural_digit *remainder, std::size_t &remainder_num_digits,
+                                                 const natural_digit *src1,
+                                                 const natural_digit *src2) -> void {
+        auto v1 = src1[0];
+        auto v2 = src2[0];
+
+        auto q = v1 / v2;
+        auto r = v1 % v2;
+
+        std::size_t r_num_digits = 0;
+
+        if (r) {
+            remainder[0] = static_cast<natural_digit>(r);
+            r_num_digits = 1;
+        }
+
+        remainder_num_digits = r_num_digits;
+
+        std::size_t q_num_digits = 0;
+        if (q) {
+            quotient[0] = static_cast<natural_digit>(q);
+            q_num_digits = 1;
+        }
+
+        quotient_num_digits = q_num_digits;
+    }
+
+    /*
+     * Count the number of leading zero bits in a digit.  The digit must not be zero.
+     */
+    inline auto __digit_array_count_leading_zeros(natural_digit d) -> unsigned int {
+        /*
+         * As with __digit_array_size_bits(), we must compensate for digits that are smaller
+         * than the type used by the builtin.
+         */
+        if (sizeof(natural_digit) <= sizeof(int)) {
+            auto clz = static_cast<unsigned int>(__builtin_clz(static_cast<unsigned int>(d)));
+            return clz - static_cast<unsigned int>(8 * (sizeof(int) - sizeof(natural_digit)));
+        }
+
+        return static_cast<unsigned int>(__builtin_clzll(static_cast<unsigned long long>(d)));
+    }
+
+    /*
+     * Count the number of trailing zero bits in a non-zero digit.
+     */
+    inline auto __digit_array_count_trailing_zeros(natural_digit d) -> unsigned int {
+        if (sizeof(natural_digit) <= sizeof(int)) {
+            return static_cast<unsigned int>(__builtin_ctz(static_cast<unsigned int>(d)));
+        }
+
+        return static_cast<unsigned int>(__builtin_ctzll(static_cast<unsigned long long>(d)));
+    }
+
+    /*
+     * Compute the reciprocal of a normalized digit (one with its top bit set), for use
+     * with __digit_array_divide_2_1().
+     *
+     * The reciprocal is floor((B^2 - 1) / d) - B, where B is the digit base.  As d is
+     * normalized this always fits in a single digit.
+     */
+    inline auto __digit_array_reciprocal_2_1(natural_digit d) -> natural_digit {
+        return static_cast<natural_digit>(static_cast<natural_double_digit>(-1) / static_cast<natural_double_digit>(d));
+    }
+
+    /*
+     * Divide a 2 digit number, [u1, u0], by a normalized single digit, d, using d's
+     * precomputed reciprocal.
+     *
+     * This is Moller and Granlund's algorithm ("Improved division by invariant integers").
+     * Rather than using a hardware divide instruction, which is very slow, we estimate the
+     * quotient with a multiply by the reciprocal, and then correct it with at most two
+     * adjustments, the second of which is very rarely needed.
+     *
+     * u1 must be less than d.
+     */
+    inline auto __digit_array_divide_2_1(natural_digit &quotient, natural_digit &remainder,
+                                         natural_digit u1, natural_digit u0,
+                                         natural_digit d, natural_digit reciprocal) -> void {
+        auto p = static_cast<natural_double_digit>(reciprocal) * static_cast<natural_double_digit>(u1);
+        p += (static_cast<natural_double_digit>(u1) << natural_digit_bits) + static_cast<natural_double_digit>(u0);
+        auto q1 = static_cast<natural_digit>((p >> natural_digit_bits) + 1);
+        auto q0 = static_cast<natural_digit>(p);
+
+        /*
+         * Whether our first adjustment is needed is essentially unpredictable, so we use a
+         * mask rather than a branch.
+         */
+        auto r = static_cast<natural_digit>(u0 - static_cast<natural_digit>(q1 * d));
+        auto mask = static_cast<natural_digit>(-static_cast<natural_digit>(r > q0));
+        q1 = static_cast<natural_digit>(q1 + mask);
+        r = static_cast<natural_digit>(r + (mask & d));
+
+        if (C8_UNLIKELY(r >= d)) {
+            q1++;
+            r = static_cast<natural_digit>(r - d);
+        }
+
+        quotient = q1;
+        remainder = r;
+    }
+
+    /*
+     * Divide/modulus a digit array by a single digit.
+     *
+     * We normalize the divisor so that we can divide using its reciprocal, and shift each
+     * digit of the dividend to match as we go.  The quotient is unchanged by this, but the
+     * remainder needs to be shifted back again at the end.
+     *
+     * Note: It is OK for res and src1 to be the same pointer.
+     */
+    inline auto __digit_array_divide_modulus_m_1(natural_digit *quotient, std::size_t &quotient_num_digits,
+                                                 natural_digit *remainder, std::size_t &remainder_num_digits,
+                                                 const natural_digit *src1, std::size_t src1_num_digits,
+                                                 const natural_digit *src2) -> void {
+        auto normalize_shift = __digit_array_count_leading_zeros(src2[0]);
+        auto v = static_cast<natural_digit>(src2[0] << normalize_shift);
+        auto v_reciprocal = __digit_array_reciprocal_2_1(v);
+
+        /*
+         * Long divide.  Start with the most significant digit, whose top bits are shifted
+         * out to form our initial remainder.
+         */
+        std::size_t i = src1_num_digits - 1;
+        natural_digit r = 0;
+        natural_digit q;
+
+        if (normalize_shift) {
+            auto unshift = natural_digit_bits - normalize_shift;
+            r = static_cast<natural_digit>(src1[i] >> unshift);
+
+            while (i) {
+                auto d = static_cast<natural_digit>((src1[i] << normalize_shift) | (src1[i - 1] >> unshift));
+                __digit_array_divide_2_1(q, r, r, d, v, v_reciprocal);
+                quotient[i--] = q;
+            }
+
+            __digit_array_divide_2_1(q, r, r, static_cast<natural_digit>(src1[0] << normalize_shift), v, v_reciprocal);
+            quotient[0] = q;
+        } else {
+            while (true) {
+                __digit_array_divide_2_1(q, r, r, src1[i], v, v_reciprocal);
+                quotient[i] = q;
+                if (!i) {
+                    break;
+                }
+
+                i--;
+            }
+        }
+
+        std::size_t q_num_digits = src1_num_digits;
+        if (quotient[q_num_digits - 1] == 0) {
+            q_num_digits--;
+        }
+
+        quotient_num_digits = q_num_digits;
+
+        r = static_cast<natural_digit>(r >> normalize_shift);
+
+        std::size_t r_num_digits = 0;
+        if (r) {
+            remainder[0] = r;
+            r_num_digits = 1;
+        }
+
+        remainder_num_digits = r_num_digits;
+    }
+
+    /*
+     * Subtract a shifted digit array from another.
+     *
+     * Returns true if the subtraction underflows, false if it does not.
+     *
+     * Unlike the more generic subtract operation above, this one is specifically only for use with
+     * the divide/modulus operation.  This handles underflowing subtraction.
+     */
+    inline auto __digit_array_subtract_m_n_shifted(natural_digit *res, std::size_t res_num_digits,
+                                                   const natural_digit *src2, std::size_t src2_num_digits,
+                                                   std::size_t src2_shift) -> bool {
+        /*
+         * Subtract the first digit.
+         */
+        auto acc = static_cast<natural_double_digit>(res[src2_shift]) - static_cast<natural_double_digit>(src2[0]);
+        auto acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
+        res[src2_shift] = static_cast<natural_digit>(acc);
+
+        /*
+         * Subtract the remaining digits.
+         */
+        std::size_t r_num_digits = src2_shift + 1;
+        do {
+            acc = static_cast<natural_double_digit>(res[r_num_digits]) - static_cast<natural_double_digit>(src2[r_num_digits - src2_shift]);
+            acc -= static_cast<natural_double_digit>(acc_c & 1);
+            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
+            res[r_num_digits++] = static_cast<natural_digit>(acc);
+        } while (r_num_digits < (src2_num_digits + src2_shift));
+
+        /*
+         * Subtract any carries.
+         */
+        while (r_num_digits < res_num_digits) {
+            acc = static_cast<natural_double_digit>(res[r_num_digits]);
+            acc -= static_cast<natural_double_digit>(acc_c & 1);
+            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
+            res[r_num_digits++] = static_cast<natural_digit>(acc);
+        }
+
+        res[r_num_digits] = acc_c;
+        return acc_c ? true : false;
+    }
+
+    /*
+     * Subtract a multiplied and shifted digit array from another.
+     *
+     * Returns true if the subtraction underflows, false if it does not.
+     */
+    inline auto __digit_array_subtract_multiplied_m_n_shifted(natural_digit *res, std::size_t res_num_digits,
+                                                              const natural_digit *src2, std::size_t src2_num_digits,
+                                                              natural_digit src2_multiplier, std::size_t src2_shift) -> bool {
+        auto acc_c = __digit_array_submul_1(&res[src2_shift], src2, src2_num_digits, src2_multiplier);
+
+        /*
+         * Subtract any remaining borrow.
+         */
+        std::size_t r_num_digits = src2_num_digits + src2_shift;
+        while (r_num_digits < res_num_digits) {
+            auto r = res[r_num_digits];
+            res[r_num_digits++] = static_cast<natural_digit>(r - acc_c);
+            acc_c = (r < acc_c) ? 1 : 0;
+        }
+
+        /*
+         * Record any underflow as a borrow from the digit above, so that adding back the
+         * divisor can clear it.
+         */
+        res[r_num_digits] = acc_c ? static_cast<natural_digit>(-1) : 0;
+        return acc_c ? true : false;
+    }
+
+    /*
+     * Add a shifted digit array to another.
+     *
+     * Returns true if the addition has not yet cleared an underflow from a previous subtraction,
+     * false if it has.
+     *
+     * Unlike the more generic add operation above, this one is specifically only for use with
+     * the divide/modulus operation.  This handles compensating for underflowing subtraction.
+     */
+    inline auto __digit_array_add_m_n_shifted(natural_digit *res, std::size_t res_num_digits,
+                                              const natural_digit *src2, std::size_t src2_num_digits,
+                                              std::size_t src2_shift) -> bool {
+        /*
+         * Add the first digits together.
+         */
+        auto acc = static_cast<natural_double_digit>(res[src2_shift]) + static_cast<natural_double_digit>(src2[0]);
+        auto acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
+        res[src2_shift] = static_cast<natural_digit>(acc);
+
+        std::size_t r_num_digits = src2_shift + 1;
+        do {
+            acc = static_cast<natural_double_digit>(res[r_num_digits]) + static_cast<natural_double_digit>(src2[r_num_digits - src2_shift]);
+            acc += static_cast<natural_double_digit>(acc_c);
+            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
+            res[r_num_digits++] = static_cast<natural_digit>(acc);
+        } while (r_num_digits < (src2_num_digits + src2_shift));
+
+        /*
+         * Add the remaining digits and any carries.
+         */
+        while (r_num_digits < res_num_digits) {
+            acc = static_cast<natural_double_digit>(res[r_num_digits]);
+            acc += static_cast<natural_double_digit>(acc_c);
+            acc_c = static_cast<natural_digit>(acc >> natural_digit_bits);
+            res[r_num_digits++] = static_cast<natural_digit>(acc);
+        }
+
+        /*
+         * If we had a borrow from an earlier subtract then account for that now.
+         */
+        acc_c = static_cast<natural_digit>(acc_c + res[r_num_digits]);
+        res[r_num_digits] = acc_c;
+        return acc_c ? true : false;
+    }
+
+    /*
+     * Divide a digit array by a normalized one.
+     *
+     * The divisor must already have been shifted left by normalize_shift bits, so that its
+     * most significant digit has its top bit set.  We shift the dividend to match, and shift
+     * the remainder back again at the end.
+     *
+     * This function requires quite a lot of temporary digit arrays and so can
+     * consume quite large amounts of stack space.
+     *
+     * Note: It is OK for the quotient or remainder to be the same pointer as src1.
+     */
+    inline auto __digit_array_divide_modulus_normalized(natural_digit *quotient, std::size_t &quotient_num_digits,
+                                                        natural_digit *remainder, std::size_t &remainder_num_digits,
+                                                        const natural_digit *src1, std::size_t src1_num_digits,
+                                                        const natural_digit *divisor, std::size_t divisor_num_digits,
+                                                        unsigned int normalize_shift) -> void {
+        /*
+         * Is our result going to be zero?  If yes then take a shortcut.  We must check this
+         * before normalizing, as the shift can grow our dividend to the same number of digits
+         * as the divisor even though the dividend is still smaller.
+         */
+        if (divisor_num_digits > src1_num_digits) {
+            quotient_num_digits = 0;
+            remainder_num_digits = src1_num_digits;
+            __digit_array_copy(remainder, src1, src1_num_digits);
+            return;
+        }
+
+        /*
+         * Our dividend may end up one digit larger after the normalization and we want one
+         * extra beyond that for handling any overflows.
+         */
+        __digit_array_scratch dividend_scratch(src1_num_digits + 2);
+        natural_digit *dividend = dividend_scratch.get();
+        std::size_t dividend_num_digits;
+        __digit_array_left_shift_m(dividend, dividend_num_digits, src1, src1_num_digits, 0, normalize_shift);
+        dividend[dividend_num_digits] = 0;
+
+        std::size_t next_res_digit = dividend_num_digits - divisor_num_digits;
+
+        /*
+         * All of our quotient estimates are done with the most significant digit of our divisor.
+         */
+        auto divisor_most_sig_digit = divisor[divisor_num_digits - 1];
+        auto divisor_reciprocal = __digit_array_reciprocal_2_1(divisor_most_sig_digit);
+
+        /*
+         * Our first estimate is trivial - the digit will either be 0 or 1.  We handle
+         * this as a special case.
+         */
+        natural_digit q = 0;
+        if (dividend[dividend_num_digits - 1] >= divisor_most_sig_digit) {
+            /*
+             * There's a good chance that our digit is a 1.  Try subtracting the effect of
+             * a 1 and see if we underflow.  If we do then add the effect of the 1 back.
+             */
+            q = 1;
+            auto underflow = __digit_array_subtract_m_n_shifted(dividend, dividend_num_digits,
+                                                                divisor, divisor_num_digits, next_res_digit);
+            if (C8_UNLIKELY(underflow)) {
+                __digit_array_add_m_n_shifted(dividend, dividend_num_digits,
+                                              divisor, divisor_num_digits, next_res_digit);
+                q = 0;
+            }
+        }
+
+        quotient[next_res_digit] = q;
+
+        /*
+         * Now we run our "long divide" algorithm over the remaining digits.
+         */
+        while (next_res_digit--) {
+            auto d_hi = dividend[dividend_num_digits - 1];
+
+            /*
+             * Is the upper digit of our dividend the same as the first digit our of divisor?  If
+             * it is then we know the result is, at most, the largest possible digit value,
+             * because we've already handled all situations in which the result would be larger.
+             */
+            if (C8_UNLIKELY(d_hi == divisor_most_sig_digit)) {
+                q = static_cast<natural_digit>(-1);
+            } else {
+                /*
+                 * Estimate the next digit of the result by dividing the most significant two
+                 * digits of our dividend by the most significant digit of our divisor.  We
+                 * already know that d_hi is less than the divisor digit.
+                 */
+                natural_digit r;
+                __digit_array_divide_2_1(q, r, d_hi, dividend[dividend_num_digits - 2],
+                                         divisor_most_sig_digit, divisor_reciprocal);
+            }
+
+            /*
+             * Did we estimate that there was a non-zero digit?  If yes, then we want to refine
+             * the estimate and subtract it from our dividend, but if we estimated zero then
              * we do nothing to our dividend.
              */
-            if (C8_LIKELY(q)) {
-                /*
-                 * We now have an estimate of our next digit, but it's possible that our estimate
-                 * may be anything up to 2 larger than the actual value.  As a way to think about this,
-                 * consider a decimal divide of 4500 by 59.  If we divide "45" by "5" we estimate that
-                 * the next result digit is 9, but actually it's 7.  The vast majority of times our
-                 * estimate will be correct, however.  In cases where there's an underflow after we do
-                 * our trial subtraction we compensate with small additions, reducing our estimate
-                 * accordingly.
-                 */
-                auto underflow1 = __digit_array_subtract_multiplied_m_n_shifted(dividend, dividend_num_digits,
-                                                                                divisor, divisor_num_digits, q, next_res_digit);
-                if (C8_UNLIKELY(underflow1)) {
-                    auto underflow2 = __digit_array_add_m_n_shifted(dividend, dividend_num_digits,
-                                                                    divisor, divisor_num_digits, next_res_digit);
-                    q--;
-                    if (C8_UNLIKELY(underflow2)) {
-                        __digit_array_add_m_n_shifted(dividend, dividend_num_digits,
-                                                      divisor, divisor_num_digits, next_res_digit);
-                        q--;
-                    }
-                }
+            if (C8_LIKELY(q)) {
+                /*
+                 * We now have an estimate of our next digit, but it's possible that our estimate
+                 * may be anything up to 2 larger than the actual value.  As a way to think about this,
+                 * consider a decimal divide of 4500 by 59.  If we divide "45" by "5" we estimate that
+                 * the next result digit is 9, but actually it's 7.  The vast majority of times our
+                 * estimate will be correct, however.  In cases where there's an underflow after we do
+                 * our trial subtraction we compensate with small additions, reducing our estimate
+                 * accordingly.
+                 */
+                auto underflow1 = __digit_array_subtract_multiplied_m_n_shifted(dividend, dividend_num_digits,
+                                                                                divisor, divisor_num_digits, q, next_res_digit);
+                if (C8_UNLIKELY(underflow1)) {
+                    auto underflow2 = __digit_array_add_m_n_shifted(dividend, dividend_num_digits,
+                                                                    divisor, divisor_num_digits, next_res_digit);
+                    q--;
+                    if (C8_UNLIKELY(underflow2)) {
+                        __digit_array_add_m_n_shifted(dividend, dividend_num_digits,
+                                                      divisor, divisor_num_digits, next_res_digit);
+                        q--;
+                    }
+                }
+            }
+
+            quotient[next_res_digit] = q;
+            dividend_num_digits--;
+        }
+
+        /*
+         * Calculate our resulting digits.
+         */
+        std::size_t q_num_digits = src1_num_digits - divisor_num_digits + 1;
+        if (!quotient[q_num_digits - 1]) {
+            q_num_digits--;
+        }
+
+        quotient_num_digits = q_num_digits;
+
+        while (dividend_num_digits) {
+            if (dividend[dividend_num_digits - 1]) {
+                break;
+            }
+
+            dividend_num_digits--;
+        }
+
+        std::size_t r_num_digits = 0;
+        if (dividend_num_digits) {
+             __digit_array_right_shift_m(remainder, r_num_digits, dividend, dividend_num_digits, 0, normalize_shift);
+        }
+
+        remainder_num_digits = r_num_digits;
+    }
+
+    /*
+     * Divide two digit arrays.
+     *
+     * This function requires quite a lot of temporary digit arrays and so can
+     * consume quite large amounts of stack space.
+     */
+    inline auto __digit_array_divide_modulus_m_n(natural_digit *quotient, std::size_t &quotient_num_digits,
+                                                 natural_digit *remainder, std::size_t &remainder_num_digits,
+                                                 const natural_digit *src1, std::size_t src1_num_digits,
+                                                 const natural_digit *src2, std::size_t src2_num_digits) -> void {
+        /*
+         * Normalize the divisor.  We want our divisor to be aligned such that it's most
+         * significant digit has its top bit set.  This may seem a little odd, but we want to
+         * ensure that any quotient estimates are as accurate as possible.
+         */
+        auto divisor_bits = __digit_array_size_bits(src2, src2_num_digits);
+        auto divisor_digit_bits = divisor_bits & (natural_digit_bits - 1);
+        unsigned int normalize_shift = static_cast<unsigned int>((natural_digit_bits - divisor_digit_bits) & (natural_digit_bits - 1));
+
+        /*
+         * By definition when we normalize the divisor it keeps the same number of digits.
+         */
+        __digit_array_scratch divisor_scratch(src2_num_digits);
+        natural_digit *divisor = divisor_scratch.get();
+        std::size_t divisor_num_digits;
+        __digit_array_left_shift_m(divisor, divisor_num_digits, src2, src2_num_digits, 0, normalize_shift);
+
+        __digit_array_divide_modulus_normalized(quotient, quotient_num_digits, remainder, remainder_num_digits,
+                                                src1, src1_num_digits, divisor, divisor_num_digits, normalize_shift);
+    }
+
+    /*
+     * Divide a 2n digit array by an n digit one, using long division, as the base case of
+     * our Burnikel-Ziegler recursion.
+     *
+     * src1 must be less than src2.B^n, and src2 must be normalized (its most significant
+     * digit has its top bit set).  Both the quotient and remainder always have exactly n
+     * digits.
+     */
+    inline auto __digit_array_divide_bz_base(natural_digit *quotient, natural_digit *remainder,
+                                             const natural_digit *src1, const natural_digit *src2, std::size_t n) -> void {
+        std::size_t src1_num_digits = 2 * n;
+        while (src1_num_digits && !src1[src1_num_digits - 1]) {
+            src1_num_digits--;
+        }
+
+        std::size_t q_num_digits = 0;
+        std::size_t r_num_digits = src1_num_digits;
+        if (src1_num_digits < n) {
+            __digit_array_copy(remainder, src1, src1_num_digits);
+        } else {
+            __digit_array_scratch q(n + 1);
+            __digit_array_divide_modulus_m_n(q.get(), q_num_digits, remainder, r_num_digits, src1, src1_num_digits, src2, n);
+            __digit_array_copy(quotient, q.get(), q_num_digits);
+        }
+
+        __digit_array_zero(&quotient[q_num_digits], n - q_num_digits);
+        __digit_array_zero(&remainder[r_num_digits], n - r_num_digits);
+    }
+
+    inline auto __digit_array_divide_bz_2n_1n(natural_digit *quotient, natural_digit *remainder,
+                                              const natural_digit *src1, const natural_digit *src2, std::size_t n,
+                                              natural_digit *scratch, natural_digit *mul_scratch) -> void;
+
+    /*
+     * Divide a 3h digit array, a = [a1, a2, a3], by a 2h digit one, b = [b1, b2], for
+     * Burnikel-Ziegler division.
+     *
+     * We estimate the quotient by dividing [a1, a2] by b1, recursively, and then correct the
+     * estimate by subtracting the product of it and b2.  As b is normalized the estimate is
+     * never more than 2 too large.
+     *
+     * src1 must be less than src2.B^h, and src2 must be normalized.  The quotient always
+     * has exactly h digits, and the remainder exactly 2h.
+     */
+    inline auto __digit_array_divide_bz_3n_2n(natural_digit *quotient, natural_digit *remainder,
+                                              const natural_digit *src1, const natural_digit *src2, std::size_t h,
+                                              natural_digit *scratch, natural_digit *mul_scratch) -> void {
+        const natural_digit *a2 = &src1[h];
+        const natural_digit *a1 = &src1[2 * h];
+        const natural_digit *b2 = src2;
+        const natural_digit *b1 = &src2[h];
+
+        /*
+         * Lay out our scratch space.  r needs one extra digit because our intermediate
+         * remainder may briefly be larger than b.
+         */
+        natural_digit *r = scratch;
+        natural_digit *d = &scratch[(2 * h) + 1];
+        natural_digit *sub_scratch = &d[2 * h];
+
+        /*
+         * Estimate the quotient, q, and compute c = [a1, a2] - q.b1 into the upper part of r.
+         * If a1 is not less than b1 then, as a < b.B^h, a1 must equal b1, and our estimate
+         * is B^h - 1, giving c = a2 + b1.
+         */
+        if (__digit_array_compare_lt(a1, h, b1, h)) {
+            __digit_array_divide_bz_2n_1n(quotient, &r[h], a2, b1, h, sub_scratch, mul_scratch);
+            r[2 * h] = 0;
+        } else {
+            for (std::size_t i = 0; i < h; i++) {
+                quotient[i] = static_cast<natural_digit>(-1);
+            }
+
+            __digit_array_copy(&r[h], a2, h);
+            r[2 * h] = 0;
+            __digit_array_add_in_place(&r[h], h + 1, b1, h);
+        }
+
+        /*
+         * r = c.B^h + a3 - q.b2.  If this underflows then our estimate was too large, so we
+         * add b back until the borrow clears.
+         */
+        __digit_array_copy(r, src1, h);
+        __digit_array_multiply_fixed(d, quotient, h, b2, h, mul_scratch);
+        natural_digit borrow = __digit_array_subtract_in_place(r, (2 * h) + 1, d, 2 * h);
+        while (borrow) {
+            natural_digit one = 1;
+            __digit_array_subtract_in_place(quotient, h, &one, 1);
+            if (__digit_array_add_in_place(r, (2 * h) + 1, src2, 2 * h)) {
+                borrow = 0;
+            }
+        }
+
+        __digit_array_copy(remainder, r, 2 * h);
+    }
+
+    /*
+     * Divide a 2n digit array by an n digit one using Burnikel-Ziegler recursive division.
+     *
+     * We treat the dividend as 4 half-sized digits, and the divisor as 2, and then divide
+     * using two 3-by-2 digit divides, just as we would in long division.  Each of those
+     * needs one recursive 2-by-1 digit divide, and one multiply.  If n is odd, or small, we
+     * use long division instead.
+     *
+     * src1 must be less than src2.B^n, and src2 must be normalized.  Both the quotient and
+     * remainder always have exactly n digits.  The scratch space must have at least
+     * __digit_array_divide_bz_scratch_size(n) digits, and mul_scratch must have at least
+     * __digit_array_multiply_scratch_size(n / 2) digits.
+     */
+    inline auto __digit_array_divide_bz_2n_1n(natural_digit *quotient, natural_digit *remainder,
+                                              const natural_digit *src1, const natural_digit *src2, std::size_t n,
+                                              natural_digit *scratch, natural_digit *mul_scratch) -> void {
+        if ((n & 1) || (n < __digit_array_bz_threshold)) {
+            __digit_array_divide_bz_base(quotient, remainder, src1, src2, n);
+            return;
+        }
+
+        std::size_t h = n / 2;
+
+        /*
+         * Our second divide operates on [r1, a4], where r1 is the remainder from the first,
+         * so we build that in our scratch space as we go.
+         */
+        natural_digit *u = scratch;
+        natural_digit *sub_scratch = &scratch[3 * h];
+
+        __digit_array_divide_bz_3n_2n(&quotient[h], &u[h], &src1[h], src2, h, sub_scratch, mul_scratch);
+        __digit_array_copy(u, src1, h);
+        __digit_array_divide_bz_3n_2n(quotient, remainder, u, src2, h, sub_scratch, mul_scratch);
+    }
+
+    /*
+     * Return the number of scratch digits required by a Burnikel-Ziegler 2n by n digit divide.
+     */
+    inline auto __digit_array_divide_bz_scratch_size(std::size_t n) -> std::size_t {
+        /*
+         * Each level needs 3h digits for the 2-by-1 divide, plus 4h + 1 for the 3-by-2
+         * divide, where h is half of n.
+         */
+        std::size_t sz = 0;
+        while (!(n & 1) && (n >= __digit_array_bz_threshold)) {
+            std::size_t h = n / 2;
+            sz += (7 * h) + 1;
+            n = h;
+        }
+
+        return sz;
+    }
+
+    /*
+     * Divide two digit arrays using Burnikel-Ziegler recursive division.
+     *
+     * We choose a block size, n, that is at least as large as the divisor, but that can be
+     * halved repeatedly until it's below our threshold.  We then shift both numbers left so
+     * that the divisor fills exactly n digits and is normalized, and run a long division
+     * over the dividend, one n digit block at a time.  Each of those block divides is a
+     * recursive 2n by n digit divide.
+     *
+     * Note: It is OK for the quotient or remainder to be the same pointer as either src1 or src2.
+     */
+    inline auto __digit_array_divide_modulus_bz(natural_digit *quotient, std::size_t &quotient_num_digits,
+                                                natural_digit *remainder, std::size_t &remainder_num_digits,
+                                                const natural_digit *src1, std::size_t src1_num_digits,
+                                                const natural_digit *src2, std::size_t src2_num_digits) -> void {
+        /*
+         * Choose our block size.  m is the number of times we'll be able to halve it.
+         */
+        std::size_t m = 1;
+        while ((m * __digit_array_bz_threshold) <= src2_num_digits) {
+            m <<= 1;
+        }
+
+        std::size_t j = (src2_num_digits + m - 1) / m;
+        std::size_t n = j * m;
+
+        /*
+         * Work out how far we need to shift so that the divisor is normalized and fills n
+         * digits.  We then need enough blocks to hold the shifted dividend with its top bit
+         * clear, so that the top block is less than the divisor.
+         */
+        auto divisor_bits = __digit_array_size_bits(src2, src2_num_digits);
+        std::size_t shift_digits = n - src2_num_digits;
+        auto shift_bits = static_cast<std::size_t>((natural_digit_bits - (divisor_bits & (natural_digit_bits - 1))) & (natural_digit_bits - 1));
+
+        auto dividend_bits = __digit_array_size_bits(src1, src1_num_digits) + (shift_digits * natural_digit_bits) + shift_bits;
+        std::size_t block_bits = n * natural_digit_bits;
+        std::size_t t = (dividend_bits + block_bits) / block_bits;
+        if (t < 2) {
+            t = 2;
+        }
+
+        /*
+         * Allocate all of our space in one go.
+         */
+        std::size_t q_num_digits = (t - 1) * n;
+        std::size_t sz = (t * n) + n + q_num_digits + (3 * n)
+                         + __digit_array_divide_bz_scratch_size(n) + __digit_array_multiply_scratch_size(n / 2);
+        __digit_array_scratch buf(sz);
+        natural_digit *a = buf.get();
+        natural_digit *b = &a[t * n];
+        natural_digit *q = &b[n];
+        natural_digit *z = &q[q_num_digits];
+        natural_digit *r = &z[2 * n];
+        natural_digit *scratch = &r[n];
+        natural_digit *mul_scratch = &scratch[__digit_array_divide_bz_scratch_size(n)];
+
+        std::size_t a_num_digits;
+        __digit_array_left_shift_m(a, a_num_digits, src1, src1_num_digits, shift_digits, shift_bits);
+        __digit_array_zero(&a[a_num_digits], (t * n) - a_num_digits);
+
+        std::size_t b_num_digits;
+        __digit_array_left_shift_m(b, b_num_digits, src2, src2_num_digits, shift_digits, shift_bits);
+
+        /*
+         * Long division, one block at a time.
+         */
+        __digit_array_copy(z, &a[(t - 2) * n], 2 * n);
+        std::size_t i = t - 1;
+        while (i--) {
+            __digit_array_divide_bz_2n_1n(&q[i * n], r, z, b, n, scratch, mul_scratch);
+            if (i) {
+                __digit_array_copy(&z[n], r, n);
+                __digit_array_copy(z, &a[(i - 1) * n], n);
+            }
+        }
+
+        /*
+         * Calculate our resulting digits.
+         */
+        while (q_num_digits && !q[q_num_digits - 1]) {
+            q_num_digits--;
+        }
+
+        __digit_array_copy(quotient, q, q_num_digits);
+        quotient_num_digits = q_num_digits;
+
+        std::size_t r_num_digits = n;
+        while (r_num_digits && !r[r_num_digits - 1]) {
+            r_num_digits--;
+        }
+
+        if (r_num_digits) {
+            __digit_array_right_shift_m(remainder, r_num_digits, r, r_num_digits, shift_digits, shift_bits);
+        }
+
+        remainder_num_digits = r_num_digits;
+    }
+
+    /*
+     * Divide a digit array by a normalized one, using the divisor's reciprocal.
+     *
+     * The divisor, src2, has n digits, and must already have been shifted left by
+     * normalize_shift bits so that its most significant digit has its top bit set.  The
+     * reciprocal must be floor(B^2n / src2), and so has n + 1 digits.
+     *
+     * We run a long division over the shifted dividend, one n digit block at a time, but
+     * rather than estimating one digit of the quotient at a time we estimate an entire block
+     * by multiplying the top of our partial remainder by the reciprocal (Barrett's method).
+     * The estimate is never more than 2 too small, so each block costs two multiplies and
+     * a couple of subtractions.
+     *
+     * Note: It is OK for the quotient or remainder to be the same pointer as src1.
+     */
+    inline auto __digit_array_divide_modulus_reciprocal(natural_digit *quotient, std::size_t &quotient_num_digits,
+                                                        natural_digit *remainder, std::size_t &remainder_num_digits,
+                                                        const natural_digit *src1, std::size_t src1_num_digits,
+                                                        const natural_digit *src2, std::size_t n,
+                                                        const natural_digit *reciprocal, unsigned int normalize_shift) -> void {
+        /*
+         * Is our result going to be zero?  If yes then take a shortcut.
+         */
+        if (src1_num_digits < n) {
+            quotient_num_digits = 0;
+            remainder_num_digits = src1_num_digits;
+            __digit_array_copy(remainder, src1, src1_num_digits);
+            return;
+        }
+
+        /*
+         * Allocate all of our space in one go.  Our shifted dividend may be one digit larger
+         * than the original, and is split into t blocks, the top one of which may be partial.
+         */
+        std::size_t max_t = (src1_num_digits + n) / n;
+        std::size_t sz = (2 * max_t * n) + (2 * n) + ((2 * n) + 2) + __digit_array_multiply_scratch_size(n + 1);
+        __digit_array_scratch buf(sz);
+        natural_digit *a = buf.get();
+        natural_digit *q = &a[max_t * n];
+        natural_digit *x = &q[max_t * n];
+        natural_digit *p = &x[2 * n];
+        natural_digit *mul_scratch = &p[(2 * n) + 2];
+
+        std::size_t a_num_digits;
+        __digit_array_left_shift_m(a, a_num_digits, src1, src1_num_digits, 0, normalize_shift);
+        std::size_t t = (a_num_digits + n - 1) / n;
+        __digit_array_zero(&a[a_num_digits], (t * n) - a_num_digits);
+        std::size_t q_num_digits = ((t - 1) * n) + 1;
+
+        /*
+         * Our top block is less than B^n, and the divisor is normalized, so the top quotient
+         * digit is either 0 or 1.
+         */
+        std::size_t i = t - 1;
+        __digit_array_copy(&x[n], &a[i * n], n);
+        q[i * n] = 1;
+        if (__digit_array_subtract_in_place(&x[n], n, src2, n)) {
+            __digit_array_add_in_place(&x[n], n, src2, n);
+            q[i * n] = 0;
+        }
+
+        /*
+         * Long division, one block at a time.  Each time around, x = [a block, remainder], and
+         * our estimate is the top n + 1 digits of x, multiplied by the reciprocal, and divided
+         * by B^(n + 1).
+         */
+        while (i--) {
+            natural_digit *qi = &q[i * n];
+            __digit_array_copy(x, &a[i * n], n);
+
+            __digit_array_multiply_fixed(p, &x[n - 1], n + 1, reciprocal, n + 1, mul_scratch);
+            __digit_array_copy(qi, &p[n + 1], n);
+
+            __digit_array_multiply_fixed(p, qi, n, src2, n, mul_scratch);
+            __digit_array_subtract_in_place(x, 2 * n, p, 2 * n);
+
+            /*
+             * Correct our estimate.  Our remainder is now less than 3 times the divisor, so
+             * it fits in n + 1 digits.
+             */
+            while (!__digit_array_subtract_in_place(x, n + 1, src2, n)) {
+                natural_digit one = 1;
+                __digit_array_add_in_place(qi, n, &one, 1);
             }
 
-            quotient[next_res_digit] = q;
-            dividend_num_digits--;
+            __digit_array_add_in_place(x, n + 1, src2, n);
+            __digit_array_copy(&x[n], x, n);
         }
 
         /*
          * Calculate our resulting digits.
          */
-        std::size_t q_num_digits = src1_num_digits - src2_num_digits + 1;
-        if (!quotient[q_num_digits - 1]) {
+        while (q_num_digits && !q[q_num_digits - 1]) {
             q_num_digits--;
         }
 
+        __digit_array_copy(quotient, q, q_num_digits);
         quotient_num_digits = q_num_digits;
 
-        while (dividend_num_digits) {
-            if (dividend[dividend_num_digits - 1]) {
+        natural_digit *r = &x[n];
+        std::size_t r_num_digits = n;
+        while (r_num_digits && !r[r_num_digits - 1]) {
+            r_num_digits--;
+        }
+
+        if (r_num_digits) {
+            __digit_array_right_shift_m(remainder, r_num_digits, r, r_num_digits, 0, normalize_shift);
+        }
+
+        remainder_num_digits = r_num_digits;
+    }
+
+    /*
+     * Compare two n digit arrays, either of which may have leading zero digits, returning
+     * true if src1 is greater than, or equal to, src2.
+     */
+    inline auto __digit_array_compare_ge_fixed(const natural_digit *src1, const natural_digit *src2, std::size_t n) -> bool {
+        while (n--) {
+            if (src1[n] != src2[n]) {
+                return src1[n] > src2[n];
+            }
+        }
+
+        return true;
+    }
+
+    /*
+     * Montgomery reduce a 2n digit array, src, modulo an odd n digit modulus, m.
+     *
+     * m_inverse must be -1/m mod B.  We clear the digits of src one at a time, from the least
+     * significant, by adding multiples of m, and then divide by B^n by simply taking the top
+     * n digits.  The carry out of each step belongs in a digit we've not finished with, so we
+     * keep it in the digit we've just cleared and add them all in at the end.
+     *
+     * src must be less than m.B^n, and is overwritten.  The result, src / B^n mod m, always
+     * has exactly n digits.
+     */
+    inline auto __digit_array_montgomery_reduce(natural_digit *res, natural_digit *src,
+                                                const natural_digit *m, std::size_t n, natural_digit m_inverse) -> void {
+        for (std::size_t i = 0; i < n; i++) {
+            auto u = static_cast<natural_digit>(src[i] * m_inverse);
+            natural_digit c = 0;
+            for (std::size_t j = 0; j < n; j++) {
+                auto acc = static_cast<natural_double_digit>(u) * static_cast<natural_double_digit>(m[j]);
+                acc += static_cast<natural_double_digit>(src[i + j]);
+                acc += static_cast<natural_double_digit>(c);
+                src[i + j] = static_cast<natural_digit>(acc);
+                c = static_cast<natural_digit>(acc >> natural_digit_bits);
+            }
+
+            src[i] = c;
+        }
+
+        /*
+         * Our result is now less than 2m, so at most one subtraction is needed.
+         */
+        __digit_array_copy(res, &src[n], n);
+        natural_digit carry = __digit_array_add_in_place(res, n, src, n);
+        if (carry || __digit_array_compare_ge_fixed(res, m, n)) {
+            __digit_array_subtract_in_place(res, n, m, n);
+        }
+    }
+
+    /*
+     * Return the number of scratch digits required for a Montgomery multiply or square,
+     * modulo an n digit modulus.
+     */
+    inline auto __digit_array_montgomery_scratch_size(std::size_t n) -> std::size_t {
+        auto mul_sz = __digit_array_multiply_scratch_size(n);
+        auto sqr_sz = __digit_array_square_scratch_size(n);
+        return (2 * n) + ((mul_sz > sqr_sz) ? mul_sz : sqr_sz);
+    }
+
+    /*
+     * Montgomery multiply two n digit arrays, modulo an odd n digit modulus, m.
+     *
+     * Both src1 and src2 must be less than m.  The result, src1.src2 / B^n mod m, always has
+     * exactly n digits.  The scratch space must have at least
+     * __digit_array_montgomery_scratch_size(n) digits.
+     *
+     * Note: It is OK for res to be the same pointer as src1 or src2.
+     */
+    inline auto __digit_array_montgomery_multiply(natural_digit *res,
+                                                  const natural_digit *src1, const natural_digit *src2,
+                                                  const natural_digit *m, std::size_t n, natural_digit m_inverse,
+                                                  natural_digit *scratch) -> void {
+        natural_digit *t = scratch;
+        __digit_array_multiply_fixed(t, src1, n, src2, n, &scratch[2 * n]);
+        __digit_array_montgomery_reduce(res, t, m, n, m_inverse);
+    }
+
+    /*
+     * Montgomery square an n digit array, modulo an odd n digit modulus, m.
+     *
+     * src must be less than m.  The result, src^2 / B^n mod m, always has exactly n digits.
+     * The scratch space must have at least __digit_array_montgomery_scratch_size(n) digits.
+     *
+     * Note: It is OK for res and src to be the same pointer.
+     */
+    inline auto __digit_array_montgomery_square(natural_digit *res, const natural_digit *src,
+                                                const natural_digit *m, std::size_t n, natural_digit m_inverse,
+                                                natural_digit *scratch) -> void {
+        natural_digit *t = scratch;
+        __digit_array_square_fixed(t, src, n, &scratch[2 * n]);
+        __digit_array_montgomery_reduce(res, t, m, n, m_inverse);
+    }
+
+    /*
+     * Return the number of scratch digits required for a Barrett reduce, multiply or square,
+     * modulo an n digit modulus.
+     */
+    inline auto __digit_array_barrett_scratch_size(std::size_t n) -> std::size_t {
+        auto mul_sz = __digit_array_multiply_scratch_size(n + 1);
+        auto sqr_sz = __digit_array_square_scratch_size(n);
+        return (2 * n) + (4 * n) + 3 + ((mul_sz > sqr_sz) ? mul_sz : sqr_sz);
+    }
+
+    /*
+     * Barrett reduce a 2n digit array, src, modulo an n digit modulus, m.
+     *
+     * mu must be floor((B^2n - 1) / m), which always has exactly n + 1 digits.  We estimate
+     * the quotient as q = floor(floor(src / B^(n - 1)) . mu / B^(n + 1)), which is never more
+     * than 2 below the true quotient, so src - q.m is less than 3m.  That means we only need
+     * to work with the least significant n + 1 digits of src and q.m, and then subtract m at
+     * most twice.  The result always has exactly n digits.
+     *
+     * The scratch space must have at least __digit_array_barrett_scratch_size(n) digits.
+     *
+     * Note: It is OK for res and src to be the same pointer.
+     */
+    inline auto __digit_array_barrett_reduce(natural_digit *res, const natural_digit *src,
+                                             const natural_digit *m, std::size_t n, const natural_digit *mu,
+                                             natural_digit *scratch) -> void {
+        natural_digit *q = scratch;
+        natural_digit *qm = &q[(2 * n) + 2];
+        natural_digit *mul_scratch = &qm[(2 * n) + 1];
+
+        __digit_array_multiply_fixed(q, &src[n - 1], n + 1, mu, n + 1, mul_scratch);
+        __digit_array_multiply_fixed(qm, &q[n + 1], n + 1, m, n, mul_scratch);
+
+        /*
+         * Our remainder estimate is less than B^(n + 1), so any borrow out of the top digit
+         * is simply discarded.
+         */
+        natural_digit *r = q;
+        __digit_array_copy(r, src, n + 1);
+        __digit_array_subtract_in_place(r, n + 1, qm, n + 1);
+
+        while (r[n] || __digit_array_compare_ge_fixed(r, m, n)) {
+            __digit_array_subtract_in_place(r, n + 1, m, n);
+        }
+
+        __digit_array_copy(res, r, n);
+    }
+
+    /*
+     * Barrett multiply two n digit arrays, modulo an n digit modulus, m.
+     *
+     * Both src1 and src2 must be less than m.  The result always has exactly n digits.  The
+     * scratch space must have at least __digit_array_barrett_scratch_size(n) digits.
+     *
+     * Note: It is OK for res to be the same pointer as src1 or src2.
+     */
+    inline auto __digit_array_barrett_multiply(natural_digit *res,
+                                               const natural_digit *src1, const natural_digit *src2,
+                                               const natural_digit *m, std::size_t n, const natural_digit *mu,
+                                               natural_digit *scratch) -> void {
+        natural_digit *t = scratch;
+        __digit_array_multiply_fixed(t, src1, n, src2, n, &scratch[2 * n]);
+        __digit_array_barrett_reduce(res, t, m, n, mu, &scratch[2 * n]);
+    }
+
+    /*
+     * Barrett square an n digit array, modulo an n digit modulus, m.
+     *
+     * src must be less than m.  The result always has exactly n digits.  The scratch space
+     * must have at least __digit_array_barrett_scratch_size(n) digits.
+     *
+     * Note: It is OK for res and src to be the same pointer.
+     */
+    inline auto __digit_array_barrett_square(natural_digit *res, const natural_digit *src,
+                                             const natural_digit *m, std::size_t n, const natural_digit *mu,
+                                             natural_digit *scratch) -> void {
+        natural_digit *t = scratch;
+        __digit_array_square_fixed(t, src, n, &scratch[2 * n]);
+        __digit_array_barrett_reduce(res, t, m, n, mu, &scratch[2 * n]);
+    }
+
+    /*
+     * Find the greatest common divisor of two non-zero digits.
+     *
+     * We use the binary GCD algorithm, which needs only shifts and subtracts.
+     */
+    inline auto __digit_array_gcd_1(natural_digit a, natural_digit b) -> natural_digit {
+        auto shift = __digit_array_count_trailing_zeros(a | b);
+        a >>= __digit_array_count_trailing_zeros(a);
+
+        while (b) {
+            b >>= __digit_array_count_trailing_zeros(b);
+            if (a > b) {
+                std::swap(a, b);
+            }
+
+            b = static_cast<natural_digit>(b - a);
+        }
+
+        return static_cast<natural_digit>(a << shift);
+    }
+
+    /*
+     * Return natural_digit_bits bits of a digit array, starting from bit position s.  Bits
+     * beyond the end of the array are treated as zero.
+     */
+    inline auto __digit_array_extract_bits(const natural_digit *src, std::size_t src_num_digits, std::size_t s) -> natural_digit {
+        std::size_t i = s / natural_digit_bits;
+        auto shift = static_cast<unsigned int>(s % natural_digit_bits);
+        if (i >= src_num_digits) {
+            return 0;
+        }
+
+        natural_digit d = static_cast<natural_digit>(src[i] >> shift);
+        if (shift && ((i + 1) < src_num_digits)) {
+            d |= static_cast<natural_digit>(src[i + 1] << (natural_digit_bits - shift));
+        }
+
+        return d;
+    }
+
+    /*
+     * Compute one row of a Lehmer update: res = (u.src1 - v.src2), where we know the result
+     * is not negative, and at most n digits long.
+     */
+    inline auto __digit_array_lehmer_row(natural_digit src1, natural_digit src2, natural_digit u, natural_digit v,
+                                         natural_digit &u_carry, natural_digit &v_carry, natural_digit &borrow) -> natural_digit {
+        auto acc_u = static_cast<natural_double_digit>(u) * static_cast<natural_double_digit>(src1);
+        acc_u += static_cast<natural_double_digit>(u_carry);
+        u_carry = static_cast<natural_digit>(acc_u >> natural_digit_bits);
+
+        auto acc_v = static_cast<natural_double_digit>(v) * static_cast<natural_double_digit>(src2);
+        acc_v += static_cast<natural_double_digit>(v_carry);
+        v_carry = static_cast<natural_digit>(acc_v >> natural_digit_bits);
+
+        auto acc = static_cast<natural_double_digit>(static_cast<natural_digit>(acc_u));
+        acc -= static_cast<natural_double_digit>(static_cast<natural_digit>(acc_v));
+        acc -= static_cast<natural_double_digit>(borrow);
+        borrow = static_cast<natural_digit>((acc >> natural_digit_bits) & 1);
+        return static_cast<natural_digit>(acc);
+    }
+
+    /*
+     * Attempt a Lehmer GCD step on two digit arrays, a and b, where a >= b and b has at
+     * least 2 digits.
+     *
+     * Rather than dividing a by b, we run Euclid's algorithm on the most significant bits
+     * of a and b (taken from the same bit position), for as long as the quotients we see are
+     * guaranteed to be the same ones we'd see with the full numbers (Knuth's Algorithm L).
+     * We track the cofactors of each step, and then apply all of them to a and b in a single
+     * pass.  Each step typically removes almost half a digit from both numbers.
+     *
+     * Returns false, leaving a and b unchanged, if we couldn't find any quotients.  This
+     * happens when a is very much larger than b, in which case a divide is needed instead.
+     *
+     * On success the magnitudes of the cofactors are returned in cofactors.  If negative is
+     * false then a' = c0.a - c1.b and b' = c3.b - c2.a, while if negative is true then both
+     * signs are reversed: a' = c1.b - c0.a and b' = c2.a - c3.b.
+     *
+     * Note: On success a and b are both replaced with smaller values, and a remains
+     * greater than, or equal to, b.
+     */
+    inline auto __digit_array_gcd_lehmer(natural_digit *a, std::size_t &a_num_digits,
+                                         natural_digit *b, std::size_t &b_num_digits,
+                                         natural_digit *cofactors, bool &negative) -> bool {
+        using natural_signed_digit = std::make_signed<natural_digit>::type;
+
+        /*
+         * Take the top natural_digit_bits - 2 bits of a, and the corresponding bits of b.
+         * This leaves room for our signed cofactors, which can never be larger than x.
+         */
+        std::size_t s = __digit_array_size_bits(a, a_num_digits) - (natural_digit_bits - 2);
+        auto x = static_cast<natural_signed_digit>(__digit_array_extract_bits(a, a_num_digits, s));
+        auto y = static_cast<natural_signed_digit>(__digit_array_extract_bits(b, b_num_digits, s));
+
+        natural_signed_digit ca = 1;
+        natural_signed_digit cb = 0;
+        natural_signed_digit cc = 0;
+        natural_signed_digit cd = 1;
+
+        while (((y + cc) > 0) && ((y + cd) > 0)) {
+            auto q = static_cast<natural_signed_digit>((x + ca) / (y + cc));
+            if (q != ((x + cb) / (y + cd))) {
                 break;
             }
 
-            dividend_num_digits--;
+            auto t = static_cast<natural_signed_digit>(ca - (q * cc));
+            ca = cc;
+            cc = t;
+            t = static_cast<natural_signed_digit>(cb - (q * cd));
+            cb = cd;
+            cd = t;
+            t = static_cast<natural_signed_digit>(x - (q * y));
+            x = y;
+            y = t;
         }
 
-        std::size_t r_num_digits = 0;
-        if (dividend_num_digits) {
-             __digit_array_right_shift_m(remainder, r_num_digits, dividend, dividend_num_digits, 0, normalize_shift);
+        if (!cb) {
+            return false;
         }
 
-        remainder_num_digits = r_num_digits;
+        /*
+         * Apply our cofactors: a' = ca.a + cb.b, b' = cc.a + cd.b.  In each pair one cofactor
+         * is positive and the other is negative (or zero), and both results are smaller than
+         * b, so we only need to look at b's digits.
+         */
+        bool a_swap = (cb > 0);
+        bool b_swap = (cd > 0);
+        auto a_u = static_cast<natural_digit>(a_swap ? cb : ca);
+        auto a_v = static_cast<natural_digit>(a_swap ? -ca : -cb);
+        auto b_u = static_cast<natural_digit>(b_swap ? cd : cc);
+        auto b_v = static_cast<natural_digit>(b_swap ? -cc : -cd);
+
+        negative = a_swap;
+        cofactors[0] = a_swap ? a_v : a_u;
+        cofactors[1] = a_swap ? a_u : a_v;
+        cofactors[2] = b_swap ? b_v : b_u;
+        cofactors[3] = b_swap ? b_u : b_v;
+
+        natural_digit a_u_carry = 0;
+        natural_digit a_v_carry = 0;
+        natural_digit a_borrow = 0;
+        natural_digit b_u_carry = 0;
+        natural_digit b_v_carry = 0;
+        natural_digit b_borrow = 0;
+
+        std::size_t n = b_num_digits;
+        for (std::size_t i = 0; i < n; i++) {
+            auto ai = a[i];
+            auto bi = b[i];
+            a[i] = a_swap ? __digit_array_lehmer_row(bi, ai, a_u, a_v, a_u_carry, a_v_carry, a_borrow)
+                          : __digit_array_lehmer_row(ai, bi, a_u, a_v, a_u_carry, a_v_carry, a_borrow);
+            b[i] = b_swap ? __digit_array_lehmer_row(bi, ai, b_u, b_v, b_u_carry, b_v_carry, b_borrow)
+                          : __digit_array_lehmer_row(ai, bi, b_u, b_v, b_u_carry, b_v_carry, b_borrow);
+        }
+
+        while (n && !a[n - 1]) {
+            n--;
+        }
+
+        a_num_digits = n;
+
+        while (n && !b[n - 1]) {
+            n--;
+        }
+
+        b_num_digits = n;
+        return true;
     }
 }
 
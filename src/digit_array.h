@@ -13,6 +13,11 @@
 #define INLINE inline __attribute__((always_inline))
 
 namespace c8 {
+    /*
+     * Temporary digit storage, taken from a per-thread arena where possible.
+     */
+    typedef __digit_array_scratch digit_array_scratch;
+
     /*
      * Return the number of bits required by this digit array.
      */
@@ -20,6 +25,13 @@ namespace c8 {
         return __digit_array_size_bits(p, p_num_digits);
     }
 
+    /*
+     * Zero an array of digits.
+     */
+    INLINE auto digit_array_zero(natural_digit *res, std::size_t res_num_digits) -> void {
+        return __digit_array_zero(res, res_num_digits);
+    }
+
     /*
      * Copy (forwards) an array of digits.
      */
@@ -225,6 +237,37 @@ namespace c8 {
         __digit_array_right_shift_m(res, res_num_digits, src, src_num_digits, shift_digits, shift_bits);
     }
 
+    /*
+     * Square a digit array.
+     *
+     * Note: It is OK for res and src to be the same pointer.
+     */
+    INLINE auto digit_array_square(natural_digit *res, std::size_t &res_num_digits,
+                                   const natural_digit *src, std::size_t src_num_digits) -> void {
+        /*
+         * Are we squaring zero?  If yes, the result is zero.
+         */
+        if (src_num_digits == 0) {
+            res_num_digits = 0;
+            return;
+        }
+
+        /*
+         * Handle the various digit number permutations.
+         */
+        if (src_num_digits == 1) {
+            __digit_array_multiply_1_1(res, res_num_digits, src, src);
+            return;
+        }
+
+        if (C8_UNLIKELY(src_num_digits >= __digit_array_square_karatsuba_threshold)) {
+            __digit_array_square_large_m(res, res_num_digits, src, src_num_digits);
+            return;
+        }
+
+        __digit_array_square_m(res, res_num_digits, src, src_num_digits);
+    }
+
     /*
      * Multiply two digit arrays.
      *
@@ -267,9 +310,118 @@ namespace c8 {
             return;
         }
 
+        /*
+         * Are we multiplying a number by itself?  If yes, squaring is much faster.
+         */
+        if ((src1 == src2) && (src1_num_digits == src2_num_digits)) {
+            if (C8_UNLIKELY(src1_num_digits >= __digit_array_square_karatsuba_threshold)) {
+                __digit_array_square_large_m(res, res_num_digits, src1, src1_num_digits);
+                return;
+            }
+
+            __digit_array_square_m(res, res_num_digits, src1, src1_num_digits);
+            return;
+        }
+
+        /*
+         * Large operands benefit from one of the sub-quadratic multiply algorithms.
+         */
+        if (C8_UNLIKELY((src1_num_digits >= __digit_array_karatsuba_threshold)
+                        && (src2_num_digits >= __digit_array_karatsuba_threshold))) {
+            __digit_array_multiply_large_m_n(res, res_num_digits, src1, src1_num_digits, src2, src2_num_digits);
+            return;
+        }
+
         __digit_array_multiply_m_n(res, res_num_digits, src1, src1_num_digits, src2, src2_num_digits);
     }
 
+    /*
+     * Multiply two digit arrays and add the product to res.
+     *
+     * res must have space for one more digit than the larger of res_num_digits and
+     * src1_num_digits + src2_num_digits.
+     *
+     * Note: res must not overlap src1 or src2.
+     */
+    INLINE auto digit_array_addmul(natural_digit *res, std::size_t &res_num_digits,
+                                   const natural_digit *src1, std::size_t src1_num_digits,
+                                   const natural_digit *src2, std::size_t src2_num_digits) -> void {
+        /*
+         * Are we adding a zero product?  If yes, then res is unchanged.
+         */
+        if ((src1_num_digits == 0) || (src2_num_digits == 0)) {
+            return;
+        }
+
+        /*
+         * If both operands are large enough that a sub-quadratic multiply wins then form
+         * the product separately and add it.
+         */
+        if (C8_UNLIKELY((src1_num_digits >= __digit_array_karatsuba_threshold)
+                        && (src2_num_digits >= __digit_array_karatsuba_threshold))) {
+            std::size_t prod_num_digits = src1_num_digits + src2_num_digits;
+            __digit_array_scratch prod_digits(prod_num_digits);
+            natural_digit *prod = prod_digits.get();
+            __digit_array_multiply_large_m_n(prod, prod_num_digits, src1, src1_num_digits, src2, src2_num_digits);
+            digit_array_add(res, res_num_digits, res, res_num_digits, prod, prod_num_digits);
+            return;
+        }
+
+        if (src1_num_digits < src2_num_digits) {
+            __digit_array_addmul_m_n(res, res_num_digits, src2, src2_num_digits, src1, src1_num_digits);
+            return;
+        }
+
+        __digit_array_addmul_m_n(res, res_num_digits, src1, src1_num_digits, src2, src2_num_digits);
+    }
+
+    /*
+     * Multiply two digit arrays and subtract the product from res.
+     *
+     * If the product is larger than res then res is left holding the magnitude of the
+     * (negative) difference and we return true, otherwise we return false.
+     *
+     * res must have space for the larger of res_num_digits and src1_num_digits +
+     * src2_num_digits.
+     *
+     * Note: res must not overlap src1 or src2.
+     */
+    INLINE auto digit_array_submul(natural_digit *res, std::size_t &res_num_digits,
+                                   const natural_digit *src1, std::size_t src1_num_digits,
+                                   const natural_digit *src2, std::size_t src2_num_digits) -> bool {
+        /*
+         * Are we subtracting a zero product?  If yes, then res is unchanged.
+         */
+        if ((src1_num_digits == 0) || (src2_num_digits == 0)) {
+            return false;
+        }
+
+        /*
+         * If both operands are large enough that a sub-quadratic multiply wins then form
+         * the product separately and subtract it.
+         */
+        if (C8_UNLIKELY((src1_num_digits >= __digit_array_karatsuba_threshold)
+                        && (src2_num_digits >= __digit_array_karatsuba_threshold))) {
+            std::size_t prod_num_digits = src1_num_digits + src2_num_digits;
+            __digit_array_scratch prod_digits(prod_num_digits);
+            natural_digit *prod = prod_digits.get();
+            __digit_array_multiply_large_m_n(prod, prod_num_digits, src1, src1_num_digits, src2, src2_num_digits);
+            if (__digit_array_compare_le(prod, prod_num_digits, res, res_num_digits)) {
+                digit_array_subtract(res, res_num_digits, res, res_num_digits, prod, prod_num_digits);
+                return false;
+            }
+
+            digit_array_subtract(res, res_num_digits, prod, prod_num_digits, res, res_num_digits);
+            return true;
+        }
+
+        if (src1_num_digits < src2_num_digits) {
+            return __digit_array_submul_m_n(res, res_num_digits, src2, src2_num_digits, src1, src1_num_digits);
+        }
+
+        return __digit_array_submul_m_n(res, res_num_digits, src1, src1_num_digits, src2, src2_num_digits);
+    }
+
     /*
      * Divide two digit arrays.
      *
@@ -311,9 +463,191 @@ namespace c8 {
             return;
         }
 
+        /*
+         * Large divisors benefit from recursive division, as long as the quotient is also large.
+         */
+        if (C8_UNLIKELY((src2_num_digits >= __digit_array_bz_threshold)
+                        && (src1_num_digits >= (src2_num_digits + __digit_array_bz_threshold)))) {
+            __digit_array_divide_modulus_bz(quotient, quotient_num_digits, remainder, remainder_num_digits,
+                                            src1, src1_num_digits, src2, src2_num_digits);
+            return;
+        }
+
         __digit_array_divide_modulus_m_n(quotient, quotient_num_digits, remainder, remainder_num_digits,
                                          src1, src1_num_digits, src2, src2_num_digits);
     }
+
+    /*
+     * Divide a digit array by a precomputed divisor.
+     *
+     * normalized must be the divisor, src2, shifted left by normalize_shift bits so that
+     * its most significant digit has its top bit set.  If reciprocal_num_digits is non-zero
+     * then reciprocal must be floor(B^2n / normalized), where n is src2_num_digits.
+     *
+     * src2_num_digits must be >= 1.
+     */
+    INLINE auto digit_array_divide_modulus_precomputed(natural_digit *quotient, std::size_t &quotient_num_digits,
+                                                       natural_digit *remainder, std::size_t &remainder_num_digits,
+                                                       const natural_digit *src1, std::size_t src1_num_digits,
+                                                       const natural_digit *src2, std::size_t src2_num_digits,
+                                                       const natural_digit *normalized,
+                                                       const natural_digit *reciprocal, std::size_t reciprocal_num_digits,
+                                                       unsigned int normalize_shift) -> void {
+        /*
+         * Are we dividing a zero?
+         */
+        if (src1_num_digits == 0) {
+            remainder_num_digits = 0;
+            quotient_num_digits = 0;
+            return;
+        }
+
+        /*
+         * Handle the various digit number permutations.
+         */
+        if (src2_num_digits == 1) {
+            if (src1_num_digits == 1) {
+                __digit_array_divide_modulus_1_1(quotient, quotient_num_digits, remainder, remainder_num_digits,
+                                                 src1, src2);
+                return;
+            }
+
+            __digit_array_divide_modulus_m_1(quotient, quotient_num_digits, remainder, remainder_num_digits,
+                                             src1, src1_num_digits, src2);
+            return;
+        }
+
+        /*
+         * Very large divisors have a reciprocal, and large ones benefit from recursive division.
+         */
+        if (C8_UNLIKELY(reciprocal_num_digits)) {
+            __digit_array_divide_modulus_reciprocal(quotient, quotient_num_digits, remainder, remainder_num_digits,
+                                                    src1, src1_num_digits, normalized, src2_num_digits,
+                                                    reciprocal, normalize_shift);
+            return;
+        }
+
+        if (C8_UNLIKELY((src2_num_digits >= __digit_array_bz_threshold)
+                        && (src1_num_digits >= (src2_num_digits + __digit_array_bz_threshold)))) {
+            __digit_array_divide_modulus_bz(quotient, quotient_num_digits, remainder, remainder_num_digits,
+                                            src1, src1_num_digits, src2, src2_num_digits);
+            return;
+        }
+
+        __digit_array_divide_modulus_normalized(quotient, quotient_num_digits, remainder, remainder_num_digits,
+                                                src1, src1_num_digits, normalized, src2_num_digits, normalize_shift);
+    }
+
+    /*
+     * Return -1/m mod B, for an odd digit m, as needed for Montgomery reduction.
+     */
+    INLINE auto digit_array_montgomery_inverse(natural_digit m) -> natural_digit {
+        return static_cast<natural_digit>(-__digit_array_inverse_1(m));
+    }
+
+    /*
+     * Return the number of scratch digits needed for Montgomery operations with an n digit modulus.
+     */
+    INLINE auto digit_array_montgomery_scratch_size(std::size_t n) -> std::size_t {
+        return __digit_array_montgomery_scratch_size(n);
+    }
+
+    /*
+     * Montgomery reduce a 2n digit array, modulo an odd n digit modulus.
+     *
+     * Note: src is overwritten.
+     */
+    INLINE auto digit_array_montgomery_reduce(natural_digit *res, natural_digit *src,
+                                              const natural_digit *m, std::size_t n, natural_digit m_inverse) -> void {
+        __digit_array_montgomery_reduce(res, src, m, n, m_inverse);
+    }
+
+    /*
+     * Montgomery multiply two n digit arrays, modulo an odd n digit modulus.
+     *
+     * Note: It is OK for res to be the same pointer as src1 or src2.
+     */
+    INLINE auto digit_array_montgomery_multiply(natural_digit *res,
+                                                const natural_digit *src1, const natural_digit *src2,
+                                                const natural_digit *m, std::size_t n, natural_digit m_inverse,
+                                                natural_digit *scratch) -> void {
+        __digit_array_montgomery_multiply(res, src1, src2, m, n, m_inverse, scratch);
+    }
+
+    /*
+     * Montgomery square an n digit array, modulo an odd n digit modulus.
+     *
+     * Note: It is OK for res and src to be the same pointer.
+     */
+    INLINE auto digit_array_montgomery_square(natural_digit *res, const natural_digit *src,
+                                              const natural_digit *m, std::size_t n, natural_digit m_inverse,
+                                              natural_digit *scratch) -> void {
+        __digit_array_montgomery_square(res, src, m, n, m_inverse, scratch);
+    }
+
+    /*
+     * Return the number of scratch digits needed for Barrett operations with an n digit modulus.
+     */
+    INLINE auto digit_array_barrett_scratch_size(std::size_t n) -> std::size_t {
+        return __digit_array_barrett_scratch_size(n);
+    }
+
+    /*
+     * Barrett reduce a 2n digit array, modulo an n digit modulus.
+     */
+    INLINE auto digit_array_barrett_reduce(natural_digit *res, const natural_digit *src,
+                                           const natural_digit *m, std::size_t n, const natural_digit *mu,
+                                           natural_digit *scratch) -> void {
+        __digit_array_barrett_reduce(res, src, m, n, mu, scratch);
+    }
+
+    /*
+     * Barrett multiply two n digit arrays, modulo an n digit modulus.
+     */
+    INLINE auto digit_array_barrett_multiply(natural_digit *res,
+                                             const natural_digit *src1, const natural_digit *src2,
+                                             const natural_digit *m, std::size_t n, const natural_digit *mu,
+                                             natural_digit *scratch) -> void {
+        __digit_array_barrett_multiply(res, src1, src2, m, n, mu, scratch);
+    }
+
+    /*
+     * Barrett square an n digit array, modulo an n digit modulus.
+     */
+    INLINE auto digit_array_barrett_square(natural_digit *res, const natural_digit *src,
+                                           const natural_digit *m, std::size_t n, const natural_digit *mu,
+                                           natural_digit *scratch) -> void {
+        __digit_array_barrett_square(res, src, m, n, mu, scratch);
+    }
+
+    /*
+     * Find the greatest common divisor of two non-zero digits.
+     */
+    INLINE auto digit_array_gcd_1(natural_digit a, natural_digit b) -> natural_digit {
+        return __digit_array_gcd_1(a, b);
+    }
+
+    /*
+     * Attempt a Lehmer GCD step on two digit arrays, a and b, where a >= b and b has at
+     * least 2 digits.  Returns false if no step was possible, in which case a divide is
+     * needed instead.
+     */
+    INLINE auto digit_array_gcd_lehmer(natural_digit *a, std::size_t &a_num_digits,
+                                       natural_digit *b, std::size_t &b_num_digits) -> bool {
+        natural_digit cofactors[4];
+        bool negative;
+        return __digit_array_gcd_lehmer(a, a_num_digits, b, b_num_digits, cofactors, negative);
+    }
+
+    /*
+     * Attempt a Lehmer GCD step on two digit arrays, as above, but also return the
+     * cofactors used.
+     */
+    INLINE auto digit_array_gcd_lehmer(natural_digit *a, std::size_t &a_num_digits,
+                                       natural_digit *b, std::size_t &b_num_digits,
+                                       natural_digit *cofactors, bool &negative) -> bool {
+        return __digit_array_gcd_lehmer(a, a_num_digits, b, b_num_digits, cofactors, negative);
+    }
 }
 
 #endif // __C8_DIGIT_ARRAY_H
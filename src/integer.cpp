@@ -4,6 +4,16 @@
 #include "c8.h"
 
 namespace c8 {
+    /*
+     * Return the magnitude of a long long integer.  This is done in unsigned arithmetic
+     * so that the most negative value, whose magnitude doesn't fit in a long long, is
+     * handled correctly.
+     */
+    static inline auto integer_ll_magnitude(long long v) noexcept -> unsigned long long {
+        unsigned long long m = static_cast<unsigned long long>(v);
+        return (v < 0) ? (0ULL - m) : m;
+    }
+
     /*
      * Construct an integer using a string.
      *
@@ -215,6 +225,72 @@ namespace c8 {
         return true;
     }
 
+    /*
+     * Compare this integer with a long long integer, returning -1, 0 or 1 if this integer
+     * is less than, equal to, or greater than the other one.
+     */
+    auto integer::compare(long long v) const noexcept -> int {
+        /*
+         * If our signs are different then the negative one is smaller.
+         */
+        bool v_negative = (v < 0);
+        if (negative_ != v_negative) {
+            return negative_ ? -1 : 1;
+        }
+
+        /*
+         * Signs are the same, so compare magnitudes, reversing the result if both
+         * numbers are negative.
+         */
+        unsigned long long v_magnitude = integer_ll_magnitude(v);
+        int res = (magnitude_ < v_magnitude) ? -1 : ((magnitude_ == v_magnitude) ? 0 : 1);
+        return negative_ ? -res : res;
+    }
+
+    /*
+     * Return true if this integer is equal to a long long integer, false if it's not.
+     */
+    auto integer::operator ==(long long v) const noexcept -> bool {
+        return compare(v) == 0;
+    }
+
+    /*
+     * Return true if this integer is not equal to a long long integer, false if it's equal.
+     */
+    auto integer::operator !=(long long v) const noexcept -> bool {
+        return compare(v) != 0;
+    }
+
+    /*
+     * Return true if this integer is greater than a long long integer, false if it's not.
+     */
+    auto integer::operator >(long long v) const noexcept -> bool {
+        return compare(v) > 0;
+    }
+
+    /*
+     * Return true if this integer is greater than, or equal to, a long long integer, false if
+     * it's not.
+     */
+    auto integer::operator >=(long long v) const noexcept -> bool {
+        return compare(v) >= 0;
+    }
+
+    /*
+     * Return true if this integer is less than a long long integer, false if it's not.
+     */
+    auto integer::operator <(long long v) const noexcept -> bool {
+        return compare(v) < 0;
+    }
+
+    /*
+     * Return true if this integer is less than, or equal to, a long long integer, false if
+     * it's not.
+     */
+    auto integer::operator <=(long long v) const noexcept -> bool {
+        return compare(v) <= 0;
+    }
+
     /*
      * Add another integer to this one.
      */
@@ -355,6 +431,82 @@ namespace c8 {
         return *this;
     }
 
+    /*
+     * Return the sum of this integer and a machine word with the specified sign and
+     * magnitude.  This follows the same rules as adding another integer.
+     */
+    auto integer::add(bool v_negative, unsigned long long v_magnitude) const -> integer {
+        integer res;
+
+        if (negative_ == v_negative) {
+            res.negative_ = negative_;
+            res.magnitude_ = magnitude_ + v_magnitude;
+            return res;
+        }
+
+        /*
+         * If the machine word has the larger magnitude then our own magnitude must fit
+         * in a machine word too.
+         */
+        if (magnitude_ < v_magnitude) {
+            res.negative_ = v_negative;
+            res.magnitude_ = natural(v_magnitude - magnitude_.to_unsigned_long_long());
+            return res;
+        }
+
+        res.negative_ = negative_;
+        res.magnitude_ = magnitude_ - v_magnitude;
+        return res;
+    }
+
+    /*
+     * Add a machine word with the specified sign and magnitude to this integer.
+     */
+    auto integer::add_assign(bool v_negative, unsigned long long v_magnitude) -> void {
+        if (negative_ == v_negative) {
+            magnitude_ += v_magnitude;
+            return;
+        }
+
+        if (magnitude_ < v_magnitude) {
+            negative_ = v_negative;
+            magnitude_ = natural(v_magnitude - magnitude_.to_unsigned_long_long());
+            return;
+        }
+
+        magnitude_ -= v_magnitude;
+    }
+
+    /*
+     * Add a long long integer to this one.
+     */
+    auto integer::operator +(long long v) const -> integer {
+        return add(v < 0, integer_ll_magnitude(v));
+    }
+
+    /*
+     * Add a long long integer to this one.
+     */
+    auto integer::operator +=(long long v) -> integer & {
+        add_assign(v < 0, integer_ll_magnitude(v));
+        return *this;
+    }
+
+    /*
+     * Subtract a long long integer from this one.
+     */
+    auto integer::operator -(long long v) const -> integer {
+        return add(v >= 0, integer_ll_magnitude(v));
+    }
+
+    /*
+     * Subtract a long long integer from this one.
+     */
+    auto integer::operator -=(long long v) -> integer & {
+        add_assign(v >= 0, integer_ll_magnitude(v));
+        return *this;
+    }
+
     /*
      * Left shift this integer by a number of bits.
      */
@@ -385,6 +537,59 @@ namespace c8 {
         return res;
     }
 
+    /*
+     * Set this integer to the product of two others.
+     */
+    auto integer::assign_multiply(const integer &v, const integer &u) -> void {
+        bool negative = v.negative_ ^ u.negative_;
+        magnitude_.assign_multiply(v.magnitude_, u.magnitude_);
+        negative_ = negative;
+    }
+
+    /*
+     * Add the product of two integers to this one.
+     *
+     * As with +=, if the product has the larger magnitude then we take its sign.
+     */
+    auto integer::addmul(const integer &v, const integer &u) -> integer & {
+        if ((v.negative_ ^ u.negative_) == negative_) {
+            magnitude_.addmul(v.magnitude_, u.magnitude_);
+            return *this;
+        }
+
+        if (magnitude_.multiply_subtract(v.magnitude_, u.magnitude_, true)) {
+            negative_ ^= true;
+        }
+
+        return *this;
+    }
+
+    /*
+     * Subtract the product of two integers from this one.
+     */
+    auto integer::submul(const integer &v, const integer &u) -> integer & {
+        if ((v.negative_ ^ u.negative_) != negative_) {
+            magnitude_.addmul(v.magnitude_, u.magnitude_);
+            return *this;
+        }
+
+        if (magnitude_.multiply_subtract(v.magnitude_, u.magnitude_, true)) {
+            negative_ ^= true;
+        }
+
+        return *this;
+    }
+
+    /*
+     * Set this integer to the product of two others, modulo a third.  As with %=, the
+     * remainder takes the sign of the product.
+     */
+    auto integer::multiply_modulus(const integer &v, const integer &u, const integer &m) -> void {
+        bool negative = v.negative_ ^ u.negative_;
+        magnitude_.multiply_modulus(v.magnitude_, u.magnitude_, m.magnitude_);
+        negative_ = negative;
+    }
+
     /*
      * Divide this integer by another one, returning the quotient and remainder.
      */
@@ -420,6 +625,109 @@ namespace c8 {
         return res;
     }
 
+    /*
+     * Multiply this integer by a long long integer.
+     */
+    auto integer::operator *(long long v) const -> integer {
+        integer res;
+        res.negative_ = negative_ ^ (v < 0);
+        res.magnitude_ = magnitude_ * integer_ll_magnitude(v);
+        return res;
+    }
+
+    /*
+     * Multiply this integer by a long long integer.
+     */
+    auto integer::operator *=(long long v) -> integer & {
+        negative_ ^= (v < 0);
+        magnitude_ *= integer_ll_magnitude(v);
+        return *this;
+    }
+
+    /*
+     * Divide this integer by a long long integer, returning the quotient.
+     */
+    auto integer::operator /(long long v) const -> integer {
+        integer res;
+        res.negative_ = negative_ ^ (v < 0);
+        res.magnitude_ = magnitude_ / integer_ll_magnitude(v);
+        return res;
+    }
+
+    /*
+     * Divide this integer by a long long integer, returning the quotient.
+     */
+    auto integer::operator /=(long long v) -> integer & {
+        magnitude_ /= integer_ll_magnitude(v);
+        negative_ ^= (v < 0);
+        return *this;
+    }
+
+    /*
+     * Divide this integer by a long long integer, returning the remainder.
+     */
+    auto integer::operator %(long long v) const -> integer {
+        integer res;
+        res.negative_ = negative_;
+        res.magnitude_ = magnitude_ % integer_ll_magnitude(v);
+        return res;
+    }
+
+    /*
+     * Divide this integer by a long long integer, returning the remainder.
+     */
+    auto integer::operator %=(long long v) -> integer & {
+        magnitude_ %= integer_ll_magnitude(v);
+        return *this;
+    }
+
+    /*
+     * Find the greatest common divisor, g, of this integer and another, v, along with
+     * Bezout coefficients s and t such that g = s.this + t.v.
+     */
+    auto integer::gcdext(const integer &v) const -> std::tuple<integer, integer, integer> {
+        integer g;
+        integer s;
+        integer t;
+        g.magnitude_ = natural::gcdext(magnitude_, v.magnitude_, s.magnitude_, s.negative_, t.magnitude_, t.negative_);
+
+        /*
+         * Our cofactors were for the magnitudes, so flip their signs to match.
+         */
+        if (negative_ && !s.magnitude_.is_zero()) {
+            s.negative_ ^= true;
+        }
+
+        if (v.negative_ && !t.magnitude_.is_zero()) {
+            t.negative_ ^= true;
+        }
+
+        return std::make_tuple(g, s, t);
+    }
+
+    /*
+     * Raise this integer to the power e, modulo m.
+     *
+     * The result is always in the range 0 to |m| - 1.
+     */
+    auto integer::pow_mod(const integer &e, const integer &m) const -> integer {
+        if (e.negative_ && !e.magnitude_.is_zero()) {
+            throw invalid_argument("negative exponent");
+        }
+
+        /*
+         * Find our base modulo m, so that we only need to work with natural numbers.
+         */
+        natural b = magnitude_ % m.magnitude_;
+        if (negative_ && !b.is_zero()) {
+            b = m.magnitude_ - b;
+        }
+
+        integer res;
+        res.magnitude_ = b.pow_mod(e.magnitude_, m.magnitude_);
+        return res;
+    }
+
     /*
      * Convert this integer to a long long.
      */
@@ -455,5 +763,62 @@ namespace c8 {
 
         return outstr;
     }
+
+    /*
+     * Write the characters of v, in the specified base, into the character range [first, last).
+     *
+     * Negative numbers are written with a leading '-' sign.
+     */
+    auto to_chars(char *first, char *last, const integer &v, int base) -> to_chars_result {
+        /*
+         * Reject an unsupported base before we write a sign, so that a failed conversion
+         * leaves the range untouched, just as it does for a natural.
+         */
+        switch (base) {
+        case 2:
+        case 4:
+        case 8:
+        case 10:
+        case 16:
+        case 32:
+            break;
+
+        default:
+            return {last, std::errc::invalid_argument};
+        }
+
+        if (v.negative_) {
+            if (C8_UNLIKELY(first == last)) {
+                return {last, std::errc::value_too_large};
+            }
+
+            *first++ = '-';
+        }
+
+        return to_chars(first, last, v.magnitude_, base);
+    }
+
+    /*
+     * Parse an integer, in the specified base, from the character range [first, last).
+     *
+     * The number can have an optional '-' sign to indicate that it's negative.  If no valid
+     * number is found then v is unchanged.
+     */
+    auto from_chars(const char *first, const char *last, integer &v, int base) -> from_chars_result {
+        const char *p = first;
+        bool negative = false;
+        if ((p != last) && (*p == '-')) {
+            negative = true;
+            p++;
+        }
+
+        auto res = from_chars(p, last, v.magnitude_, base);
+        if (C8_UNLIKELY(res.ec != std::errc())) {
+            return {first, res.ec};
+        }
+
+        v.negative_ = negative;
+        return res;
+    }
 }
 
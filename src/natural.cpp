@@ -1,7 +1,6 @@
 /*
  * natural.cpp
  */
-#include <cctype>
 #include <vector>
 
 #include "c8.h"
@@ -9,40 +8,165 @@
 
 namespace c8 {
     const char digits_lower[] = {
-        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+        'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v'
     };
     const char digits_upper[] = {
-        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
+        'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V'
     };
 
+    /*
+     * Convert a character to numeric value, returning the base if the character is not
+     * valid within that base.
+     *
+     * We don't use isdigit() and friends here because they depend on the current locale,
+     * and this is used for every character of every number we parse.
+     */
+    auto inline natural_char_value(char c, natural_digit base) -> natural_digit {
+        natural_digit c_digit;
+        if ((c >= '0') && (c <= '9')) {
+            c_digit = static_cast<natural_digit>(c - '0');
+        } else if ((c >= 'a') && (c <= 'z')) {
+            c_digit = static_cast<natural_digit>(c - 'a' + 10);
+        } else if ((c >= 'A') && (c <= 'Z')) {
+            c_digit = static_cast<natural_digit>(c - 'A' + 10);
+        } else {
+            return base;
+        }
+
+        return (c_digit < base) ? c_digit : base;
+    }
+
     /*
      * Convert a character to numeric value, checking against a specified base.
      */
     auto inline convert_char_to_natural_digit(char c, natural_digit base) -> natural_digit {
-        if (!isdigit(c)) {
-            if (base != 16) {
-                throw invalid_argument("invalid digit");
-            }
+        natural_digit c_digit = natural_char_value(c, base);
+        if (C8_UNLIKELY(c_digit == base)) {
+            throw invalid_argument("invalid digit");
+        }
 
-            if (!isxdigit(c)) {
-                throw invalid_argument("invalid digit");
-            }
+        return c_digit;
+    }
+
+    /*
+     * Return the number of decimal characters that fit within a single digit, and the
+     * corresponding power of 10.
+     */
+    constexpr auto natural_decimal_chunk_chars() -> std::size_t {
+        std::size_t chars = 0;
+        natural_digit p = 1;
+        while (p <= static_cast<natural_digit>(~static_cast<natural_digit>(0)) / 10) {
+            p = static_cast<natural_digit>(p * 10);
+            chars++;
+        }
+
+        return chars;
+    }
 
-            c = static_cast<char>(tolower(c));
-            c = static_cast<char>(c - ('a' - '0' - 10));
+    constexpr auto natural_decimal_chunk() -> natural_digit {
+        natural_digit p = 1;
+        for (std::size_t i = 0; i < natural_decimal_chunk_chars(); i++) {
+            p = static_cast<natural_digit>(p * 10);
         }
 
-        natural_digit c_digit = static_cast<natural_digit>(c - '0');
+        return p;
+    }
 
-        if (base == 8) {
-            if (c_digit >= 8) {
-                throw invalid_argument("invalid digit");
-            }
+    /*
+     * The default natural allocator, which simply uses the heap.
+     */
+    class natural_heap_allocator : public natural_allocator {
+    public:
+        auto allocate(std::size_t num_digits) -> natural_digit * override {
+            return new natural_digit[num_digits];
         }
 
-        return c_digit;
+        auto deallocate(natural_digit *p, std::size_t num_digits) noexcept -> void override {
+            (void)num_digits;
+            delete[] p;
+        }
+    };
+
+    static natural_heap_allocator natural_default_allocator;
+
+    static thread_local natural_allocator *natural_current_allocator = &natural_default_allocator;
+
+    /*
+     * Return the current thread's natural allocator.
+     */
+    auto natural_allocator::current() noexcept -> natural_allocator & {
+        return *natural_current_allocator;
     }
 
+    /*
+     * Return the default, heap-based, natural allocator.
+     */
+    auto natural_allocator::heap() noexcept -> natural_allocator & {
+        return natural_default_allocator;
+    }
+
+    /*
+     * Make an allocator the current thread's natural allocator.
+     */
+    natural_allocator_scope::natural_allocator_scope(natural_allocator &a) noexcept {
+        previous_ = natural_current_allocator;
+        natural_current_allocator = &a;
+    }
+
+    /*
+     * Restore the previous natural allocator.
+     */
+    natural_allocator_scope::~natural_allocator_scope() {
+        natural_current_allocator = previous_;
+    }
+
+    /*
+     * Construct an arena allocator.  No blocks are allocated until they're needed.
+     */
+    natural_arena_allocator::natural_arena_allocator(std::size_t block_digits) noexcept {
+        block_digits_ = block_digits;
+        next_ = nullptr;
+        remaining_ = 0;
+    }
+
+    /*
+     * Allocate digits from the arena, starting a new block if the current one is too full.
+     */
+    auto natural_arena_allocator::allocate(std::size_t num_digits) -> natural_digit * {
+        if (C8_UNLIKELY(num_digits > remaining_)) {
+            std::size_t sz = (num_digits > block_digits_) ? num_digits : block_digits_;
+            blocks_.emplace_back(new natural_digit[sz]);
+            next_ = blocks_.back().get();
+            remaining_ = sz;
+        }
+
+        natural_digit *p = next_;
+        next_ += num_digits;
+        remaining_ -= num_digits;
+        return p;
+    }
+
+    /*
+     * Return digits to the arena.  We can only reuse them if they were the most recent
+     * allocation, otherwise they're freed when the arena is destroyed.
+     */
+    auto natural_arena_allocator::deallocate(natural_digit *p, std::size_t num_digits) noexcept -> void {
+        if ((p + num_digits) == next_) {
+            next_ = p;
+            remaining_ += num_digits;
+        }
+    }
+
+    /*
+     * Allocate a digit buffer from the current thread's allocator.
+     */
+    static auto natural_allocate_digits(std::size_t num_digits) -> std::unique_ptr<natural_digit[], natural_digits_deleter> {
+        natural_allocator &a = natural_allocator::current();
+        return std::unique_ptr<natural_digit[], natural_digits_deleter>(a.allocate(num_digits),
+                                                                        natural_digits_deleter{&a, num_digits});
+    }
 
     /*
      * Reserve a number of digits in this natural number.
@@ -57,12 +181,11 @@ namespace c8 {
         }
 
         /*
-         * Allocate a new digit array and update book-keeping info.  The naked new
-         * here isn't ideal, but we really don't want to have to zero the array and
-         * there's no way to do that with std::make_unique<>.
+         * Allocate a new digit array and update book-keeping info.  We don't want to
+         * zero the array, so this can't use std::make_unique<>.
          */
         digits_size_ = new_digits;
-        large_digits_ = std::unique_ptr<natural_digit[]>(new natural_digit[new_digits]);
+        large_digits_ = natural_allocate_digits(new_digits);
         digits_ = large_digits_.get();
     }
 
@@ -79,11 +202,10 @@ namespace c8 {
         }
 
         /*
-         * Replace the old digit array with the new one.  The naked new here
-         * isn't ideal, but we really don't want to have to zero the array and
-         * there's no way to do that with std::make_unique<>.
+         * Replace the old digit array with the new one.  We don't want to zero the
+         * array, so this can't use std::make_unique<>.
          */
-        auto d = std::unique_ptr<natural_digit[]>(new natural_digit[new_digits]);
+        auto d = natural_allocate_digits(new_digits);
         auto d_ptr = d.get();
         digit_array_copy(d_ptr, digits_, num_digits_);
 
@@ -137,30 +259,167 @@ namespace c8 {
         v.num_digits_ = 0;
     }
 
+    /*
+     * The number of digits needed to hold any unsigned long long value.
+     */
+    const std::size_t natural_ull_digits = (sizeof(unsigned long long) + sizeof(natural_digit) - 1) / sizeof(natural_digit);
+
+    /*
+     * Convert an unsigned long long integer into a digit array, returning the number of digits used.
+     * The result array must have space for natural_ull_digits digits.
+     */
+    static auto natural_ull_to_digits(natural_digit *res, unsigned long long v) noexcept -> std::size_t {
+        std::size_t i = 0;
+        while (v) {
+            natural_digit m = static_cast<natural_digit>(-1);
+            res[i++] = static_cast<natural_digit>(v & m);
+#if defined(C8_DIGIT_8_BITS) || defined(C8_DIGIT_16_BITS) || defined(C8_DIGIT_32_BITS)
+            v >>= natural_digit_bits;
+#else
+            v = 0;
+#endif
+        }
+
+        return i;
+    }
+
     /*
      * Construct a natural number from an unsigned long long integer.
      */
     natural::natural(unsigned long long v) noexcept {
-        num_digits_ = 0;
         digits_size_ = sizeof(small_digits_) / sizeof(natural_digit);
         digits_ = small_digits_;
+        num_digits_ = natural_ull_to_digits(digits_, v);
+    }
+
+    /*
+     * Set this number from a string of v_sz decimal characters.
+     *
+     * This is the simple quadratic algorithm, but we only do one single digit multiply for
+     * each group of characters that fit within a digit.
+     */
+    auto natural::from_decimal_basecase(const char *v, std::size_t v_sz) -> void {
+        const std::size_t chunk_chars = natural_decimal_chunk_chars();
+
+        num_digits_ = 0;
+        reserve(((v_sz * 4) / natural_digit_bits) + 1);
+
+        std::size_t chars = v_sz % chunk_chars;
+        if (!chars) {
+            chars = chunk_chars;
+        }
+
+        std::size_t idx = 0;
+        while (idx < v_sz) {
+            natural_digit base_div = 1;
+            natural_digit acc = 0;
+            for (std::size_t j = 0; j < chars; j++) {
+                natural_digit c_digit = convert_char_to_natural_digit(v[idx++], 10);
+                acc = static_cast<natural_digit>((acc * 10) + c_digit);
+                base_div = static_cast<natural_digit>(base_div * 10);
+            }
+
+            chars = chunk_chars;
+
+            if (num_digits_) {
+                digit_array_multiply(digits_, num_digits_, digits_, num_digits_, &base_div, 1);
+            }
+
+            if (acc) {
+                digit_array_add(digits_, num_digits_, digits_, num_digits_, &acc, 1);
+            }
+        }
+    }
+
+    /*
+     * Set this number from a string of v_sz decimal characters.
+     *
+     * powers[i] holds 10^(c * 2^i), where c is the number of decimal characters we can fit in
+     * a single digit.  We split the string so that the low part is c * 2^i characters long
+     * and is at least a quarter of the whole string, recursively convert the two parts, and
+     * combine them with one multiply.  Given fast multiplication this is O(M(n) log n) instead
+     * of O(n^2).
+     */
+    auto natural::from_decimal(const char *v, std::size_t v_sz, const natural *powers, std::size_t num_powers) -> void {
+        const std::size_t chunk_chars = natural_decimal_chunk_chars();
 
-        if (!v) {
+        std::size_t i = num_powers;
+        while (i && ((2 * (chunk_chars << (i - 1))) > v_sz)) {
+            i--;
+        }
+
+        if ((v_sz < (__digit_array_decimal_threshold * chunk_chars)) || !i) {
+            from_decimal_basecase(v, v_sz);
             return;
         }
 
-        natural_digit *this_digits = digits_;
+        i--;
+        std::size_t low_sz = chunk_chars << i;
+
+        natural high;
+        high.from_decimal(v, v_sz - low_sz, powers, i + 1);
+
+        natural low;
+        low.from_decimal(v + v_sz - low_sz, low_sz, powers, i);
+
+        *this = high * powers[i];
+        *this += low;
+    }
+
+    /*
+     * Set this number from a string of v_sz decimal characters, precomputing the powers of
+     * 10 we'll need to recombine the parts of the string.
+     */
+    auto natural::from_decimal(const char *v, std::size_t v_sz) -> void {
+        std::vector<natural> powers;
+        const std::size_t chunk_chars = natural_decimal_chunk_chars();
+        if (v_sz >= (__digit_array_decimal_threshold * chunk_chars)) {
+            natural p(natural_decimal_chunk());
+            std::size_t p_chars = chunk_chars;
+            while ((2 * p_chars) <= v_sz) {
+                powers.emplace_back(p);
+                p = p.square();
+                p_chars *= 2;
+            }
+        }
+
+        from_decimal(v, v_sz, powers.data(), powers.size());
+    }
+
+    /*
+     * Set this number from a string of v_sz characters in base 2^bits.
+     *
+     * Each character maps directly to a group of bits, so we can pack them into our digits,
+     * starting from the least significant end of the string, without any multiplies.
+     */
+    auto natural::from_power_of_2(const char *v, std::size_t v_sz, unsigned int bits) -> void {
+        natural_digit base = static_cast<natural_digit>(1 << bits);
+
+        num_digits_ = 0;
+        reserve(((v_sz * bits) / natural_digit_bits) + 1);
 
+        natural_double_digit acc = 0;
+        unsigned int acc_bits = 0;
+        std::size_t idx = v_sz;
         std::size_t i = 0;
-        do {
-            natural_digit m = static_cast<natural_digit>(-1);
-            this_digits[i++] = static_cast<natural_digit>(v & m);
-#if defined(C8_DIGIT_8_BITS) || defined(C8_DIGIT_16_BITS) || defined(C8_DIGIT_32_BITS)
-            v >>= natural_digit_bits;
-#else
-            v = 0;
-#endif
-        } while (v);
+        while (idx) {
+            natural_double_digit c_digit = convert_char_to_natural_digit(v[--idx], base);
+            acc = static_cast<natural_double_digit>(acc | (c_digit << acc_bits));
+            acc_bits += bits;
+            if (acc_bits >= natural_digit_bits) {
+                digits_[i++] = static_cast<natural_digit>(acc);
+                acc >>= natural_digit_bits;
+                acc_bits -= static_cast<unsigned int>(natural_digit_bits);
+            }
+        }
+
+        if (acc_bits) {
+            digits_[i++] = static_cast<natural_digit>(acc);
+        }
+
+        while (i && !digits_[i - 1]) {
+            i--;
+        }
 
         num_digits_ = i;
     }
@@ -198,46 +457,15 @@ namespace c8 {
             }
         }
 
-        natural res;
-        res.expand((((v_sz - idx) * 4) + 31) / 32);
-
-        unsigned int chars_per_digit = 1;
-
-        if (sizeof(natural_digit) > 1) {
-            chars_per_digit = 3;
-        }
-
-        if (sizeof(natural_digit) > 2) {
-            chars_per_digit = 7;
-        }
-
-        if (sizeof(natural_digit) > 4) {
-            chars_per_digit = 15;
-        }
-
-        unsigned int char_count = static_cast<unsigned int>(v_sz - idx);
-        for (unsigned int i = 0; i < char_count; i += chars_per_digit) {
-            natural_digit base_div = base;
+        const char *v_chars = v.data() + idx;
+        std::size_t char_count = v_sz - idx;
 
-            natural_digit acc = convert_char_to_natural_digit(v[idx++], base);
-
-            if ((char_count - i) < chars_per_digit) {
-                chars_per_digit = char_count - i;
-            }
-
-            for (unsigned int j = 1; j < chars_per_digit; j++) {
-                natural_digit c_digit = convert_char_to_natural_digit(v[idx++], base);
-                acc = static_cast<natural_digit>((acc * base) + c_digit);
-                base_div = static_cast<natural_digit>(base_div * base);
-            }
-
-            digit_array_multiply(res.digits_, res.num_digits_, res.digits_, res.num_digits_, &base_div, 1);
-            if (acc) {
-                digit_array_add(res.digits_, res.num_digits_, res.digits_, res.num_digits_, &acc, 1);
-            }
+        if (base != 10) {
+            from_power_of_2(v_chars, char_count, (base == 16) ? 4 : 3);
+            return;
         }
 
-        *this = std::move(res);
+        from_decimal(v_chars, char_count);
     }
 
     /*
@@ -296,6 +524,62 @@ namespace c8 {
         return digit_array_compare_le(digits_, num_digits_, v.digits_, v.num_digits_);
     }
 
+    /*
+     * Return true if this number is equal to an unsigned long long integer, false if it's not.
+     */
+    auto natural::operator ==(unsigned long long v) const noexcept -> bool {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        return digit_array_compare_eq(digits_, num_digits_, v_digits, v_num_digits);
+    }
+
+    /*
+     * Return true if this number is not equal to an unsigned long long integer, false if it's equal.
+     */
+    auto natural::operator !=(unsigned long long v) const noexcept -> bool {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        return digit_array_compare_ne(digits_, num_digits_, v_digits, v_num_digits);
+    }
+
+    /*
+     * Return true if this number is greater than an unsigned long long integer, false if it's not.
+     */
+    auto natural::operator >(unsigned long long v) const noexcept -> bool {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        return digit_array_compare_gt(digits_, num_digits_, v_digits, v_num_digits);
+    }
+
+    /*
+     * Return true if this number is greater than, or equal to, an unsigned long long integer, false
+     * if it's not.
+     */
+    auto natural::operator >=(unsigned long long v) const noexcept -> bool {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        return digit_array_compare_ge(digits_, num_digits_, v_digits, v_num_digits);
+    }
+
+    /*
+     * Return true if this number is less than an unsigned long long integer, false if it's not.
+     */
+    auto natural::operator <(unsigned long long v) const noexcept -> bool {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        return digit_array_compare_lt(digits_, num_digits_, v_digits, v_num_digits);
+    }
+
+    /*
+     * Return true if this number is less than, or equal to, an unsigned long long integer, false if
+     * it's not.
+     */
+    auto natural::operator <=(unsigned long long v) const noexcept -> bool {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        return digit_array_compare_le(digits_, num_digits_, v_digits, v_num_digits);
+    }
+
     /*
      * Copy assignment operator.
      */
@@ -454,10 +738,14 @@ namespace c8 {
     auto natural::operator *(const natural &v) const -> natural {
         natural res;
 
+        /*
+         * We reserve one digit more than the product can need, so that if the product is a
+         * temporary then adding to it, as in a * b + c, doesn't need to reallocate.
+         */
         std::size_t v_num_digits = v.num_digits_;
         std::size_t this_num_digits = num_digits_;
         std::size_t res_num_digits = this_num_digits + v_num_digits;
-        res.reserve(res_num_digits);
+        res.reserve(res_num_digits + 1);
         digit_array_multiply(res.digits_, res.num_digits_, digits_, this_num_digits, v.digits_, v_num_digits);
         return res;
     }
@@ -474,6 +762,18 @@ namespace c8 {
         return *this;
     }
 
+    /*
+     * Square this natural number.
+     */
+    auto natural::square() const -> natural {
+        natural res;
+
+        std::size_t this_num_digits = num_digits_;
+        res.reserve(2 * this_num_digits);
+        digit_array_square(res.digits_, res.num_digits_, digits_, this_num_digits);
+        return res;
+    }
+
     /*
      * Divide this natural number by another one, returning the quotient and remainder.
      */
@@ -498,9 +798,9 @@ namespace c8 {
         std::size_t this_num_digits = num_digits_;
         quotient.reserve(this_num_digits);
         std::size_t v_num_digits = v.num_digits_;
-        natural_digit remainder_digits[v_num_digits];
+        digit_array_scratch remainder_digits(v_num_digits);
         std::size_t remainder_num_digits;
-        digit_array_divide_modulus(quotient.digits_, quotient.num_digits_, remainder_digits, remainder_num_digits,
+        digit_array_divide_modulus(quotient.digits_, quotient.num_digits_, remainder_digits.get(), remainder_num_digits,
                                    digits_, this_num_digits, v.digits_, v_num_digits);
         return quotient;
     }
@@ -510,9 +810,9 @@ namespace c8 {
      */
     auto natural::operator /=(const natural &v) -> natural & {
         std::size_t v_num_digits = v.num_digits_;
-        natural_digit remainder_digits[v_num_digits];
+        digit_array_scratch remainder_digits(v_num_digits);
         std::size_t remainder_num_digits;
-        digit_array_divide_modulus(digits_, num_digits_, remainder_digits, remainder_num_digits,
+        digit_array_divide_modulus(digits_, num_digits_, remainder_digits.get(), remainder_num_digits,
                                    digits_, num_digits_, v.digits_, v_num_digits);
         return *this;
     }
@@ -524,11 +824,11 @@ namespace c8 {
         natural remainder;
 
         std::size_t this_num_digits = num_digits_;
-        natural_digit quotient_digits[this_num_digits];
+        digit_array_scratch quotient_digits(this_num_digits);
         std::size_t v_num_digits = v.num_digits_;
         remainder.reserve(v_num_digits);
         std::size_t quotient_num_digits;
-        digit_array_divide_modulus(quotient_digits, quotient_num_digits, remainder.digits_, remainder.num_digits_,
+        digit_array_divide_modulus(quotient_digits.get(), quotient_num_digits, remainder.digits_, remainder.num_digits_,
                                    digits_, this_num_digits, v.digits_, v_num_digits);
         return remainder;
     }
@@ -538,94 +838,1321 @@ namespace c8 {
      */
     auto natural::operator %=(const natural &v) -> natural & {
         std::size_t this_num_digits = num_digits_;
-        natural_digit quotient_digits[this_num_digits];
+        digit_array_scratch quotient_digits(this_num_digits);
         std::size_t quotient_num_digits;
-        digit_array_divide_modulus(quotient_digits, quotient_num_digits, digits_, num_digits_,
+        digit_array_divide_modulus(quotient_digits.get(), quotient_num_digits, digits_, num_digits_,
                                    digits_, this_num_digits, v.digits_, v.num_digits_);
         return *this;
     }
 
     /*
-     * Find the greatest common divisor of this and another natural number.
+     * Add an unsigned long long integer to this natural number.
+     *
+     * The operand is unpacked straight into a digit array on the stack rather than via a
+     * temporary natural number, so for the common case this goes directly to the _m_1 kernels.
      */
-    auto natural::gcd(const natural &v) const -> natural {
-        natural num2;
-
-        /*
-         * If either this number or v are zero then our GCD is just the non-zero value.
-         */
-        std::size_t v_num_digits = v.num_digits_;
-        if (!v.num_digits_) {
-            num2 = *this;
-            return num2;
-        }
+    auto natural::operator +(unsigned long long v) const -> natural {
+        natural res;
 
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
         std::size_t this_num_digits = num_digits_;
-        if (!num_digits_) {
-            num2 = v;
-            return num2;
-        }
-
-        /*
-         * We're going to use Euclid's algorithm.  We need to know which is the larger
-         * of our two numbers and we'll call that num1, while the smaller will be num2.
-         */
-        natural num1;
-        if (digit_array_compare_lt(digits_, this_num_digits, v.digits_, v_num_digits)) {
-            num1 = v;
-            num2 = *this;
-        } else {
-            num1 = *this;
-            num2 = v;
-        }
+        std::size_t max_num_digits = (v_num_digits > this_num_digits) ? v_num_digits : this_num_digits;
+        res.reserve(max_num_digits + 1);
+        digit_array_add(res.digits_, res.num_digits_, digits_, this_num_digits, v_digits, v_num_digits);
+        return res;
+    }
 
-        /*
-         * We never actually use the quotient - this is just somewhere to dump the output.
-         */
-        natural_digit quotient_digits[num1.num_digits_ - num2.num_digits_ + 1];
-        std::size_t quotient_num_digits;
+    /*
+     * Add an unsigned long long integer to this natural number.
+     */
+    auto natural::operator +=(unsigned long long v) -> natural & {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        std::size_t this_num_digits = num_digits_;
+        std::size_t max_num_digits = (v_num_digits > this_num_digits) ? v_num_digits : this_num_digits;
+        expand(max_num_digits + 1);
+        digit_array_add(digits_, num_digits_, digits_, this_num_digits, v_digits, v_num_digits);
+        return *this;
+    }
 
-        /*
-         * Euler's algorithm is essentially to take the modulus of num1 and num2 and check
-         * if the result is zero.  If it is zero then num2 is the GCD.  If it's not zero then
-         * try again, but replacing num1 with num2 and num2 with the modulus from the previous
-         * attempt.  We iterate thus:
-         *
-         * r0 = num1 % num2
-         * r1 = num2 % r0
-         * r2 = r0 % r1
-         * r3 = r1 % r2
-         * ...
-         *
-         * We can implement a very efficient version of this with in-place modulus operations
-         * if we observe that the dividend in each case is never used and can thus be overwritten.
-         * When we do this we unroll into an iterating pair of operations:
-         *
-         * num1 = num1 % num2
-         * num2 = num2 % num1
-         */
-        while (true) {
-            digit_array_divide_modulus(quotient_digits, quotient_num_digits, num1.digits_, num1.num_digits_,
-                                       num1.digits_, num1.num_digits_, num2.digits_, num2.num_digits_);
-            if (!num1.num_digits_) {
-                break;
-            }
+    /*
+     * Subtract an unsigned long long integer from this natural number.
+     */
+    auto natural::operator -(unsigned long long v) const -> natural {
+        natural res;
 
-            digit_array_divide_modulus(quotient_digits, quotient_num_digits, num2.digits_, num2.num_digits_,
-                                       num2.digits_, num2.num_digits_, num1.digits_, num1.num_digits_);
-            if (!num2.num_digits_) {
-                num2.steal_digits(num1);
-                break;
-            }
-        }
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        std::size_t this_num_digits = num_digits_;
+        res.reserve(this_num_digits);
+        digit_array_subtract(res.digits_, res.num_digits_, digits_, this_num_digits, v_digits, v_num_digits);
+        return res;
+    }
 
-        return num2;
+    /*
+     * Subtract an unsigned long long integer from this natural number.
+     */
+    auto natural::operator -=(unsigned long long v) -> natural & {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        digit_array_subtract(digits_, num_digits_, digits_, num_digits_, v_digits, v_num_digits);
+        return *this;
     }
 
     /*
-     * Convert this natural number to an unsigned long long.
+     * Multiply this natural number by an unsigned long long integer.
      */
-    auto natural::to_unsigned_long_long() const -> unsigned long long {
+    auto natural::operator *(unsigned long long v) const -> natural {
+        natural res;
+
+        /*
+         * As with the natural number version, reserve one spare digit so that adding to a
+         * temporary product doesn't need to reallocate.
+         */
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        std::size_t this_num_digits = num_digits_;
+        res.reserve(this_num_digits + v_num_digits + 1);
+        digit_array_multiply(res.digits_, res.num_digits_, digits_, this_num_digits, v_digits, v_num_digits);
+        return res;
+    }
+
+    /*
+     * Multiply this natural number by an unsigned long long integer.
+     */
+    auto natural::operator *=(unsigned long long v) -> natural & {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        std::size_t this_num_digits = num_digits_;
+        expand(this_num_digits + v_num_digits);
+        digit_array_multiply(digits_, num_digits_, digits_, this_num_digits, v_digits, v_num_digits);
+        return *this;
+    }
+
+    /*
+     * Divide this natural number by an unsigned long long integer, returning the quotient.
+     */
+    auto natural::operator /(unsigned long long v) const -> natural {
+        natural quotient;
+
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        std::size_t this_num_digits = num_digits_;
+        quotient.reserve(this_num_digits);
+        natural_digit remainder_digits[natural_ull_digits];
+        std::size_t remainder_num_digits;
+        digit_array_divide_modulus(quotient.digits_, quotient.num_digits_, remainder_digits, remainder_num_digits,
+                                   digits_, this_num_digits, v_digits, v_num_digits);
+        return quotient;
+    }
+
+    /*
+     * Divide this natural number by an unsigned long long integer, returning the quotient.
+     */
+    auto natural::operator /=(unsigned long long v) -> natural & {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        natural_digit remainder_digits[natural_ull_digits];
+        std::size_t remainder_num_digits;
+        digit_array_divide_modulus(digits_, num_digits_, remainder_digits, remainder_num_digits,
+                                   digits_, num_digits_, v_digits, v_num_digits);
+        return *this;
+    }
+
+    /*
+     * Divide this natural number by an unsigned long long integer, returning the remainder.
+     */
+    auto natural::operator %(unsigned long long v) const -> natural {
+        natural remainder;
+
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        std::size_t this_num_digits = num_digits_;
+        digit_array_scratch quotient_digits(this_num_digits);
+        remainder.reserve(v_num_digits);
+        std::size_t quotient_num_digits;
+        digit_array_divide_modulus(quotient_digits.get(), quotient_num_digits, remainder.digits_, remainder.num_digits_,
+                                   digits_, this_num_digits, v_digits, v_num_digits);
+        return remainder;
+    }
+
+    /*
+     * Divide this natural number by an unsigned long long integer, returning the remainder.
+     */
+    auto natural::operator %=(unsigned long long v) -> natural & {
+        natural_digit v_digits[natural_ull_digits];
+        std::size_t v_num_digits = natural_ull_to_digits(v_digits, v);
+        std::size_t this_num_digits = num_digits_;
+        digit_array_scratch quotient_digits(this_num_digits);
+        std::size_t quotient_num_digits;
+        digit_array_divide_modulus(quotient_digits.get(), quotient_num_digits, digits_, num_digits_,
+                                   digits_, this_num_digits, v_digits, v_num_digits);
+        return *this;
+    }
+
+    /*
+     * Set this natural number to the product of two others.
+     *
+     * Either, or both, of v and u may be this natural number.  We reuse our existing digits
+     * if they're large enough, and otherwise reserve one digit more than the product can
+     * need, so that a further addmul() of a product no larger than this one doesn't
+     * need to reallocate.
+     */
+    auto natural::assign_multiply(const natural &v, const natural &u) -> void {
+        /*
+         * The digit array multiply can only cope with the result overlapping its first
+         * operand, so make sure that's the one that aliases us.
+         */
+        const natural *src1 = &v;
+        const natural *src2 = &u;
+        if (src2 == this) {
+            std::swap(src1, src2);
+        }
+
+        std::size_t src1_num_digits = src1->num_digits_;
+        std::size_t src2_num_digits = src2->num_digits_;
+        std::size_t res_num_digits = src1_num_digits + src2_num_digits;
+        if (src1 == this) {
+            expand(res_num_digits + 1);
+        } else {
+            reserve(res_num_digits + 1);
+        }
+
+        digit_array_multiply(digits_, num_digits_, src1->digits_, src1_num_digits, src2->digits_, src2_num_digits);
+    }
+
+    /*
+     * Add the product of two natural numbers to this one.
+     */
+    auto natural::addmul(const natural &v, const natural &u) -> natural & {
+        std::size_t v_num_digits = v.num_digits_;
+        std::size_t u_num_digits = u.num_digits_;
+        if (C8_UNLIKELY(!v_num_digits || !u_num_digits)) {
+            return *this;
+        }
+
+        std::size_t this_num_digits = num_digits_;
+        std::size_t prod_num_digits = v_num_digits + u_num_digits;
+        std::size_t max_num_digits = (prod_num_digits > this_num_digits) ? prod_num_digits : this_num_digits;
+        expand(max_num_digits + 1);
+
+        /*
+         * If we're also one of the operands then we have to form the product before we
+         * start to change our digits.
+         */
+        if (C8_UNLIKELY((&v == this) || (&u == this))) {
+            digit_array_scratch prod_digits(prod_num_digits);
+            natural_digit *prod = prod_digits.get();
+            digit_array_multiply(prod, prod_num_digits, v.digits_, v_num_digits, u.digits_, u_num_digits);
+            digit_array_add(digits_, num_digits_, digits_, this_num_digits, prod, prod_num_digits);
+            return *this;
+        }
+
+        digit_array_addmul(digits_, num_digits_, v.digits_, v_num_digits, u.digits_, u_num_digits);
+        return *this;
+    }
+
+    /*
+     * Subtract the product of two natural numbers from this one.
+     */
+    auto natural::submul(const natural &v, const natural &u) -> natural & {
+        multiply_subtract(v, u, false);
+        return *this;
+    }
+
+    /*
+     * Subtract the product of two natural numbers from this one.
+     *
+     * If the product is larger than this number then we either throw a not_a_number
+     * exception, leaving this number unchanged, or, if allow_negative is true, store the
+     * magnitude of the difference and return true.
+     */
+    auto natural::multiply_subtract(const natural &v, const natural &u, bool allow_negative) -> bool {
+        std::size_t v_num_digits = v.num_digits_;
+        std::size_t u_num_digits = u.num_digits_;
+        if (C8_UNLIKELY(!v_num_digits || !u_num_digits)) {
+            return false;
+        }
+
+        /*
+         * Our product has at least v_num_digits + u_num_digits - 1 digits, so if we have
+         * fewer than that then we know the result will be negative.
+         */
+        std::size_t this_num_digits = num_digits_;
+        std::size_t prod_num_digits = v_num_digits + u_num_digits;
+        if (!allow_negative && ((this_num_digits + 1) < prod_num_digits)) {
+            throw not_a_number();
+        }
+
+        std::size_t max_num_digits = (prod_num_digits > this_num_digits) ? prod_num_digits : this_num_digits;
+        expand(max_num_digits);
+
+        /*
+         * If we're also one of the operands then we have to form the product before we
+         * start to change our digits.
+         */
+        if (C8_UNLIKELY((&v == this) || (&u == this))) {
+            digit_array_scratch prod_digits(prod_num_digits);
+            natural_digit *prod = prod_digits.get();
+            digit_array_multiply(prod, prod_num_digits, v.digits_, v_num_digits, u.digits_, u_num_digits);
+            if (digit_array_compare_le(prod, prod_num_digits, digits_, this_num_digits)) {
+                digit_array_subtract(digits_, num_digits_, digits_, this_num_digits, prod, prod_num_digits);
+                return false;
+            }
+
+            if (!allow_negative) {
+                throw not_a_number();
+            }
+
+            digit_array_subtract(digits_, num_digits_, prod, prod_num_digits, digits_, this_num_digits);
+            return true;
+        }
+
+        bool negative = digit_array_submul(digits_, num_digits_, v.digits_, v_num_digits, u.digits_, u_num_digits);
+
+        /*
+         * If we can't be negative then put things back.  We hold the product minus our
+         * original value, so subtracting the product again gives us the magnitude of our
+         * original value.
+         */
+        if (C8_UNLIKELY(negative && !allow_negative)) {
+            digit_array_submul(digits_, num_digits_, v.digits_, v_num_digits, u.digits_, u_num_digits);
+            throw not_a_number();
+        }
+
+        return negative;
+    }
+
+    /*
+     * Set this natural number to the product of two others, modulo a third.
+     *
+     * Any of v, u and m may be this natural number.  The product and the quotient only
+     * ever live in scratch space, so the remainder is the only thing we might allocate.
+     */
+    auto natural::multiply_modulus(const natural &v, const natural &u, const natural &m) -> void {
+        std::size_t m_num_digits = m.num_digits_;
+        if (C8_UNLIKELY(!m_num_digits)) {
+            throw divide_by_zero();
+        }
+
+        std::size_t v_num_digits = v.num_digits_;
+        std::size_t u_num_digits = u.num_digits_;
+        if (C8_UNLIKELY(!v_num_digits || !u_num_digits)) {
+            num_digits_ = 0;
+            return;
+        }
+
+        std::size_t prod_num_digits = v_num_digits + u_num_digits;
+        digit_array_scratch prod_digits(prod_num_digits);
+        natural_digit *prod = prod_digits.get();
+        digit_array_multiply(prod, prod_num_digits, v.digits_, v_num_digits, u.digits_, u_num_digits);
+
+        digit_array_scratch quotient_digits(prod_num_digits);
+        std::size_t quotient_num_digits;
+
+        /*
+         * If we're also the modulus then we can't write the remainder until the divide
+         * has finished with it.
+         */
+        if (C8_UNLIKELY(&m == this)) {
+            digit_array_scratch remainder_digits(m_num_digits);
+            std::size_t remainder_num_digits;
+            digit_array_divide_modulus(quotient_digits.get(), quotient_num_digits,
+                                       remainder_digits.get(), remainder_num_digits,
+                                       prod, prod_num_digits, m.digits_, m_num_digits);
+            digit_array_copy(digits_, remainder_digits.get(), remainder_num_digits);
+            num_digits_ = remainder_num_digits;
+            return;
+        }
+
+        reserve(m_num_digits);
+        digit_array_divide_modulus(quotient_digits.get(), quotient_num_digits, digits_, num_digits_,
+                                   prod, prod_num_digits, m.digits_, m_num_digits);
+    }
+
+    /*
+     * Compute floor(2^2k / v), where v has exactly k bits.
+     *
+     * We use Newton's method, x' = x + x(2^2k - v.x) / 2^2k, doubling the precision at each
+     * step.  Our first approximation comes from recursively finding the reciprocal of the
+     * top half of v's bits, and one Newton step then leaves us within a few units of the
+     * correct result.
+     */
+    static auto natural_reciprocal(const natural &v, std::size_t k) -> natural {
+        natural p = natural(1) << static_cast<unsigned int>(2 * k);
+
+        /*
+         * Small reciprocals are cheaper to compute with a single divide.
+         */
+        if (k <= (16 * natural_digit_bits)) {
+            return p / v;
+        }
+
+        std::size_t h = (k / 2) + 1;
+        auto shift = static_cast<unsigned int>(k - h);
+        auto x = natural_reciprocal(v >> shift, h) << shift;
+
+        auto e = v * x;
+        if (e <= p) {
+            x += (x * (p - e)) >> static_cast<unsigned int>(2 * k);
+        } else {
+            x -= ((x * (e - p)) >> static_cast<unsigned int>(2 * k)) + 1;
+        }
+
+        /*
+         * Correct our estimate.
+         */
+        e = v * x;
+        while (e > p) {
+            x -= 1;
+            e -= v;
+        }
+
+        auto r = p - e;
+        while (r >= v) {
+            x += 1;
+            r -= v;
+        }
+
+        return x;
+    }
+
+    /*
+     * Construct a divisor from a natural number.
+     */
+    natural_divisor::natural_divisor(const natural &v) : divisor_(v) {
+        if (v.is_zero()) {
+            throw divide_by_zero();
+        }
+
+        /*
+         * Normalize the divisor.  We want our divisor to be aligned such that it's most
+         * significant digit has its top bit set.
+         */
+        auto divisor_bits = v.size_bits();
+        normalize_shift_ = static_cast<unsigned int>((natural_digit_bits - (divisor_bits & (natural_digit_bits - 1))) & (natural_digit_bits - 1));
+        normalized_ = v << normalize_shift_;
+
+        /*
+         * Large divisors are quicker to use via their reciprocal.
+         */
+        auto normalized_bits = normalized_.size_bits();
+        if ((normalized_bits / natural_digit_bits) >= __digit_array_reciprocal_threshold) {
+            reciprocal_ = natural_reciprocal(normalized_, normalized_bits);
+        }
+    }
+
+    /*
+     * Divide this natural number by a precomputed divisor, returning the quotient and remainder.
+     */
+    auto natural::divide_modulus(const natural_divisor &v) const -> std::pair<natural, natural> {
+        std::pair<natural, natural> p;
+
+        std::size_t this_num_digits = num_digits_;
+        p.first.reserve(this_num_digits);
+        std::size_t v_num_digits = v.divisor_.num_digits_;
+        p.second.reserve(v_num_digits);
+        digit_array_divide_modulus_precomputed(p.first.digits_, p.first.num_digits_, p.second.digits_, p.second.num_digits_,
+                                               digits_, this_num_digits, v.divisor_.digits_, v_num_digits, v.normalized_.digits_,
+                                               v.reciprocal_.digits_, v.reciprocal_.num_digits_, v.normalize_shift_);
+        return p;
+    }
+
+    /*
+     * Divide this natural number by a precomputed divisor, returning the quotient.
+     */
+    auto natural::operator /(const natural_divisor &v) const -> natural {
+        natural quotient;
+
+        std::size_t this_num_digits = num_digits_;
+        quotient.reserve(this_num_digits);
+        std::size_t v_num_digits = v.divisor_.num_digits_;
+        digit_array_scratch remainder_digits(v_num_digits);
+        std::size_t remainder_num_digits;
+        digit_array_divide_modulus_precomputed(quotient.digits_, quotient.num_digits_, remainder_digits.get(), remainder_num_digits,
+                                               digits_, this_num_digits, v.divisor_.digits_, v_num_digits, v.normalized_.digits_,
+                                               v.reciprocal_.digits_, v.reciprocal_.num_digits_, v.normalize_shift_);
+        return quotient;
+    }
+
+    /*
+     * Divide this natural number by a precomputed divisor, returning the quotient.
+     */
+    auto natural::operator /=(const natural_divisor &v) -> natural & {
+        std::size_t v_num_digits = v.divisor_.num_digits_;
+        digit_array_scratch remainder_digits(v_num_digits);
+        std::size_t remainder_num_digits;
+        digit_array_divide_modulus_precomputed(digits_, num_digits_, remainder_digits.get(), remainder_num_digits,
+                                               digits_, num_digits_, v.divisor_.digits_, v_num_digits, v.normalized_.digits_,
+                                               v.reciprocal_.digits_, v.reciprocal_.num_digits_, v.normalize_shift_);
+        return *this;
+    }
+
+    /*
+     * Divide this natural number by a precomputed divisor, returning the remainder.
+     */
+    auto natural::operator %(const natural_divisor &v) const -> natural {
+        natural remainder;
+
+        std::size_t this_num_digits = num_digits_;
+        digit_array_scratch quotient_digits(this_num_digits);
+        std::size_t v_num_digits = v.divisor_.num_digits_;
+        remainder.reserve(v_num_digits);
+        std::size_t quotient_num_digits;
+        digit_array_divide_modulus_precomputed(quotient_digits.get(), quotient_num_digits, remainder.digits_, remainder.num_digits_,
+                                               digits_, this_num_digits, v.divisor_.digits_, v_num_digits, v.normalized_.digits_,
+                                               v.reciprocal_.digits_, v.reciprocal_.num_digits_, v.normalize_shift_);
+        return remainder;
+    }
+
+    /*
+     * Divide this natural number by a precomputed divisor, returning the remainder.
+     */
+    auto natural::operator %=(const natural_divisor &v) -> natural & {
+        std::size_t this_num_digits = num_digits_;
+        digit_array_scratch quotient_digits(this_num_digits);
+        std::size_t quotient_num_digits;
+        digit_array_divide_modulus_precomputed(quotient_digits.get(), quotient_num_digits, digits_, num_digits_,
+                                               digits_, this_num_digits, v.divisor_.digits_, v.divisor_.num_digits_, v.normalized_.digits_,
+                                               v.reciprocal_.digits_, v.reciprocal_.num_digits_, v.normalize_shift_);
+        return *this;
+    }
+
+    /*
+     * A signed natural number.  We only need these for the cofactors used in our half-GCD.
+     */
+    struct natural_signed {
+        natural magnitude;
+        bool negative;
+    };
+
+    /*
+     * Add two signed natural numbers.
+     */
+    static auto natural_signed_add(const natural_signed &v, const natural_signed &u) -> natural_signed {
+        natural_signed res;
+
+        if (v.negative == u.negative) {
+            res.magnitude = v.magnitude + u.magnitude;
+            res.negative = v.negative;
+        } else if (v.magnitude >= u.magnitude) {
+            res.magnitude = v.magnitude - u.magnitude;
+            res.negative = v.negative;
+        } else {
+            res.magnitude = u.magnitude - v.magnitude;
+            res.negative = u.negative;
+        }
+
+        if (res.magnitude.is_zero()) {
+            res.negative = false;
+        }
+
+        return res;
+    }
+
+    /*
+     * Multiply a signed natural number by another, where the second is given as a magnitude
+     * and a sign.
+     */
+    static auto natural_signed_multiply(const natural_signed &v, const natural &u, bool u_negative) -> natural_signed {
+        natural_signed res;
+        res.magnitude = v.magnitude * u;
+        res.negative = (v.negative != u_negative) && !res.magnitude.is_zero();
+        return res;
+    }
+
+    /*
+     * A 2x2 matrix of signed cofactors, t, that records how the half-GCD has transformed a
+     * pair of numbers, a and b.  The transformed values are a' = t00.a + t01.b and
+     * b' = t10.a + t11.b.
+     *
+     * Every step we take is unimodular (its determinant is 1 or -1), so a' and b' always have
+     * the same GCD as a and b.
+     *
+     * Each column is updated independently of the other, so if we only need the cofactors
+     * of a then we can save time by only tracking the first column.  If we only need the
+     * transformed values, and not the cofactors at all, then we track no columns.
+     */
+    struct natural::hgcd_matrix {
+        natural_signed m_[2][2];
+        std::size_t columns_;
+
+        hgcd_matrix(std::size_t columns = 2) {
+            m_[0][0] = natural_signed{natural(1), false};
+            m_[0][1] = natural_signed{natural(), false};
+            m_[1][0] = natural_signed{natural(), false};
+            m_[1][1] = natural_signed{natural(1), false};
+            columns_ = columns;
+        }
+
+        /*
+         * Record a Lehmer step with cofactors c (see digit_array_gcd_lehmer()).
+         */
+        auto lehmer_step(const natural_digit *c, bool negative) -> void {
+            natural c0(c[0]);
+            natural c1(c[1]);
+            natural c2(c[2]);
+            natural c3(c[3]);
+
+            for (std::size_t j = 0; j < columns_; j++) {
+                auto r0 = natural_signed_add(natural_signed_multiply(m_[0][j], c0, negative),
+                                             natural_signed_multiply(m_[1][j], c1, !negative));
+                auto r1 = natural_signed_add(natural_signed_multiply(m_[1][j], c3, negative),
+                                             natural_signed_multiply(m_[0][j], c2, !negative));
+                m_[0][j] = std::move(r0);
+                m_[1][j] = std::move(r1);
+            }
+        }
+
+        /*
+         * Record a division step with quotient q, where a' = b and b' = a - q.b.
+         */
+        auto divide_step(const natural &q) -> void {
+            for (std::size_t j = 0; j < columns_; j++) {
+                auto r1 = natural_signed_add(m_[0][j], natural_signed_multiply(m_[1][j], q, true));
+                m_[0][j] = std::move(m_[1][j]);
+                m_[1][j] = std::move(r1);
+            }
+        }
+
+        /*
+         * Negate row i, after we've had to negate the corresponding transformed value.
+         */
+        auto negate_row(std::size_t i) -> void {
+            for (std::size_t j = 0; j < columns_; j++) {
+                m_[i][j].negative = !m_[i][j].negative && !m_[i][j].magnitude.is_zero();
+            }
+        }
+
+        /*
+         * Swap our rows, after we've had to swap the transformed values.
+         */
+        auto swap_rows() -> void {
+            std::swap(m_[0], m_[1]);
+        }
+
+        /*
+         * Follow our transformation with another one, u.
+         */
+        auto multiply(const hgcd_matrix &u) -> void {
+            if (!columns_) {
+                return;
+            }
+
+            hgcd_matrix res(columns_);
+
+            for (std::size_t i = 0; i < 2; i++) {
+                for (std::size_t j = 0; j < columns_; j++) {
+                    res.m_[i][j] = natural_signed_add(natural_signed_multiply(m_[0][j], u.m_[i][0].magnitude, u.m_[i][0].negative),
+                                                      natural_signed_multiply(m_[1][j], u.m_[i][1].magnitude, u.m_[i][1].negative));
+                }
+            }
+
+            *this = std::move(res);
+        }
+    };
+
+    /*
+     * Perform one step of Euclid's algorithm on a and b, where a >= b, updating t with the
+     * transformation applied.  We use a Lehmer step if we can, and a divide if not.
+     */
+    auto natural::gcd_step(natural &a, natural &b, hgcd_matrix &t) -> void {
+        natural_digit c[4];
+        bool negative;
+        if ((b.num_digits_ > 1) && digit_array_gcd_lehmer(a.digits_, a.num_digits_, b.digits_, b.num_digits_, c, negative)) {
+            t.lehmer_step(c, negative);
+            return;
+        }
+
+        auto qr = a.divide_modulus(b);
+        a = std::move(b);
+        b = std::move(qr.second);
+        t.divide_step(qr.first);
+    }
+
+    /*
+     * Reduce a and b, where a >= b, using a half-GCD of just their digits above the first k,
+     * and update t with the transformation applied.
+     *
+     * The half-GCD transforms the top digits of a and b, a_hi and b_hi, into a_hi' and b_hi'.
+     * Applying the same transformation, u, to all of a and b gives us a' = a_hi'.B^k +
+     * u00.a_lo + u01.b_lo, and similarly for b'.  The cofactors are about half the size of
+     * a_hi and b_hi, so a' and b' are smaller than a and b by about a quarter of the size of
+     * a_hi.  The low digits can leave either result negative, or out of order, so we correct
+     * for that, and correct u to match.
+     */
+    auto natural::hgcd_reduce(natural &a, natural &b, hgcd_matrix &t, std::size_t k) -> void {
+        auto shift = static_cast<unsigned int>(k * natural_digit_bits);
+        natural a_hi = a >> shift;
+        natural b_hi = b >> shift;
+        natural a_lo = a - (a_hi << shift);
+        natural b_lo = b - (b_hi << shift);
+
+        hgcd_matrix u;
+        hgcd(a_hi, b_hi, u);
+
+        auto ra = natural_signed_add(natural_signed_multiply(u.m_[0][0], a_lo, false),
+                                     natural_signed_multiply(u.m_[0][1], b_lo, false));
+        ra = natural_signed_add(ra, natural_signed{a_hi << shift, false});
+        auto rb = natural_signed_add(natural_signed_multiply(u.m_[1][0], a_lo, false),
+                                     natural_signed_multiply(u.m_[1][1], b_lo, false));
+        rb = natural_signed_add(rb, natural_signed{b_hi << shift, false});
+
+        if (ra.negative) {
+            u.negate_row(0);
+        }
+
+        if (rb.negative) {
+            u.negate_row(1);
+        }
+
+        a = std::move(ra.magnitude);
+        b = std::move(rb.magnitude);
+        if (a < b) {
+            std::swap(a, b);
+            u.swap_rows();
+        }
+
+        t.multiply(u);
+    }
+
+    /*
+     * Half-GCD.  Reduce a and b, where a >= b and a has n digits, until b has no more than
+     * n / 2 digits, and update t with the transformation applied.
+     *
+     * Large numbers are reduced recursively.  A half-GCD of the top half of a and b reduces
+     * them to about 3n / 4 digits, and a second half-GCD of the top n / 2 digits of those
+     * results reduces them to about n / 2 digits.  Each of these only needs multiplies with
+     * cofactors of about n / 4 digits, so with sub-quadratic multiplies the whole GCD is
+     * sub-quadratic too.  Whatever is left over, and all of the work for smaller numbers, is
+     * done with Lehmer steps.
+     */
+    auto natural::hgcd(natural &a, natural &b, hgcd_matrix &t) -> void {
+        std::size_t n = a.num_digits_;
+        std::size_t h = n / 2;
+
+        if (n >= __digit_array_hgcd_threshold) {
+            hgcd_reduce(a, b, t, h);
+
+            /*
+             * If our first reduction made no progress then a second one wouldn't either.
+             */
+            std::size_t m = a.num_digits_;
+            if ((b.num_digits_ > h) && (m < n)) {
+                hgcd_reduce(a, b, t, (2 * h) - m);
+            }
+        }
+
+        while (b.num_digits_ > h) {
+            gcd_step(a, b, t);
+        }
+    }
+
+    /*
+     * Find the greatest common divisor of this and another natural number.
+     */
+    auto natural::gcd(const natural &v) const -> natural {
+        natural num2;
+
+        /*
+         * If either this number or v are zero then our GCD is just the non-zero value.
+         */
+        std::size_t v_num_digits = v.num_digits_;
+        if (!v.num_digits_) {
+            num2 = *this;
+            return num2;
+        }
+
+        std::size_t this_num_digits = num_digits_;
+        if (!num_digits_) {
+            num2 = v;
+            return num2;
+        }
+
+        /*
+         * We're going to use Euclid's algorithm.  We need to know which is the larger
+         * of our two numbers and we'll call that num1, while the smaller will be num2.
+         */
+        natural num1;
+        if (digit_array_compare_lt(digits_, this_num_digits, v.digits_, v_num_digits)) {
+            num1 = v;
+            num2 = *this;
+        } else {
+            num1 = *this;
+            num2 = v;
+        }
+
+        /*
+         * Very large numbers are first reduced with half-GCDs.  Each pass uses the top
+         * two-thirds of the digits of num1 and num2, and removes about a third of their
+         * digits.  If a pass can't make progress, usually because num1 is much larger than
+         * num2, then we take a single Euclid step instead.
+         *
+         * We don't need any cofactors, so our matrix tracks no columns.
+         */
+        hgcd_matrix t(0);
+        while (num2.num_digits_ >= __digit_array_gcd_hgcd_threshold) {
+            std::size_t n = num1.num_digits_ + num2.num_digits_;
+
+            hgcd_reduce(num1, num2, t, num1.num_digits_ / 3);
+            if ((num1.num_digits_ + num2.num_digits_) == n) {
+                gcd_step(num1, num2, t);
+            }
+        }
+
+        /*
+         * We never actually use the quotient - this is just somewhere to dump the output.
+         * No quotient can ever be longer than our larger number.
+         */
+        digit_array_scratch quotient_digits(num1.num_digits_);
+        std::size_t quotient_num_digits;
+
+        /*
+         * Euclid's algorithm is essentially to take the modulus of a and b and check if the
+         * result is zero.  If it is zero then b is the GCD.  If it's not zero then try again,
+         * but replacing a with b and b with the modulus from the previous attempt.
+         *
+         * Most of the quotients in this sequence are very small, so for multi-digit numbers
+         * we use Lehmer's algorithm to find several of them at a time from just the most
+         * significant bits of a and b.  We only need a full divide when a is much larger than
+         * b.  Once b is down to a single digit we do one last divide and then use a binary
+         * GCD on the two remaining digits.
+         */
+        natural *a = &num1;
+        natural *b = &num2;
+        while (b->num_digits_ > 1) {
+            if (C8_LIKELY(digit_array_gcd_lehmer(a->digits_, a->num_digits_, b->digits_, b->num_digits_))) {
+                continue;
+            }
+
+            digit_array_divide_modulus(quotient_digits.get(), quotient_num_digits, a->digits_, a->num_digits_,
+                                       a->digits_, a->num_digits_, b->digits_, b->num_digits_);
+            std::swap(a, b);
+        }
+
+        /*
+         * Our last step may have left b as zero, in which case a is our GCD.
+         */
+        if (!b->num_digits_) {
+            return *a;
+        }
+
+        if (a->num_digits_ > 1) {
+            digit_array_divide_modulus(quotient_digits.get(), quotient_num_digits, a->digits_, a->num_digits_,
+                                       a->digits_, a->num_digits_, b->digits_, b->num_digits_);
+            if (!a->num_digits_) {
+                return *b;
+            }
+        }
+
+        b->digits_[0] = digit_array_gcd_1(a->digits_[0], b->digits_[0]);
+        return *b;
+    }
+
+    /*
+     * Find the greatest common divisor, g, of a and b, along with cofactors s and t such that
+     * g = s.a + t.b.  The cofactors are returned as magnitudes, with separate signs.
+     *
+     * We run the same GCD steps as gcd(), but record each of them in a cofactor matrix.
+     * Once we're done, the top left of the matrix gives us one possible value of s, so we
+     * only need to track the first column.  Any multiple of b / g can be added to s, so we
+     * pick the smallest, |s| <= b / 2g, and then t = (g - s.a) / b.
+     */
+    auto natural::gcdext(const natural &a, const natural &b,
+                         natural &s, bool &s_negative, natural &t, bool &t_negative) -> natural {
+        s_negative = false;
+        t_negative = false;
+
+        if (a < b) {
+            return gcdext(b, a, t, t_negative, s, s_negative);
+        }
+
+        if (b.is_zero()) {
+            s = a.is_zero() ? natural(0) : natural(1);
+            t = natural(0);
+            return a;
+        }
+
+        natural x = a;
+        natural y = b;
+        hgcd_matrix m(1);
+        while (!y.is_zero()) {
+            if (y.num_digits_ >= __digit_array_gcd_hgcd_threshold) {
+                std::size_t n = x.num_digits_ + y.num_digits_;
+                hgcd_reduce(x, y, m, x.num_digits_ / 3);
+                if ((x.num_digits_ + y.num_digits_) != n) {
+                    continue;
+                }
+            }
+
+            gcd_step(x, y, m);
+        }
+
+        /*
+         * Reduce s modulo b / g, into the range (-b / 2g, b / 2g].
+         */
+        natural bg = b / x;
+        s = m.m_[0][0].magnitude % bg;
+        if (m.m_[0][0].negative && !s.is_zero()) {
+            s = bg - s;
+        }
+
+        if ((s << 1) > bg) {
+            s = bg - s;
+            s_negative = true;
+        }
+
+        /*
+         * As a >= b, s can only be zero if b divides a.
+         */
+        if (s.is_zero()) {
+            t = natural(1);
+        } else if (s_negative) {
+            t = (x + (s * a)) / b;
+        } else {
+            t = ((s * a) - x) / b;
+            t_negative = !t.is_zero();
+        }
+
+        return x;
+    }
+
+    /*
+     * Find the inverse of this natural number, modulo m.
+     */
+    auto natural::inverse_mod(const natural &m) const -> natural {
+        if (m.is_zero()) {
+            throw divide_by_zero();
+        }
+
+        natural s;
+        bool s_negative;
+        natural t;
+        bool t_negative;
+        natural g = gcdext(*this % m, m, s, s_negative, t, t_negative);
+        if (g != natural(1)) {
+            throw invalid_argument("not invertible");
+        }
+
+        if (s_negative) {
+            return m - s;
+        }
+
+        return s;
+    }
+
+    /*
+     * Return bit b of a digit array.
+     */
+    static inline auto natural_bit(const natural_digit *p, std::size_t b) -> natural_digit {
+        return static_cast<natural_digit>((p[b / natural_digit_bits] >> (b % natural_digit_bits)) & 1);
+    }
+
+    /*
+     * Pick the window size for a sliding window exponentiation with an exponent of e_bits.
+     * Larger windows need fewer multiplies, but more precomputation.
+     */
+    static auto natural_pow_window_size(std::size_t e_bits) -> std::size_t {
+        if (e_bits > 672) {
+            return 6;
+        }
+
+        if (e_bits > 240) {
+            return 5;
+        }
+
+        if (e_bits > 80) {
+            return 4;
+        }
+
+        if (e_bits > 24) {
+            return 3;
+        }
+
+        if (e_bits > 8) {
+            return 2;
+        }
+
+        return 1;
+    }
+
+    /*
+     * Raise g[0] to the power of a non-zero exponent, e, of e_bits, using a sliding window of
+     * up to k bits, and the modular multiply and square operations provided.  The result is
+     * written to acc.  g must have space for 2^(k - 1) values, each of n digits.
+     *
+     * We precompute the odd powers of our base, up to 2^k - 1, and then scan the exponent
+     * from its most significant bit.  Each zero bit needs one square, while each window of up
+     * to k bits, starting and ending with a one, needs one square per bit and then a single
+     * multiply by one of our precomputed powers.
+     */
+    template <typename M, typename S>
+    static auto natural_pow_window(natural_digit *acc, natural_digit *g, std::size_t n,
+                                   const natural_digit *e, std::size_t e_bits, std::size_t k,
+                                   M multiply, S square) -> void {
+        std::size_t table_size = static_cast<std::size_t>(1) << (k - 1);
+        if (table_size > 1) {
+            square(acc, g);
+            for (std::size_t j = 1; j < table_size; j++) {
+                multiply(&g[j * n], &g[(j - 1) * n], acc);
+            }
+        }
+
+        /*
+         * Our most significant bit is always a one, so our first window simply initializes
+         * our accumulator.
+         */
+        bool first = true;
+        std::size_t i = e_bits;
+        while (i) {
+            if (!natural_bit(e, i - 1)) {
+                square(acc, acc);
+                i--;
+                continue;
+            }
+
+            /*
+             * Find the longest window, of up to k bits, that ends with a one.
+             */
+            std::size_t l = (i < k) ? i : k;
+            while (!natural_bit(e, i - l)) {
+                l--;
+            }
+
+            std::size_t w = 0;
+            for (std::size_t j = 1; j <= l; j++) {
+                w = (w << 1) | natural_bit(e, i - j);
+            }
+
+            const natural_digit *gw = &g[(w >> 1) * n];
+            if (first) {
+                digit_array_copy(acc, gw, n);
+                first = false;
+            } else {
+                for (std::size_t j = 0; j < l; j++) {
+                    square(acc, acc);
+                }
+
+                multiply(acc, acc, gw);
+            }
+
+            i -= l;
+        }
+    }
+
+    /*
+     * Raise this natural number to the power e, modulo m.
+     */
+    auto natural::pow_mod(const natural &e, const natural &m) const -> natural {
+        if (m.is_zero()) {
+            throw divide_by_zero();
+        }
+
+        /*
+         * If our modulus is odd then we can use Montgomery multiplication.
+         */
+        if (m.digits_[0] & 1) {
+            montgomery_context mc(m);
+            return mc.pow_mod(*this, e);
+        }
+
+        /*
+         * Otherwise use Barrett reduction.
+         */
+        barrett_context bc(m);
+        return bc.pow_mod(*this, e);
+    }
+
+    /*
+     * Construct a Montgomery context from an odd modulus.
+     */
+    montgomery_context::montgomery_context(const natural &m) : modulus_(m) {
+        if (m.is_zero()) {
+            throw divide_by_zero();
+        }
+
+        if (!(m.digits_[0] & 1)) {
+            throw invalid_argument("modulus must be odd");
+        }
+
+        inverse_ = digit_array_montgomery_inverse(m.digits_[0]);
+
+        /*
+         * R = B^n is the Montgomery radix.  Multiplying by R^2 and reducing is how we convert
+         * numbers into Montgomery form.
+         */
+        auto n_bits = m.num_digits_ * natural_digit_bits;
+        r2_ = (natural(1) << static_cast<unsigned int>(2 * n_bits)) % m;
+    }
+
+    /*
+     * Load a natural number into a digit array the size of our modulus, reducing it first if
+     * it's not less than the modulus.
+     */
+    auto montgomery_context::load(natural_digit *res, const natural &v) const -> void {
+        std::size_t n = modulus_.num_digits_;
+
+        if (C8_UNLIKELY(v >= modulus_)) {
+            natural t = v % modulus_;
+            digit_array_copy(res, t.digits_, t.num_digits_);
+            digit_array_zero(&res[t.num_digits_], n - t.num_digits_);
+            return;
+        }
+
+        digit_array_copy(res, v.digits_, v.num_digits_);
+        digit_array_zero(&res[v.num_digits_], n - v.num_digits_);
+    }
+
+    /*
+     * Store a digit array the size of our modulus as a natural number.
+     */
+    auto montgomery_context::store(const natural_digit *src) const -> natural {
+        natural res;
+
+        std::size_t n = modulus_.num_digits_;
+        while (n && !src[n - 1]) {
+            n--;
+        }
+
+        res.reserve(n);
+        digit_array_copy(res.digits_, src, n);
+        res.num_digits_ = n;
+        return res;
+    }
+
+    /*
+     * Multiply two natural numbers, modulo our modulus.
+     */
+    auto montgomery_context::mul_mod(const natural &v, const natural &u) const -> natural {
+        std::size_t n = modulus_.num_digits_;
+        digit_array_scratch buf((3 * n) + digit_array_montgomery_scratch_size(n));
+        natural_digit *a = buf.get();
+        natural_digit *b = &a[n];
+        natural_digit *r2 = &b[n];
+        natural_digit *scratch = &r2[n];
+
+        load(a, v);
+        load(b, u);
+        load(r2, r2_);
+
+        /*
+         * Our first multiply gives us v.u / R, and our second multiplies that by R^2 / R.
+         */
+        const natural_digit *m = modulus_.digits_;
+        digit_array_montgomery_multiply(a, a, b, m, n, inverse_, scratch);
+        digit_array_montgomery_multiply(a, a, r2, m, n, inverse_, scratch);
+        return store(a);
+    }
+
+    /*
+     * Square a natural number, modulo our modulus.
+     */
+    auto montgomery_context::sqr_mod(const natural &v) const -> natural {
+        std::size_t n = modulus_.num_digits_;
+        digit_array_scratch buf((2 * n) + digit_array_montgomery_scratch_size(n));
+        natural_digit *a = buf.get();
+        natural_digit *r2 = &a[n];
+        natural_digit *scratch = &r2[n];
+
+        load(a, v);
+        load(r2, r2_);
+
+        const natural_digit *m = modulus_.digits_;
+        digit_array_montgomery_square(a, a, m, n, inverse_, scratch);
+        digit_array_montgomery_multiply(a, a, r2, m, n, inverse_, scratch);
+        return store(a);
+    }
+
+    /*
+     * Raise a natural number to the power e, modulo our modulus, using a sliding window.
+     */
+    auto montgomery_context::pow_mod(const natural &v, const natural &e) const -> natural {
+        std::size_t e_bits = e.size_bits();
+        if (!e_bits) {
+            return natural(1) % modulus_;
+        }
+
+        std::size_t k = natural_pow_window_size(e_bits);
+        std::size_t table_size = static_cast<std::size_t>(1) << (k - 1);
+
+        std::size_t n = modulus_.num_digits_;
+        digit_array_scratch buf((table_size * n) + (3 * n) + digit_array_montgomery_scratch_size(n));
+        natural_digit *g = buf.get();
+        natural_digit *acc = &g[table_size * n];
+        natural_digit *t = &acc[n];
+        natural_digit *scratch = &t[2 * n];
+
+        /*
+         * Convert our base into Montgomery form.
+         */
+        const natural_digit *m = modulus_.digits_;
+        natural_digit m_inverse = inverse_;
+        load(acc, v);
+        load(t, r2_);
+        digit_array_montgomery_multiply(g, acc, t, m, n, m_inverse, scratch);
+
+        natural_pow_window(acc, g, n, e.digits_, e_bits, k,
+                           [=](natural_digit *res, const natural_digit *src1, const natural_digit *src2) {
+                               digit_array_montgomery_multiply(res, src1, src2, m, n, m_inverse, scratch);
+                           },
+                           [=](natural_digit *res, const natural_digit *src) {
+                               digit_array_montgomery_square(res, src, m, n, m_inverse, scratch);
+                           });
+
+        /*
+         * Convert our result out of Montgomery form.
+         */
+        digit_array_copy(t, acc, n);
+        digit_array_zero(&t[n], n);
+        digit_array_montgomery_reduce(acc, t, m, n, m_inverse);
+        return store(acc);
+    }
+
+    /*
+     * Construct a Barrett context from a modulus.
+     */
+    barrett_context::barrett_context(const natural &m) : modulus_(m) {
+        if (m.is_zero()) {
+            throw divide_by_zero();
+        }
+
+        /*
+         * We use B^2n - 1, rather than B^2n, so that mu always fits in n + 1 digits, even
+         * when the modulus is B^(n - 1).
+         */
+        auto n_bits = m.num_digits_ * natural_digit_bits;
+        mu_ = ((natural(1) << static_cast<unsigned int>(2 * n_bits)) - natural(1)) / m;
+    }
+
+    /*
+     * Load a natural number into a digit array the size of our modulus, reducing it first if
+     * it's not less than the modulus.
+     */
+    auto barrett_context::load(natural_digit *res, const natural &v) const -> void {
+        std::size_t n = modulus_.num_digits_;
+
+        if (C8_UNLIKELY(v >= modulus_)) {
+            natural t = reduce(v);
+            digit_array_copy(res, t.digits_, t.num_digits_);
+            digit_array_zero(&res[t.num_digits_], n - t.num_digits_);
+            return;
+        }
+
+        digit_array_copy(res, v.digits_, v.num_digits_);
+        digit_array_zero(&res[v.num_digits_], n - v.num_digits_);
+    }
+
+    /*
+     * Store a digit array the size of our modulus as a natural number.
+     */
+    auto barrett_context::store(const natural_digit *src) const -> natural {
+        natural res;
+
+        std::size_t n = modulus_.num_digits_;
+        while (n && !src[n - 1]) {
+            n--;
+        }
+
+        res.reserve(n);
+        digit_array_copy(res.digits_, src, n);
+        res.num_digits_ = n;
+        return res;
+    }
+
+    /*
+     * Reduce a natural number modulo our modulus.
+     */
+    auto barrett_context::reduce(const natural &v) const -> natural {
+        if (v < modulus_) {
+            return v;
+        }
+
+        /*
+         * Barrett reduction only works for values of up to twice the size of our modulus.
+         */
+        std::size_t n = modulus_.num_digits_;
+        if (C8_UNLIKELY(v.num_digits_ > (2 * n))) {
+            return v % modulus_;
+        }
+
+        digit_array_scratch buf((2 * n) + digit_array_barrett_scratch_size(n));
+        natural_digit *t = buf.get();
+        natural_digit *scratch = &t[2 * n];
+
+        digit_array_copy(t, v.digits_, v.num_digits_);
+        digit_array_zero(&t[v.num_digits_], (2 * n) - v.num_digits_);
+        digit_array_barrett_reduce(t, t, modulus_.digits_, n, mu_.digits_, scratch);
+        return store(t);
+    }
+
+    /*
+     * Multiply two natural numbers, modulo our modulus.
+     */
+    auto barrett_context::mul_mod(const natural &v, const natural &u) const -> natural {
+        std::size_t n = modulus_.num_digits_;
+        digit_array_scratch buf((2 * n) + digit_array_barrett_scratch_size(n));
+        natural_digit *a = buf.get();
+        natural_digit *b = &a[n];
+        natural_digit *scratch = &b[n];
+
+        load(a, v);
+        load(b, u);
+        digit_array_barrett_multiply(a, a, b, modulus_.digits_, n, mu_.digits_, scratch);
+        return store(a);
+    }
+
+    /*
+     * Square a natural number, modulo our modulus.
+     */
+    auto barrett_context::sqr_mod(const natural &v) const -> natural {
+        std::size_t n = modulus_.num_digits_;
+        digit_array_scratch buf(n + digit_array_barrett_scratch_size(n));
+        natural_digit *a = buf.get();
+        natural_digit *scratch = &a[n];
+
+        load(a, v);
+        digit_array_barrett_square(a, a, modulus_.digits_, n, mu_.digits_, scratch);
+        return store(a);
+    }
+
+    /*
+     * Raise a natural number to the power e, modulo our modulus, using a sliding window.
+     */
+    auto barrett_context::pow_mod(const natural &v, const natural &e) const -> natural {
+        std::size_t e_bits = e.size_bits();
+        if (!e_bits) {
+            return natural(1) % modulus_;
+        }
+
+        std::size_t k = natural_pow_window_size(e_bits);
+        std::size_t table_size = static_cast<std::size_t>(1) << (k - 1);
+
+        std::size_t n = modulus_.num_digits_;
+        digit_array_scratch buf((table_size * n) + n + digit_array_barrett_scratch_size(n));
+        natural_digit *g = buf.get();
+        natural_digit *acc = &g[table_size * n];
+        natural_digit *scratch = &acc[n];
+
+        const natural_digit *m = modulus_.digits_;
+        const natural_digit *mu = mu_.digits_;
+        load(g, v);
+
+        natural_pow_window(acc, g, n, e.digits_, e_bits, k,
+                           [=](natural_digit *res, const natural_digit *src1, const natural_digit *src2) {
+                               digit_array_barrett_multiply(res, src1, src2, m, n, mu, scratch);
+                           },
+                           [=](natural_digit *res, const natural_digit *src) {
+                               digit_array_barrett_square(res, src, m, n, mu, scratch);
+                           });
+
+        return store(acc);
+    }
+
+    /*
+     * Convert this natural number to an unsigned long long.
+     */
+    auto natural::to_unsigned_long_long() const -> unsigned long long {
         /*
          * Will this number fit in an unsigned long long?  If not then throw an
          * exception.
@@ -651,6 +2178,285 @@ namespace c8 {
         return res;
     }
 
+    /*
+     * Write exactly width decimal characters of this number to res, padding with leading
+     * zeros if necessary.  The number must be less than 10^width.
+     *
+     * This is the simple quadratic algorithm, but each single digit divide generates as many
+     * characters as a digit can hold.  Numbers below the recursive threshold, which is every
+     * number that reaches here from to_decimal(), use a working copy on the stack, so this
+     * never allocates.
+     */
+    auto natural::to_decimal_basecase(char *res, std::size_t width) const -> void {
+        const natural_digit chunk = natural_decimal_chunk();
+        const std::size_t chunk_chars = natural_decimal_chunk_chars();
+
+        std::size_t rem_num_digits = num_digits_;
+        natural_digit rem_small[__digit_array_decimal_threshold];
+        bool small = (rem_num_digits <= __digit_array_decimal_threshold);
+        digit_array_scratch rem_scratch(small ? 0 : rem_num_digits);
+        natural_digit *rem_digits = small ? rem_small : rem_scratch.get();
+        digit_array_copy(rem_digits, digits_, rem_num_digits);
+
+        while (rem_num_digits) {
+            natural_digit m = 0;
+            std::size_t m_num_digits;
+            digit_array_divide_modulus(rem_digits, rem_num_digits, &m, m_num_digits,
+                                       rem_digits, rem_num_digits, &chunk, 1);
+
+            std::size_t n = (width < chunk_chars) ? width : chunk_chars;
+            for (std::size_t i = 0; i < n; i++) {
+                res[--width] = static_cast<char>('0' + (m % 10));
+                m = static_cast<natural_digit>(m / 10);
+            }
+        }
+
+        while (width) {
+            res[--width] = '0';
+        }
+    }
+
+    /*
+     * Write exactly width decimal characters of this number to res, padding with leading
+     * zeros if necessary.  The number must be less than 10^width.
+     *
+     * powers[i] holds 10^(c * 2^i), where c is the number of decimal characters we can fit in
+     * a single digit.  We split the number by the largest power that is no more than about
+     * the square root of the number, and then recursively convert the quotient and remainder.
+     * The remainder always generates exactly c * 2^i characters.  Given fast division this is
+     * O(M(n) log n) instead of O(n^2).
+     */
+    auto natural::to_decimal(char *res, std::size_t width, const natural_divisor *powers, std::size_t num_powers) const -> void {
+        std::size_t i = num_powers;
+        while (i && ((2 * powers[i - 1].divisor_.num_digits_) > (num_digits_ + 1))) {
+            i--;
+        }
+
+        if ((num_digits_ < __digit_array_decimal_threshold) || !i) {
+            to_decimal_basecase(res, width);
+            return;
+        }
+
+        i--;
+        std::size_t chunk_width = natural_decimal_chunk_chars() << i;
+        auto qr = divide_modulus(powers[i]);
+        qr.first.to_decimal(res, width - chunk_width, powers, i + 1);
+        qr.second.to_decimal(res + width - chunk_width, chunk_width, powers, i);
+    }
+
+    /*
+     * Write exactly width decimal characters of this number to res, padding with leading
+     * zeros if necessary.  The number must be less than 10^width.
+     *
+     * This precomputes the powers of 10 we'll need to recursively split our number.  Small
+     * numbers never need them, so we check for those first.
+     */
+    auto natural::to_decimal(char *res, std::size_t width) const -> void {
+        if (num_digits_ < __digit_array_decimal_threshold) {
+            to_decimal_basecase(res, width);
+            return;
+        }
+
+        std::vector<natural_divisor> powers;
+        natural p(natural_decimal_chunk());
+        while ((2 * p.num_digits_) <= (num_digits_ + 1)) {
+            powers.emplace_back(p);
+            p = p.square();
+        }
+
+        to_decimal(res, width, powers.data(), powers.size());
+    }
+
+    /*
+     * Write exactly width characters of this number to res, in base 2^bits, padding with
+     * leading zeros if necessary.  The number must be less than 2^(bits * width).
+     *
+     * Each character maps directly to a group of bits, so we simply walk our digits from
+     * the least significant end.
+     */
+    auto natural::to_power_of_2(char *res, std::size_t width, unsigned int bits, const char *digits) const -> void {
+        natural_digit mask = static_cast<natural_digit>((1 << bits) - 1);
+
+        natural_double_digit acc = 0;
+        unsigned int acc_bits = 0;
+        std::size_t i = 0;
+        while (width) {
+            if ((acc_bits < bits) && (i < num_digits_)) {
+                acc = static_cast<natural_double_digit>(acc | (static_cast<natural_double_digit>(digits_[i++]) << acc_bits));
+                acc_bits += static_cast<unsigned int>(natural_digit_bits);
+            }
+
+            res[--width] = digits[static_cast<natural_digit>(acc) & mask];
+            acc >>= bits;
+            acc_bits = (acc_bits > bits) ? (acc_bits - bits) : 0;
+        }
+    }
+
+    /*
+     * Return 10^n.
+     */
+    static auto natural_decimal_power(std::size_t n) -> natural {
+        natural res(1);
+        natural p(10);
+        while (n) {
+            if (n & 1) {
+                res *= p;
+            }
+
+            n >>= 1;
+            if (n) {
+                p = p.square();
+            }
+        }
+
+        return res;
+    }
+
+    /*
+     * Return the number of bits per character for a power-of-two base, or zero for any other
+     * base.
+     */
+    static auto natural_base_bits(int base) -> unsigned int {
+        switch (base) {
+        case 2:
+            return 1;
+
+        case 4:
+            return 2;
+
+        case 8:
+            return 3;
+
+        case 16:
+            return 4;
+
+        case 32:
+            return 5;
+
+        default:
+            return 0;
+        }
+    }
+
+    /*
+     * Write the characters of v, in the specified base, into the character range [first, last).
+     *
+     * Like std::to_chars this doesn't add a NUL terminator, any base prefix, or do anything
+     * that depends on the current locale.  The supported bases are 2, 4, 8, 10, 16 and 32.
+     */
+    auto to_chars(char *first, char *last, const natural &v, int base) -> to_chars_result {
+        unsigned int bits = natural_base_bits(base);
+        if (C8_UNLIKELY((base != 10) && !bits)) {
+            return {last, std::errc::invalid_argument};
+        }
+
+        std::size_t sz = static_cast<std::size_t>(last - first);
+
+        if (v.is_zero()) {
+            if (C8_UNLIKELY(!sz)) {
+                return {last, std::errc::value_too_large};
+            }
+
+            *first = '0';
+            return {first + 1, std::errc()};
+        }
+
+        if (bits) {
+            std::size_t width = (v.size_bits() + bits - 1) / bits;
+            if (C8_UNLIKELY(width > sz)) {
+                return {last, std::errc::value_too_large};
+            }
+
+            v.to_power_of_2(first, width, bits, digits_lower);
+            return {first + width, std::errc()};
+        }
+
+        /*
+         * Estimate our decimal width as floor(bits * log10(2)) + 1, using a 32-bit fixed point
+         * constant rounded up from log10(2).  The bit count is split into two halves so that
+         * the product can't overflow.  The estimate is never too small, but may be too large:
+         * a value with n bits can have one fewer decimal digit than the largest n bit value,
+         * and the rounding in our constant adds one more for values beyond about 6 billion
+         * bits.  If the estimate doesn't fit then we find the exact width before deciding
+         * whether our result fits.  Up to 10^19 our powers of 10 fit in a machine word.
+         */
+        const unsigned long long log10_2 = 1292913987;
+        unsigned long long size_bits = v.size_bits();
+        std::size_t width = static_cast<std::size_t>((size_bits >> 32) * log10_2 + (((size_bits & 0xffffffff) * log10_2) >> 32) + 1);
+        if (width > sz) {
+            if (width <= 20) {
+                unsigned long long p = 1;
+                for (std::size_t i = 1; i < width; i++) {
+                    p *= 10;
+                }
+
+                while ((width > sz) && (v < p)) {
+                    width--;
+                    p /= 10;
+                }
+            } else {
+                natural p = natural_decimal_power(width - 1);
+                while ((width > sz) && (v < p)) {
+                    width--;
+                    p /= 10;
+                }
+            }
+
+            if (C8_UNLIKELY(width > sz)) {
+                return {last, std::errc::value_too_large};
+            }
+        }
+
+        v.to_decimal(first, width);
+
+        std::size_t zeros = 0;
+        while (first[zeros] == '0') {
+            zeros++;
+        }
+
+        if (zeros) {
+            std::memmove(first, first + zeros, width - zeros);
+        }
+
+        return {first + width - zeros, std::errc()};
+    }
+
+    /*
+     * Parse a natural number, in the specified base, from the character range [first, last).
+     *
+     * Like std::from_chars this accepts no sign, base prefix or whitespace.  It consumes as
+     * many characters as are valid for the base, and leaves v unchanged if there are none.
+     * The supported bases are 2, 4, 8, 10, 16 and 32.
+     */
+    auto from_chars(const char *first, const char *last, natural &v, int base) -> from_chars_result {
+        unsigned int bits = natural_base_bits(base);
+        if (C8_UNLIKELY((base != 10) && !bits)) {
+            return {first, std::errc::invalid_argument};
+        }
+
+        natural_digit b = static_cast<natural_digit>(base);
+        const char *p = first;
+        while ((p != last) && (natural_char_value(*p, b) != b)) {
+            p++;
+        }
+
+        if (C8_UNLIKELY(p == first)) {
+            return {first, std::errc::invalid_argument};
+        }
+
+        std::size_t sz = static_cast<std::size_t>(p - first);
+
+        natural res;
+        if (bits) {
+            res.from_power_of_2(first, sz, bits);
+        } else {
+            res.from_decimal(first, sz);
+        }
+
+        v = std::move(res);
+        return {p, std::errc()};
+    }
+
     /*
      * << operator to print a natural.
      */
@@ -683,74 +2489,30 @@ namespace c8 {
             }
         }
 
-        natural_digit modulus_digit;
-        std::size_t modulus_num_digits;
-
-        /*
-         * Allocate space for a result buffer.  We want this to be fast, so we go old-school
-         * and use a C-style string (yes this isn't nice, but we're very careful).  We assume
-         * a worst case of octal, so each 3 bits requires one result character.  We also want
-         * a NUL terminator.  We also give ourselves one extra digit to handle any partial
-         * digits, or the zero digit case.
-         */
-        std::size_t res_sz = ((v_num_digits * natural_digit_bits) / 3) + 2;
-        char res[res_sz];
-        res[--res_sz] = '\0';
-
-        natural_digit rem_digits[v.num_digits_];
-        std::size_t rem_num_digits;
-
-        /*
-         * We always have at least one digit, so compute that now.
-         */
-        digit_array_divide_modulus(rem_digits, rem_num_digits, &modulus_digit, modulus_num_digits,
-                                   v.digits_, v.num_digits_, &base, 1);
-        unsigned int d = 0;
-        if (modulus_num_digits) {
-            d = static_cast<unsigned int>(modulus_digit);
-        }
-
-        res[--res_sz] = digits[d];
-
-        natural_digit base_div = base;
-
-        if (sizeof(natural_digit) > 1) {
-            base_div = static_cast<natural_digit>(base_div * base);
-        }
-
         /*
-         * Now compute any other characters.
-         *
-         * We try work in blocks of 2 characters at a time because this results in far
-         * fewer arbitrary precision divides.
+         * Decimal output is converted by recursively splitting our number by powers of 10.
+         * We start with a width that is guaranteed to be large enough (1234 / 4096 is just
+         * larger than log10(2)), and then skip any leading zeros.
          */
-        while (rem_num_digits) {
-            modulus_digit = 0;
-            digit_array_divide_modulus(rem_digits, rem_num_digits, &modulus_digit, modulus_num_digits,
-                                       rem_digits, rem_num_digits, &base_div, 1);
-
-            if (sizeof(natural_digit) > 1) {
-                if ((rem_num_digits == 0) && (modulus_digit == 0)) {
-                    break;
-                }
-
-                auto d = modulus_digit % base;
-                modulus_digit = modulus_digit / base;
-                res[--res_sz] = digits[d];
-            }
-
-            if ((rem_num_digits == 0) && (modulus_digit == 0)) {
-                break;
-            }
+        if (base == 10) {
+            std::size_t width = ((v.size_bits() * 1234) >> 12) + 1;
+            std::string res(width, '0');
+            v.to_decimal(&res[0], width);
 
-            res[--res_sz] = digits[modulus_digit];
+            outstr << &res[res.find_first_not_of('0')];
+            return outstr;
         }
 
         /*
-         * Output the digits we accumulated.
+         * Hex and octal output map directly onto groups of bits, so we can extract each
+         * character in a single pass over our digits, without any divides.
          */
-        outstr << &res[res_sz];
+        unsigned int bits = (base == 16) ? 4 : 3;
+        std::size_t width = (v.size_bits() + bits - 1) / bits;
+        std::string res(width, '0');
+        v.to_power_of_2(&res[0], width, bits, digits);
 
+        outstr << res;
         return outstr;
     }
 }
@@ -4,6 +4,36 @@
 #include "c8.h"
 
 namespace c8 {
+    /*
+     * Return the magnitude of a long long integer, handling the most negative value correctly.
+     */
+    static inline auto rational_ll_magnitude(long long v) noexcept -> unsigned long long {
+        unsigned long long m = static_cast<unsigned long long>(v);
+        return (v < 0) ? (0ULL - m) : m;
+    }
+
+    /*
+     * Find the greatest common divisor of two machine words, where v is non-zero.
+     */
+    static auto rational_gcd(unsigned long long v, unsigned long long u) noexcept -> unsigned long long {
+        while (u) {
+            unsigned long long t = v % u;
+            v = u;
+            u = t;
+        }
+
+        return v;
+    }
+
+    /*
+     * Find the greatest common divisor of a natural number and a non-zero machine word.  The
+     * first step reduces the natural number modulo the machine word, after which we only need
+     * machine word arithmetic.
+     */
+    static auto rational_gcd(const natural &v, unsigned long long u) -> unsigned long long {
+        return rational_gcd(u, to_unsigned_long_long(v % u));
+    }
+
     /*
      * Construct a rational from an IEEE754 double precision floating point value.
      */
@@ -118,56 +148,306 @@ namespace c8 {
         return (numerator_ != v.numerator_) || (denominator_ != v.denominator_);
     }
 
+    /*
+     * Compare this rational with another one, returning -1, 0 or 1 if this one is less than,
+     * equal to, or greater than v.
+     *
+     * For a/b and c/d we need to compare ad with cb, but the cross products are expensive
+     * so we try to avoid them.  First we check the signs, then whether the denominators or
+     * numerators are the same.  After that we compare the bit sizes of the cross products:
+     * ad has either bits(a) + bits(d) - 1 or bits(a) + bits(d) bits, so if these ranges do
+     * not overlap then we know which is larger.  This is equivalent to comparing the sizes of
+     * the integer parts of a/b and c/d, but doesn't need any divides.  Only if all of these
+     * are inconclusive do we form the cross products, and if they're small enough we do that
+     * using machine words.
+     */
+    auto rational::compare(const rational &v) const -> int {
+        int sign = numerator_.is_zero() ? 0 : (numerator_.negative_ ? -1 : 1);
+        int v_sign = v.numerator_.is_zero() ? 0 : (v.numerator_.negative_ ? -1 : 1);
+        if (sign != v_sign) {
+            return (sign < v_sign) ? -1 : 1;
+        }
+
+        if (sign == 0) {
+            return 0;
+        }
+
+        /*
+         * From here on we compare magnitudes.  If our values are negative then the larger
+         * magnitude is the smaller value.
+         */
+        const natural &a = numerator_.magnitude_;
+        const natural &b = denominator_.magnitude_;
+        const natural &c = v.numerator_.magnitude_;
+        const natural &d = v.denominator_.magnitude_;
+
+        int res;
+        if (b == d) {
+            res = (a < c) ? -1 : ((a == c) ? 0 : 1);
+        } else if (a == c) {
+            res = (d < b) ? -1 : 1;
+        } else {
+            std::size_t ad_bits = a.size_bits() + d.size_bits();
+            std::size_t cb_bits = c.size_bits() + b.size_bits();
+            if (ad_bits < cb_bits - 1) {
+                res = -1;
+            } else if (cb_bits < ad_bits - 1) {
+                res = 1;
+            } else if (ad_bits <= 64 && cb_bits <= 64) {
+                /*
+                 * Our cross products will fit in a machine word.
+                 */
+                unsigned long long ad = to_unsigned_long_long(a) * to_unsigned_long_long(d);
+                unsigned long long cb = to_unsigned_long_long(c) * to_unsigned_long_long(b);
+                res = (ad < cb) ? -1 : ((ad == cb) ? 0 : 1);
+            } else {
+                natural ad = a * d;
+                natural cb = c * b;
+                res = (ad < cb) ? -1 : ((ad == cb) ? 0 : 1);
+            }
+        }
+
+        return (sign < 0) ? -res : res;
+    }
+
     /*
      * Return true if this rational is greater than another one, false if it's not.
      */
     auto rational::operator >(const rational &v) const -> bool {
-        return (numerator_ * v.denominator_) > (v.numerator_ * denominator_);
+        return compare(v) > 0;
     }
 
     /*
      * Return true if this rational is greater than, or equal to, another one, false if it's not.
      */
     auto rational::operator >=(const rational &v) const -> bool {
-        return (numerator_ * v.denominator_) >= (v.numerator_ * denominator_);
+        return compare(v) >= 0;
     }
 
     /*
      * Return true if this rational is less than another one, false if it's not.
      */
     auto rational::operator <(const rational &v) const -> bool {
-        return (numerator_ * v.denominator_) < (v.numerator_ * denominator_);
+        return compare(v) < 0;
     }
 
     /*
      * Return true if this rational is less than, or equal to, another one, false if it's not.
      */
     auto rational::operator <=(const rational &v) const -> bool {
-        return (numerator_ * v.denominator_) <= (v.numerator_ * denominator_);
+        return compare(v) <= 0;
     }
 
     /*
-     * Add another rational to this one.
+     * Compare this rational with a long long integer, returning -1, 0 or 1 if this one is less
+     * than, equal to, or greater than v.
+     *
+     * For a/b and v we compare a with bv.  As our denominator is positive this preserves the
+     * ordering.  As with compare(const rational &), we take our sign from is_zero() first, as a
+     * zero numerator can still carry a negative sign.
      */
-    auto rational::operator +(const rational &v) const -> rational {
+    auto rational::compare(long long v) const -> int {
+        int sign = numerator_.is_zero() ? 0 : (numerator_.negative_ ? -1 : 1);
+        int v_sign = (v == 0) ? 0 : ((v < 0) ? -1 : 1);
+        if (sign != v_sign) {
+            return (sign < v_sign) ? -1 : 1;
+        }
+
+        if (sign == 0) {
+            return 0;
+        }
+
+        const natural &a = numerator_.magnitude_;
+        unsigned long long v_magnitude = rational_ll_magnitude(v);
+        int res;
+        if (denominator_ == 1) {
+            res = (a < v_magnitude) ? -1 : ((a == v_magnitude) ? 0 : 1);
+        } else {
+            natural bv = denominator_.magnitude_ * v_magnitude;
+            res = (a < bv) ? -1 : ((a == bv) ? 0 : 1);
+        }
+
+        return (sign < 0) ? -res : res;
+    }
+
+    /*
+     * Return true if this rational is equal to a long long integer, false if it's not.
+     *
+     * As we're normalized we can only be equal if our denominator is 1.
+     */
+    auto rational::operator ==(long long v) const -> bool {
+        return (denominator_ == 1) && (compare(v) == 0);
+    }
+
+    /*
+     * Return true if this rational is not equal to a long long integer, false if it's equal.
+     */
+    auto rational::operator !=(long long v) const -> bool {
+        return (denominator_ != 1) || (compare(v) != 0);
+    }
+
+    /*
+     * Return true if this rational is greater than a long long integer, false if it's not.
+     */
+    auto rational::operator >(long long v) const -> bool {
+        return compare(v) > 0;
+    }
+
+    /*
+     * Return true if this rational is greater than, or equal to, a long long integer, false if
+     * it's not.
+     */
+    auto rational::operator >=(long long v) const -> bool {
+        return compare(v) >= 0;
+    }
+
+    /*
+     * Return true if this rational is less than a long long integer, false if it's not.
+     */
+    auto rational::operator <(long long v) const -> bool {
+        return compare(v) < 0;
+    }
+
+    /*
+     * Return true if this rational is less than, or equal to, a long long integer, false if
+     * it's not.
+     */
+    auto rational::operator <=(long long v) const -> bool {
+        return compare(v) <= 0;
+    }
+
+    /*
+     * Add or subtract two normalized rationals, a/b + c/d.
+     *
+     * Rather than forming (ad + bc) / bd and then normalizing, we use Henrici's approach (see
+     * Knuth, TAOCP Vol 2, 4.5.1).  If d1 = gcd(b, d), then the numerator is t = a(d/d1) + c(b/d1)
+     * and the only common factors it can have with the denominator are those in d1.  This means
+     * our GCDs run on smaller values, and if d1 is 1, which is the most common case for random
+     * denominators, we don't need any further GCD at all.
+     */
+    auto rational::add_subtract(const rational &v, bool subtract) const -> rational {
+        rational res;
+
+        /*
+         * If both denominators are 1 then we just have integers.
+         */
+        if (denominator_ == 1 && v.denominator_ == 1) {
+            integer t = subtract ? (numerator_ - v.numerator_) : (numerator_ + v.numerator_);
+            if (!t.is_zero()) {
+                res.numerator_ = std::move(t);
+            }
+
+            return res;
+        }
+
+        integer d1 = gcd(denominator_, v.denominator_);
+        if (d1 == 1) {
+            integer t1 = numerator_ * v.denominator_;
+            integer t2 = denominator_ * v.numerator_;
+            res.numerator_ = subtract ? (t1 - t2) : (t1 + t2);
+            res.denominator_ = denominator_ * v.denominator_;
+            return res;
+        }
+
+        integer b1 = denominator_ / d1;
+        integer t1 = numerator_ * (v.denominator_ / d1);
+        integer t2 = b1 * v.numerator_;
+        integer t = subtract ? (t1 - t2) : (t1 + t2);
+
+        /*
+         * If our result is zero then we need to make sure our denominator is 1.
+         */
+        if (t.is_zero()) {
+            return res;
+        }
+
+        integer d2 = gcd(t, d1);
+        if (d2 == 1) {
+            res.numerator_ = std::move(t);
+            res.denominator_ = b1 * v.denominator_;
+            return res;
+        }
+
+        res.numerator_ = t / d2;
+        res.denominator_ = b1 * (v.denominator_ / d2);
+        return res;
+    }
+
+    /*
+     * Multiply two normalized rationals, (a/b) * (c/d), or divide them if they're passed as
+     * (a/b) * (d/c).
+     *
+     * Rather than forming ac / bd and then normalizing, we cancel any common factors across
+     * the two fractions first.  With d1 = gcd(a, d) and d2 = gcd(b, c) the result is
+     * (a/d1)(c/d2) / (b/d2)(d/d1), which is already normalized.  Our GCDs run on the smaller
+     * inputs, and the products we form are as small as they can be.
+     */
+    auto rational::multiply(const integer &a, const integer &b, const integer &c, const integer &d) -> rational {
         rational res;
 
-        res.numerator_ = (numerator_ * v.denominator_) + (denominator_ * v.numerator_);
-        res.denominator_ = denominator_ * v.denominator_;
+        /*
+         * If either numerator is zero then our result is zero, and has a denominator of 1.
+         */
+        if (a.is_zero() || c.is_zero()) {
+            return res;
+        }
+
+        integer d1 = gcd(a, d);
+        integer d2 = gcd(b, c);
+
+        if (d1 == 1) {
+            if (d2 == 1) {
+                res.numerator_ = a * c;
+                res.denominator_ = b * d;
+            } else {
+                res.numerator_ = a * (c / d2);
+                res.denominator_ = (b / d2) * d;
+            }
+        } else {
+            if (d2 == 1) {
+                res.numerator_ = (a / d1) * c;
+                res.denominator_ = b * (d / d1);
+            } else {
+                res.numerator_ = (a / d1) * (c / d2);
+                res.denominator_ = (b / d2) * (d / d1);
+            }
+        }
+
+        /*
+         * If we were dividing then our denominator may have picked up a negative sign.
+         */
+        if (C8_UNLIKELY(res.denominator_.is_negative())) {
+            res.numerator_.negate();
+            res.denominator_.negate();
+        }
 
-        res.normalize();
         return res;
     }
 
+    /*
+     * Add another rational to this one.
+     */
+    auto rational::operator +(const rational &v) const -> rational {
+        return add_subtract(v, false);
+    }
+
     /*
      * Add another rational to this one.
      */
     auto rational::operator +=(const rational &v) -> rational & {
-        numerator_ *= v.denominator_;
-        numerator_ += (denominator_ * v.numerator_);
-        denominator_ *= v.denominator_;
+        /*
+         * If both denominators are 1 then we can just update our numerator in place.
+         */
+        if (denominator_ == 1 && v.denominator_ == 1) {
+            numerator_ += v.numerator_;
+            if (numerator_.is_zero()) {
+                numerator_ = 0;
+            }
 
-        normalize();
+            return *this;
+        }
+
+        *this = add_subtract(v, false);
         return *this;
     }
 
@@ -175,24 +455,26 @@ namespace c8 {
      * Subtract another rational from this one.
      */
     auto rational::operator -(const rational &v) const -> rational {
-        rational res;
-
-        res.numerator_ = (numerator_ * v.denominator_) - (denominator_ * v.numerator_);
-        res.denominator_ = denominator_ * v.denominator_;
-
-        res.normalize();
-        return res;
+        return add_subtract(v, true);
     }
 
     /*
      * Subtract another rational from this one.
      */
     auto rational::operator -=(const rational &v) -> rational & {
-        numerator_ *= v.denominator_;
-        numerator_ -= (denominator_ * v.numerator_);
-        denominator_ *= v.denominator_;
+        /*
+         * If both denominators are 1 then we can just update our numerator in place.
+         */
+        if (denominator_ == 1 && v.denominator_ == 1) {
+            numerator_ -= v.numerator_;
+            if (numerator_.is_zero()) {
+                numerator_ = 0;
+            }
 
-        normalize();
+            return *this;
+        }
+
+        *this = add_subtract(v, true);
         return *this;
     }
 
@@ -200,61 +482,221 @@ namespace c8 {
      * Multiply another rational with this one.
      */
     auto rational::operator *(const rational &v) const -> rational {
+        return multiply(numerator_, denominator_, v.numerator_, v.denominator_);
+    }
+
+    /*
+     * Multiply another rational with this one.
+     */
+    auto rational::operator *=(const rational &v) -> rational & {
+        *this = multiply(numerator_, denominator_, v.numerator_, v.denominator_);
+        return *this;
+    }
+
+    /*
+     * Divide this rational by another one.
+     */
+    auto rational::operator /(const rational &v) const -> rational {
+        /*
+         * Are we attempting to divide by zero?  If we are then throw an exception.
+         */
+        if (v.is_zero()) {
+            throw c8::divide_by_zero();
+        }
+
+        return multiply(numerator_, denominator_, v.denominator_, v.numerator_);
+    }
+
+    /*
+     * Divide this rational by another one.
+     */
+    auto rational::operator /=(const rational &v) -> rational & {
+        /*
+         * Are we attempting to divide by zero?  If we are then throw an exception.
+         */
+        if (v.is_zero()) {
+            throw c8::divide_by_zero();
+        }
+
+        *this = multiply(numerator_, denominator_, v.denominator_, v.numerator_);
+        return *this;
+    }
+
+    /*
+     * Add a long long integer to this rational.
+     *
+     * For a/b + v the result is (a + bv)/b.  As gcd(a + bv, b) = gcd(a, b) = 1 this is
+     * already normalized, so no GCD is needed.
+     */
+    auto rational::operator +(long long v) const -> rational {
         rational res;
 
-        res.numerator_ = numerator_ * v.numerator_;
-        res.denominator_ = denominator_ * v.denominator_;
+        if (denominator_ == 1) {
+            res.numerator_ = numerator_ + v;
+            if (res.numerator_.is_zero()) {
+                res.numerator_ = 0;
+            }
 
-        res.normalize();
+            return res;
+        }
+
+        res.numerator_ = denominator_ * v;
+        res.numerator_ += numerator_;
+        res.denominator_ = denominator_;
         return res;
     }
 
     /*
-     * Multiply another rational with this one.
+     * Add a long long integer to this rational.
      */
-    auto rational::operator *=(const rational &v) -> rational & {
-        numerator_ *= v.numerator_;
-        denominator_ *= v.denominator_;
+    auto rational::operator +=(long long v) -> rational & {
+        if (denominator_ == 1) {
+            numerator_ += v;
+            if (numerator_.is_zero()) {
+                numerator_ = 0;
+            }
+
+            return *this;
+        }
 
-        normalize();
+        numerator_.addmul(denominator_, integer(v));
         return *this;
     }
 
     /*
-     * Divide this rational by another one.
+     * Subtract a long long integer from this rational.
+     *
+     * As with addition, (a - bv)/b is already normalized.
      */
-    auto rational::operator /(const rational &v) const -> rational {
+    auto rational::operator -(long long v) const -> rational {
         rational res;
 
+        if (denominator_ == 1) {
+            res.numerator_ = numerator_ - v;
+            if (res.numerator_.is_zero()) {
+                res.numerator_ = 0;
+            }
+
+            return res;
+        }
+
+        res.numerator_ = denominator_ * v;
+        res.numerator_.negate();
+        res.numerator_ += numerator_;
+        res.denominator_ = denominator_;
+        return res;
+    }
+
+    /*
+     * Subtract a long long integer from this rational.
+     */
+    auto rational::operator -=(long long v) -> rational & {
+        if (denominator_ == 1) {
+            numerator_ -= v;
+            if (numerator_.is_zero()) {
+                numerator_ = 0;
+            }
+
+            return *this;
+        }
+
+        numerator_.submul(denominator_, integer(v));
+        return *this;
+    }
+
+    /*
+     * Multiply this rational by a long long integer.
+     *
+     * For a/b * v we cancel g = gcd(b, v) first, giving a(v/g) / (b/g), which is normalized.
+     * As v is a machine word the GCD only needs one reduction of b before it can be done
+     * entirely in machine words.
+     */
+    auto rational::operator *(long long v) const -> rational {
+        rational res;
+
+        if ((v == 0) || numerator_.is_zero()) {
+            return res;
+        }
+
+        unsigned long long v_magnitude = rational_ll_magnitude(v);
+        unsigned long long g = rational_gcd(denominator_.magnitude_, v_magnitude);
+        res.numerator_.negative_ = numerator_.negative_ ^ (v < 0);
+        res.numerator_.magnitude_ = numerator_.magnitude_ * (v_magnitude / g);
+        res.denominator_.magnitude_ = (g == 1) ? denominator_.magnitude_ : (denominator_.magnitude_ / g);
+        return res;
+    }
+
+    /*
+     * Multiply this rational by a long long integer.
+     */
+    auto rational::operator *=(long long v) -> rational & {
+        if ((v == 0) || numerator_.is_zero()) {
+            numerator_ = 0;
+            denominator_ = 1;
+            return *this;
+        }
+
+        unsigned long long v_magnitude = rational_ll_magnitude(v);
+        unsigned long long g = rational_gcd(denominator_.magnitude_, v_magnitude);
+        numerator_.negative_ ^= (v < 0);
+        numerator_.magnitude_ *= (v_magnitude / g);
+        if (g != 1) {
+            denominator_.magnitude_ /= g;
+        }
+
+        return *this;
+    }
+
+    /*
+     * Divide this rational by a long long integer.
+     *
+     * For (a/b) / v we cancel g = gcd(a, v) first, giving (a/g) / b(v/g), which is normalized.
+     */
+    auto rational::operator /(long long v) const -> rational {
         /*
          * Are we attempting to divide by zero?  If we are then throw an exception.
          */
-        if (v.is_zero()) {
+        if (v == 0) {
             throw c8::divide_by_zero();
         }
 
-        res.numerator_ = numerator_ * v.denominator_;
-        res.denominator_ = denominator_ * v.numerator_;
+        rational res;
+
+        if (numerator_.is_zero()) {
+            return res;
+        }
 
-        res.normalize();
+        unsigned long long v_magnitude = rational_ll_magnitude(v);
+        unsigned long long g = rational_gcd(numerator_.magnitude_, v_magnitude);
+        res.numerator_.negative_ = numerator_.negative_ ^ (v < 0);
+        res.numerator_.magnitude_ = (g == 1) ? numerator_.magnitude_ : (numerator_.magnitude_ / g);
+        res.denominator_.magnitude_ = denominator_.magnitude_ * (v_magnitude / g);
         return res;
     }
 
     /*
-     * Divide this rational by another one.
+     * Divide this rational by a long long integer.
      */
-    auto rational::operator /=(const rational &v) -> rational & {
+    auto rational::operator /=(long long v) -> rational & {
         /*
          * Are we attempting to divide by zero?  If we are then throw an exception.
          */
-        if (v.is_zero()) {
+        if (v == 0) {
             throw c8::divide_by_zero();
         }
 
-        numerator_ *= v.denominator_;
-        denominator_ *= v.numerator_;
+        if (numerator_.is_zero()) {
+            return *this;
+        }
 
-        normalize();
+        unsigned long long v_magnitude = rational_ll_magnitude(v);
+        unsigned long long g = rational_gcd(numerator_.magnitude_, v_magnitude);
+        numerator_.negative_ ^= (v < 0);
+        if (g != 1) {
+            numerator_.magnitude_ /= g;
+        }
+
+        denominator_.magnitude_ *= (v_magnitude / g);
         return *this;
     }
 
@@ -371,5 +813,56 @@ namespace c8 {
 
         return outstr;
     }
+
+    /*
+     * Write the characters of v, in the specified base, into the character range [first, last).
+     *
+     * As with the << operator, the numerator and denominator are separated by a '/'.
+     */
+    auto to_chars(char *first, char *last, const rational &v, int base) -> to_chars_result {
+        auto res = to_chars(first, last, v.numerator_, base);
+        if (C8_UNLIKELY(res.ec != std::errc())) {
+            return res;
+        }
+
+        if (C8_UNLIKELY(res.ptr == last)) {
+            return {last, std::errc::value_too_large};
+        }
+
+        *res.ptr++ = '/';
+        return to_chars(res.ptr, last, v.denominator_, base);
+    }
+
+    /*
+     * Parse a rational, in the specified base, from the character range [first, last).
+     *
+     * The numerator can have an optional '-' sign to indicate that it's negative, and may be
+     * followed by a '/' and a denominator.  If there's no denominator then it is taken to be
+     * 1.  If no valid number is found, or the denominator is zero, then v is unchanged.
+     */
+    auto from_chars(const char *first, const char *last, rational &v, int base) -> from_chars_result {
+        integer n;
+        auto res = from_chars(first, last, n, base);
+        if (C8_UNLIKELY(res.ec != std::errc())) {
+            return res;
+        }
+
+        natural d(1);
+        if ((res.ptr != last) && (*res.ptr == '/')) {
+            auto d_res = from_chars(res.ptr + 1, last, d, base);
+            if (d_res.ec == std::errc()) {
+                if (C8_UNLIKELY(d.is_zero())) {
+                    return {first, std::errc::invalid_argument};
+                }
+
+                res = d_res;
+            }
+        }
+
+        v.numerator_ = std::move(n);
+        v.denominator_ = integer(d);
+        v.normalize();
+        return res;
+    }
 }
 
@@ -49,6 +49,8 @@ const test tests[] = {
     test_natural_construct_5,
     test_natural_construct_6,
     test_natural_construct_7,
+    test_natural_construct_8,
+    test_natural_construct_9,
     test_natural_size_bits_0,
     test_natural_size_bits_1,
     test_natural_size_bits_2,
@@ -139,6 +141,19 @@ const test tests[] = {
     test_natural_multiply_4b,
     test_natural_multiply_5a,
     test_natural_multiply_5b,
+    test_natural_multiply_6a,
+    test_natural_multiply_6b,
+    test_natural_multiply_7a,
+    test_natural_multiply_7b,
+    test_natural_multiply_7c,
+    test_natural_multiply_8a,
+    test_natural_multiply_8b,
+    test_natural_multiply_9a,
+    test_natural_multiply_9b,
+    test_natural_square_0a,
+    test_natural_square_0b,
+    test_natural_square_1a,
+    test_natural_square_1b,
     test_natural_divide_0a,
     test_natural_divide_0b,
     test_natural_divide_0c,
@@ -166,16 +181,59 @@ const test tests[] = {
     test_natural_divide_8a,
     test_natural_divide_8b,
     test_natural_divide_8c,
+    test_natural_divide_9a,
+    test_natural_divide_9b,
+    test_natural_divide_10a,
+    test_natural_divide_10b,
+    test_natural_divide_11,
+    test_natural_divisor_0a,
+    test_natural_divisor_0b,
+    test_natural_divisor_0c,
+    test_natural_divisor_1,
+    test_natural_divisor_2,
+    test_natural_divisor_3,
+    test_natural_divisor_4,
     test_natural_gcd_0,
     test_natural_gcd_1,
     test_natural_gcd_2,
     test_natural_gcd_3,
     test_natural_gcd_4,
+    test_natural_gcd_5,
+    test_natural_gcd_6,
+    test_natural_gcd_7,
+    test_natural_inverse_mod_0,
+    test_natural_inverse_mod_1,
+    test_natural_inverse_mod_2,
+    test_natural_pow_mod_0,
+    test_natural_pow_mod_1,
+    test_natural_pow_mod_2,
+    test_natural_pow_mod_3,
+    test_natural_pow_mod_4,
+    test_natural_pow_mod_5,
+    test_natural_pow_mod_6,
+    test_natural_pow_mod_7,
     test_natural_to_unsigned_long_long_0,
     test_natural_to_unsigned_long_long_1,
     test_natural_to_unsigned_long_long_2,
     test_natural_to_unsigned_long_long_3,
     test_natural_to_unsigned_long_long_4,
+    test_natural_allocator_0,
+    test_natural_allocator_1,
+    test_natural_temporary_0,
+    test_natural_addmul_0,
+    test_natural_addmul_1,
+    test_natural_submul_0,
+    test_natural_submul_1,
+    test_natural_submul_2,
+    test_natural_expr_0,
+    test_natural_expr_1,
+    test_natural_expr_2,
+    test_natural_expr_3,
+    test_natural_expr_4,
+    test_natural_word_0,
+    test_natural_word_1,
+    test_natural_word_2,
+    test_natural_word_3,
     test_natural_print_0,
     test_natural_print_1,
     test_natural_print_2,
@@ -184,6 +242,18 @@ const test tests[] = {
     test_natural_print_5,
     test_natural_print_6,
     test_natural_print_7,
+    test_natural_print_8,
+    test_natural_print_9,
+    test_natural_to_chars_0,
+    test_natural_to_chars_1,
+    test_natural_to_chars_2,
+    test_natural_to_chars_3,
+    test_natural_to_chars_4,
+    test_natural_to_chars_5,
+    test_natural_scratch_0,
+    test_natural_from_chars_0,
+    test_natural_from_chars_1,
+    test_natural_from_chars_2,
     test_integer_construct_0,
     test_integer_construct_1,
     test_integer_construct_2,
@@ -264,6 +334,7 @@ const test tests[] = {
     test_integer_multiply_2b,
     test_integer_multiply_3a,
     test_integer_multiply_3b,
+    test_integer_square_0a,
     test_integer_divide_0a,
     test_integer_divide_0b,
     test_integer_divide_1a,
@@ -274,6 +345,11 @@ const test tests[] = {
     test_integer_divide_3b,
     test_integer_divide_4a,
     test_integer_divide_4b,
+    test_integer_pow_mod_0,
+    test_integer_pow_mod_1,
+    test_integer_pow_mod_2,
+    test_integer_gcdext_0,
+    test_integer_gcdext_1,
     test_integer_magnitude_0,
     test_integer_magnitude_1,
     test_integer_magnitude_2,
@@ -290,6 +366,16 @@ const test tests[] = {
     test_integer_print_5,
     test_integer_print_6,
     test_integer_print_7,
+    test_integer_to_chars_0,
+    test_integer_to_chars_1,
+    test_integer_to_chars_2,
+    test_integer_from_chars_0,
+    test_integer_temporary_0,
+    test_integer_addmul_0,
+    test_integer_submul_0,
+    test_integer_expr_0,
+    test_integer_word_0,
+    test_integer_word_1,
     test_rational_construct_0,
     test_rational_construct_1,
     test_rational_construct_2,
@@ -309,6 +395,7 @@ const test tests[] = {
     test_rational_add_2b,
     test_rational_add_3a,
     test_rational_add_3b,
+    test_rational_add_4,
     test_rational_subtract_0a,
     test_rational_subtract_0b,
     test_rational_subtract_1a,
@@ -317,6 +404,7 @@ const test tests[] = {
     test_rational_subtract_2b,
     test_rational_subtract_3a,
     test_rational_subtract_3b,
+    test_rational_subtract_4,
     test_rational_compare_0a,
     test_rational_compare_0b,
     test_rational_compare_0c,
@@ -341,6 +429,10 @@ const test tests[] = {
     test_rational_compare_3d,
     test_rational_compare_3e,
     test_rational_compare_3f,
+    test_rational_compare_4a,
+    test_rational_compare_4b,
+    test_rational_compare_4c,
+    test_rational_compare_4d,
     test_rational_multiply_0a,
     test_rational_multiply_0b,
     test_rational_multiply_1a,
@@ -349,6 +441,7 @@ const test tests[] = {
     test_rational_multiply_2b,
     test_rational_multiply_3a,
     test_rational_multiply_3b,
+    test_rational_multiply_4,
     test_rational_divide_0a,
     test_rational_divide_0b,
     test_rational_divide_1a,
@@ -374,6 +467,15 @@ const test tests[] = {
     test_rational_print_5,
     test_rational_print_6,
     test_rational_print_7,
+    test_rational_to_chars_0,
+    test_rational_to_chars_1,
+    test_rational_to_chars_2,
+    test_rational_from_chars_0,
+    test_rational_temporary_0,
+    test_rational_word_0,
+    test_rational_word_1,
+    test_rational_word_2,
+    test_rational_word_3,
     nullptr
 };
 
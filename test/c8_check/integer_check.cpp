@@ -1,7 +1,11 @@
 /*
  * integer_check.cpp
  */
+#include <limits>
+#include <sstream>
+
 #include <c8.h>
+#include <c8_expr.h>
 
 #include "result.h"
 
@@ -1347,6 +1351,22 @@ auto test_integer_multiply_3b() -> result {
     return r;
 }
 
+/*
+ * Test squaring.
+ */
+auto test_integer_square_0a() -> result {
+    result r("int sqr 0a");
+    c8::integer sq0("-0x1e0a7c4d8ff3c9a1b2e63d7f55a0c41e9b2d37a6f");
+
+    r.start_clock();
+    auto sq1 = sq0.square();
+    r.stop_clock();
+
+    r.get_stream() << std::hex << sq1;
+    r.check_pass("386759020279d41bb7e24665dbee2f0d00cced6eeb528dc5db6cf0198a6e6c285ec7401036987fc21");
+    return r;
+}
+
 /*
  * Test division.
  */
@@ -1562,6 +1582,107 @@ auto test_integer_divide_4b() -> result {
     return r;
 }
 
+/*
+ * Test modular exponentiation of a negative integer.
+ */
+auto test_integer_pow_mod_0() -> result {
+    result r("int powmod 0");
+    c8::integer p0(-7);
+    c8::integer p1(3);
+    c8::integer p2(10);
+
+    r.start_clock();
+    auto p3 = pow_mod(p0, p1, p2);
+    r.stop_clock();
+
+    r.get_stream() << p3;
+    r.check_pass("7");
+    return r;
+}
+
+/*
+ * Test modular exponentiation of a large negative integer.
+ */
+auto test_integer_pow_mod_1() -> result {
+    result r("int powmod 1");
+    c8::integer p0("-0x123456789");
+    c8::integer p1(0x55);
+    c8::integer p2("0x100000000000000000061");
+
+    r.start_clock();
+    auto p3 = pow_mod(p0, p1, p2);
+    r.stop_clock();
+
+    r.get_stream() << p3;
+    r.check_pass("592478816090234121765357");
+    return r;
+}
+
+/*
+ * Test modular exponentiation with a negative exponent.  This will throw an exception!
+ */
+auto test_integer_pow_mod_2() -> result {
+    result r("int powmod 2");
+    c8::integer p0(3);
+    c8::integer p1(-2);
+    c8::integer p2(7);
+
+    r.start_clock();
+    try {
+        auto p3 = pow_mod(p0, p1, p2);
+        r.stop_clock();
+
+        r.get_stream() << "failed to throw exception";
+        r.set_pass(false);
+    } catch (const c8::invalid_argument &e) {
+        r.stop_clock();
+
+        r.get_stream() << "exception thrown: " + std::string(e.what());
+        r.set_pass(true);
+    } catch (...) {
+        r.stop_clock();
+
+        r.get_stream() << "unexpected exception thrown";
+        r.set_pass(false);
+    }
+
+    return r;
+}
+
+/*
+ * Test the extended GCD of two integers.
+ */
+auto test_integer_gcdext_0() -> result {
+    result r("int gcdext 0");
+    c8::integer p0(-240);
+    c8::integer p1(46);
+
+    r.start_clock();
+    auto p2 = gcdext(p0, p1);
+    r.stop_clock();
+
+    r.get_stream() << std::get<0>(p2) << ',' << std::get<1>(p2) << ',' << std::get<2>(p2);
+    r.check_pass("2,9,47");
+    return r;
+}
+
+/*
+ * Test the extended GCD of two larger integers.
+ */
+auto test_integer_gcdext_1() -> result {
+    result r("int gcdext 1");
+    c8::integer p0("-0x123456789abcdef0123456789");
+    c8::integer p1("0x1000000000000000000000000000000000000000000000000000000000000");
+
+    r.start_clock();
+    auto p2 = gcdext(p0, p1);
+    r.stop_clock();
+
+    r.get_stream() << std::get<0>(p2) << ',' << std::get<1>(p2) << ',' << std::get<2>(p2);
+    r.check_pass("1,157793417963842099876691745746758304321239934113741710704929870507589959,8050576016208179110907179636");
+    return r;
+}
+
 /*
  * Test magnitude functionality.
  */
@@ -1841,3 +1962,238 @@ auto test_integer_print_7() -> result {
     return r;
 }
 
+
+/*
+ * Test conversion to characters.
+ */
+auto test_integer_to_chars_0() -> result {
+    result r("int tch 0");
+    c8::integer v("-0xfedcfedc0123456789");
+    char buf[64];
+
+    r.start_clock();
+    auto res = to_chars(buf, buf + sizeof(buf), v, 16);
+    r.stop_clock();
+
+    r.get_stream() << std::string(buf, res.ptr);
+    r.check_pass("-fedcfedc0123456789");
+    return r;
+}
+
+/*
+ * Test decimal conversion of large negative values into exact-size and one-short buffers.
+ */
+auto test_integer_to_chars_1() -> result {
+    result r("int tch 1");
+    c8::integer p10(1);
+    for (int i = 0; i < 3000; i++) {
+        p10 *= 10;
+    }
+
+    c8::integer p2 = c8::integer(1) << 12345;
+    c8::integer vals[] = {-p10, 1 - p10, -p2};
+
+    r.start_clock();
+    for (const auto &v : vals) {
+        std::ostringstream s;
+        s << v;
+        std::string expected = s.str();
+        std::vector<char> buf(expected.size());
+        auto res0 = to_chars(buf.data(), buf.data() + buf.size(), v);
+        auto res1 = to_chars(buf.data(), buf.data() + buf.size() - 1, v);
+        r.get_stream() << ((res0.ec == std::errc()) && (std::string(buf.data(), res0.ptr) == expected))
+                       << (res1.ec == std::errc::value_too_large) << ',';
+    }
+    r.stop_clock();
+
+    r.check_pass("11,11,11,");
+    return r;
+}
+
+/*
+ * Test that an unsupported base is rejected before anything is written.
+ */
+auto test_integer_to_chars_2() -> result {
+    result r("int tch 2");
+    c8::integer v(-12345);
+    char buf[2] = {'x', 'x'};
+
+    r.start_clock();
+    auto res0 = to_chars(buf, buf + 1, v, 7);
+    auto res1 = to_chars(buf, buf + 2, v, 0);
+    auto res2 = to_chars(buf, buf, v, 36);
+    r.stop_clock();
+
+    r.get_stream() << (res0.ec == std::errc::invalid_argument) << (res1.ec == std::errc::invalid_argument)
+                   << (res2.ec == std::errc::invalid_argument) << ',' << std::string(buf, 2);
+    r.check_pass("111,xx");
+    return r;
+}
+
+/*
+ * Test conversion from characters.
+ */
+auto test_integer_from_chars_0() -> result {
+    result r("int fch 0");
+    std::string s = "-4701397401952099592073/";
+    c8::integer v;
+
+    r.start_clock();
+    auto res = from_chars(s.data(), s.data() + s.size(), v);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << v << ',' << std::dec << (res.ptr - s.data());
+    r.check_pass("-fedcfedc0123456789,23");
+    return r;
+}
+
+/*
+ * Test arithmetic on temporaries.
+ */
+auto test_integer_temporary_0() -> result {
+    result r("int temp 0");
+    c8::integer a("-0x123456789abcdef0123456789abcdef0123456789abcdef");
+    c8::integer b("0xfedcba9876543210fedcba9876543210fedcba9876543210");
+    c8::integer c("0x1111111111111111111111111111111111111111111111111");
+
+    r.start_clock();
+    c8::integer d = a * b + c;
+    c8::integer e = (c - a * b) / b;
+    c8::integer f = (c + (a << 3)) % b;
+    r.stop_clock();
+
+    c8::integer ab = a * b;
+    c8::integer a3 = a << 3;
+    c8::integer ca3 = c + a3;
+    r.get_stream() << ((d == (ab + c)) ? "equal" : "not equal") << ','
+                   << ((e == ((c - ab) / b)) ? "equal" : "not equal") << ','
+                   << ((f == (ca3 % b)) ? "equal" : "not equal");
+    r.check_pass("equal,equal,equal");
+    return r;
+}
+
+/*
+ * Add products of mixed signs to an integer.
+ */
+auto test_integer_addmul_0() -> result {
+    result r("int addmul 0");
+    c8::integer v("-0x123456789abcdef0123456789abcdef");
+    c8::integer u("0xfedcba9876543210fedcba9876543210");
+    c8::integer c("0x1111111111111111111111111111111111111111111111111111111111111111");
+    c8::integer x0 = c;
+    c8::integer x1 = -c;
+
+    r.start_clock();
+    x0.addmul(v, u);
+    x1.addmul(v, -u);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << x0 << ',' << x1;
+    r.check_pass("fef1710639939ceec96447fd0bfd59ccb8165f098d61feeeeda38812baf8421,"
+                 "-fef1710639939ceec96447fd0bfd59ccb8165f098d61feeeeda38812baf8421");
+    return r;
+}
+
+/*
+ * Subtract products of mixed signs from an integer.
+ */
+auto test_integer_submul_0() -> result {
+    result r("int submul 0");
+    c8::integer v("-0x123456789abcdef0123456789abcdef");
+    c8::integer u("0xfedcba9876543210fedcba9876543210");
+    c8::integer c("0x1111111111111111111111111111111111111111111111111111111111111111");
+    c8::integer x0 = c;
+    c8::integer x1 = -c;
+
+    r.start_clock();
+    x0.submul(v, u);
+    x1.submul(v, -u);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << x0 << ',' << x1;
+    r.check_pass("12330b11be88e853358bdda251624c8556a0bc31894c02333347e9a0f6729e01,"
+                 "-12330b11be88e853358bdda251624c8556a0bc31894c02333347e9a0f6729e01");
+    return r;
+}
+
+/*
+ * Test fused expressions with operands of mixed signs.
+ */
+auto test_integer_expr_0() -> result {
+    result r("int expr 0");
+    c8::integer a("-0x123456789abcdef0123456789abcdef0123456789abcdef");
+    c8::integer b("0xfedcba9876543210fedcba9876543210fedcba9876543210");
+    c8::integer c("0x1111111111111111111111111111111111111111111111111");
+    c8::integer m("0xf123456789abcdef0123456789abcdef0123456789abcdeb");
+    c8::integer x0 = c;
+    c8::integer x1 = c;
+    c8::integer x2;
+    c8::integer x3 = a;
+
+    r.start_clock();
+    c8::expr::assign(x0, c8::expr::lazy(x0) + c8::expr::lazy(a) * b);
+    c8::expr::assign(x1, c8::expr::lazy(x1) - c8::expr::lazy(a) * b);
+    c8::expr::assign(x2, c8::expr::lazy(a) * a + c8::expr::lazy(a) * b);
+    c8::expr::assign(x3, c8::expr::lazy(x3) * b % m);
+    r.stop_clock();
+
+    r.get_stream() << ((x0 == (c + a * b)) ? "equal" : "not equal") << ','
+                   << ((x1 == (c - a * b)) ? "equal" : "not equal") << ','
+                   << ((x2 == (a * a + a * b)) ? "equal" : "not equal") << ','
+                   << ((x3 == (a * b % m)) ? "equal" : "not equal") << ','
+                   << x0.is_negative() << x1.is_negative() << x2.is_negative() << x3.is_negative();
+    r.check_pass("equal,equal,equal,equal,1011");
+    return r;
+}
+
+/*
+ * Test arithmetic with long long operands, including the most negative value.
+ */
+auto test_integer_word_0() -> result {
+    result r("int word 0");
+    c8::integer v("-0x123456789abcdef0123456789abcdef");
+    long long m = std::numeric_limits<long long>::min();
+
+    r.start_clock();
+    c8::integer a = v + m;
+    c8::integer s = v - m;
+    c8::integer p = v * -3;
+    c8::integer q = v / m;
+    c8::integer rem = v % -7;
+    c8::integer t0 = c8::integer(5) + -12;
+    c8::integer t1 = c8::integer(-5) - -12;
+    r.stop_clock();
+
+    r.get_stream() << a << ',' << s << ',' << p << ',' << q << ',' << rem << ',' << t0 << ',' << t1;
+    r.check_pass("-1512366075204170938272954391261335023,"
+                 "-1512366075204170919826210317551783407,"
+                 "4537098225612512787148747063219677645,"
+                 "163971058432973790,"
+                 "-4,-7,7");
+    return r;
+}
+
+/*
+ * Test compound assignment and comparisons with long long operands.
+ */
+auto test_integer_word_1() -> result {
+    result r("int word 1");
+    long long m = std::numeric_limits<long long>::min();
+    c8::integer x(m);
+
+    r.start_clock();
+    r.get_stream() << (x == m) << (x != m) << (x < (m + 1)) << (x > 0) << (c8::integer(0) >= 0) << ',';
+    x -= 1;
+    r.get_stream() << x << ',' << (x < m) << ',';
+    x += 1;
+    x *= -1;
+    r.get_stream() << x << ',' << (x > std::numeric_limits<long long>::max()) << ',';
+    x /= 1024;
+    r.get_stream() << x << ',';
+    x %= 1000;
+    r.stop_clock();
+
+    r.get_stream() << x;
+    r.check_pass("10101,-9223372036854775809,1,9223372036854775808,1,9007199254740992,992");
+    return r;
+}
@@ -86,6 +86,7 @@ auto test_integer_multiply_2a() -> result;
 auto test_integer_multiply_2b() -> result;
 auto test_integer_multiply_3a() -> result;
 auto test_integer_multiply_3b() -> result;
+auto test_integer_square_0a() -> result;
 auto test_integer_divide_0a() -> result;
 auto test_integer_divide_0b() -> result;
 auto test_integer_divide_1a() -> result;
@@ -96,6 +97,11 @@ auto test_integer_divide_3a() -> result;
 auto test_integer_divide_3b() -> result;
 auto test_integer_divide_4a() -> result;
 auto test_integer_divide_4b() -> result;
+auto test_integer_pow_mod_0() -> result;
+auto test_integer_pow_mod_1() -> result;
+auto test_integer_pow_mod_2() -> result;
+auto test_integer_gcdext_0() -> result;
+auto test_integer_gcdext_1() -> result;
 auto test_integer_magnitude_0() -> result;
 auto test_integer_magnitude_1() -> result;
 auto test_integer_magnitude_2() -> result;
@@ -112,6 +118,16 @@ auto test_integer_print_4() -> result;
 auto test_integer_print_5() -> result;
 auto test_integer_print_6() -> result;
 auto test_integer_print_7() -> result;
+auto test_integer_to_chars_0() -> result;
+auto test_integer_to_chars_1() -> result;
+auto test_integer_to_chars_2() -> result;
+auto test_integer_from_chars_0() -> result;
+auto test_integer_temporary_0() -> result;
+auto test_integer_addmul_0() -> result;
+auto test_integer_submul_0() -> result;
+auto test_integer_expr_0() -> result;
+auto test_integer_word_0() -> result;
+auto test_integer_word_1() -> result;
 
 #endif // __INTEGER_CHECK_H
 
@@ -1,11 +1,40 @@
 /*
  * natural_check.cpp
  */
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
 #include <c8.h>
+#include <c8_expr.h>
 
 #include "result.h"
 #include "natural_check.h"
 
+/*
+ * Count calls to the global operator new on each thread, so that we can check operations that
+ * promise not to allocate.
+ */
+static thread_local std::size_t operator_new_calls = 0;
+
+auto operator new(std::size_t size) -> void * {
+    operator_new_calls++;
+    void *p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+auto operator delete(void *p) noexcept -> void {
+    std::free(p);
+}
+
+auto operator delete(void *p, std::size_t) noexcept -> void {
+    std::free(p);
+}
+
 /*
  * Construct with a long integer 0.
  */
@@ -139,6 +168,53 @@ auto test_natural_construct_7() -> result {
     return r;
 }
 
+/*
+ * Construct with a very large decimal string.  This is large enough to need the recursive
+ * decimal conversion.
+ */
+auto test_natural_construct_8() -> result {
+    result r("nat cons 8");
+    c8::natural p(1);
+    for (int i = 0; i < 5000; i++) {
+        p *= 10;
+    }
+
+    std::string s0 = "1" + std::string(5000, '0');
+    std::string s1(5000, '9');
+
+    r.start_clock();
+    c8::natural v0(s0);
+    c8::natural v1(s1);
+    r.stop_clock();
+
+    r.get_stream() << ((v0 == p) ? "equal" : "not equal") << ','
+                   << ((v1 == (p - 1)) ? "equal" : "not equal");
+    r.check_pass("equal,equal");
+    return r;
+}
+
+/*
+ * Construct with very large hexadecimal and octal strings.
+ */
+auto test_natural_construct_9() -> result {
+    result r("nat cons 9");
+    c8::natural p(1);
+    p <<= 12000;
+
+    std::string s0 = "0x" + std::string(3000, 'F');
+    std::string s1 = "0" + std::string(4000, '7');
+
+    r.start_clock();
+    c8::natural v0(s0);
+    c8::natural v1(s1);
+    r.stop_clock();
+
+    r.get_stream() << ((v0 == (p - 1)) ? "equal" : "not equal") << ','
+                   << ((v1 == (p - 1)) ? "equal" : "not equal");
+    r.check_pass("equal,equal");
+    return r;
+}
+
 /*
  * Test bit counting.
  */
@@ -1664,6 +1740,234 @@ auto test_natural_multiply_5b() -> result {
     return r;
 }
 
+/*
+ * Multiply two large natural numbers, large enough to use the Karatsuba multiplier.
+ */
+auto test_natural_multiply_6a() -> result {
+    result r("nat mul 6a");
+    c8::natural mu0("0x91e5152801122d4ba955dd75e2399fbbf6ddcf2612fcb469c8c27a4de010a980b9348154957a3e6a231901b82a01d446c9b08d9c67c44cc56284ea6c5a242d7327d8ff08346a93bb77fef77bd709348bc1cc299ba226098153ae088a5cd31ae854445d4615f19c6ec15af795acbb6876a18ebb95eb6732396462d0c8808443181e4b01917072b77d2ff8fd07edf137d9e97f28652f952051bfb6b318eed843fde69832cd0e9c1121cd84740935a199afd3fa2b66b3f7244a4c47f79f3feca1481d55b3ea4d293d99a5f298ad7ac2495be61a0494ee483aa74e956f9aabb227f2a44c92658fb025e384a2d7e7a827eaad417ae27427ee566e35dc883526cf6a58bb3584ef7986dc099d54ec566ae0d31ac622104b23142cc0e5ce24c2b59f12cee57f15d67e1817a34e7e619dccc5c72240cd032d491d2250de5af52c0c349dc9be1aea17dc");
+    c8::natural mu1("0xb9aa901ecf3828c8dc6e8a342d207df565986cb20554133a044983bb6aa5fef86f837f4d481151639f11555654d1c180bbbf6115cc6aaa490e78a39762593ef06ec42a0ceca637e15b0a30415e0c3fe03493e24cfed83bb3762c1570b36b641e5edf5838cb82e2a55168fe3e07785bb84c40c120167e6ac820bf9db7d3f921d84f15034adeffb83c91f281f52c43e9430f0f0c43a71e5ab32264eefb72a83d4f045b362f442cdf86aaf7d1e7b011129504163ee11ca7f9d7b1c77637b6db6c2025b3274c8477cb738cf8bf647dff38e1cf6ecb181dcc0fa9fcea4ba74de96e6141db0dbb9cc767836870096879aae6b3adf99e820206cf0b763c381a19da0f7370f980483606552c5bff041f185c6aaeb94ca36e2100505940b80c6fc836338");
+
+    r.start_clock();
+    auto mu2 = mu0 * mu1;
+    r.stop_clock();
+
+    r.get_stream() << std::hex << mu2;
+    r.check_pass("69cfc08c602e118e58bdf193daea8ac43105164ee54607ebc3d7edfe6b19e78f66c7f06dcd917cfd0d37c6262e4b4441c2fd489ce19b5289623c0f2ed1c4d29c173a9baf8138b1282350ab9bd9bfe2cc9ba6dada1e5137e2cb7f259cc74f19aa323834deeb32feb7d29fc1c2a85d7cdb8f64504a120705c6e29dd932b897a314269950408948a3a37552ce25c70e9a3f7e79576e7673cb15b97f9469ca6e99d40703b9d51d206b46d6d88a3781a73043883865d6a9fc1ccd6ca9bec7c9dc47f464134aa14a79c10858056bfcab40f0d8bb6413bad7b6c079312a3e3988a3ab640ef6c4d6b700755a30a06034326854df3e5c3b00da2f927e57fd45e074df28afaa9404fdaf4a2ff4bb65b54e0393b2782482a5a76c4ba710480e8079d46d66c7e95893052d53240fc6f9ea1fae5e168622e5fadbf65a343ffb05ce0afe268dcdd3946f5b16959131608fa1e835ded02f590c13c28f81e8ec9b4a7d098f2293c7c979c1df4f29c1e92b11542c89d071eb32ae93b9b206cabc4f64b292b301ad67cc01ffd9cf2e7b6cd4379c4539d65b0aac798af9adb6972b611dae34d6d476eada54146b3f506ccaed6630d458293fc7d002496f5b15b99a36ca462dc7b4a966064a57cb3f189ae37f0251ef4634da98aada63c96abc6f17e1e116730a72697a89ed79f1e02c59f64e90774b234c10bfa016c796ac9b6f58fe5286f17acb608151fda9b3359ed3cf528be2756da157d1d6f70f90b7d3a9cf45716a4e60a1839fa1714f1aa5493708fba0f39a9a1621399ca5d9af613956f308163121af2d472c429aa2330a8fc9714b906bce803002ad6358fefc779bfd7223c21f1fdf9bf4f6d30034c20");
+    return r;
+}
+
+/*
+ * Multiply two large natural numbers, large enough to use the Karatsuba multiplier.
+ */
+auto test_natural_multiply_6b() -> result {
+    result r("nat mul 6b");
+    c8::natural mu0("0x91e5152801122d4ba955dd75e2399fbbf6ddcf2612fcb469c8c27a4de010a980b9348154957a3e6a231901b82a01d446c9b08d9c67c44cc56284ea6c5a242d7327d8ff08346a93bb77fef77bd709348bc1cc299ba226098153ae088a5cd31ae854445d4615f19c6ec15af795acbb6876a18ebb95eb6732396462d0c8808443181e4b01917072b77d2ff8fd07edf137d9e97f28652f952051bfb6b318eed843fde69832cd0e9c1121cd84740935a199afd3fa2b66b3f7244a4c47f79f3feca1481d55b3ea4d293d99a5f298ad7ac2495be61a0494ee483aa74e956f9aabb227f2a44c92658fb025e384a2d7e7a827eaad417ae27427ee566e35dc883526cf6a58bb3584ef7986dc099d54ec566ae0d31ac622104b23142cc0e5ce24c2b59f12cee57f15d67e1817a34e7e619dccc5c72240cd032d491d2250de5af52c0c349dc9be1aea17dc");
+    c8::natural mu1("0xb9aa901ecf3828c8dc6e8a342d207df565986cb20554133a044983bb6aa5fef86f837f4d481151639f11555654d1c180bbbf6115cc6aaa490e78a39762593ef06ec42a0ceca637e15b0a30415e0c3fe03493e24cfed83bb3762c1570b36b641e5edf5838cb82e2a55168fe3e07785bb84c40c120167e6ac820bf9db7d3f921d84f15034adeffb83c91f281f52c43e9430f0f0c43a71e5ab32264eefb72a83d4f045b362f442cdf86aaf7d1e7b011129504163ee11ca7f9d7b1c77637b6db6c2025b3274c8477cb738cf8bf647dff38e1cf6ecb181dcc0fa9fcea4ba74de96e6141db0dbb9cc767836870096879aae6b3adf99e820206cf0b763c381a19da0f7370f980483606552c5bff041f185c6aaeb94ca36e2100505940b80c6fc836338");
+
+    r.start_clock();
+    mu0 *= mu1;
+    r.stop_clock();
+
+    r.get_stream() << std::hex << mu0;
+    r.check_pass("69cfc08c602e118e58bdf193daea8ac43105164ee54607ebc3d7edfe6b19e78f66c7f06dcd917cfd0d37c6262e4b4441c2fd489ce19b5289623c0f2ed1c4d29c173a9baf8138b1282350ab9bd9bfe2cc9ba6dada1e5137e2cb7f259cc74f19aa323834deeb32feb7d29fc1c2a85d7cdb8f64504a120705c6e29dd932b897a314269950408948a3a37552ce25c70e9a3f7e79576e7673cb15b97f9469ca6e99d40703b9d51d206b46d6d88a3781a73043883865d6a9fc1ccd6ca9bec7c9dc47f464134aa14a79c10858056bfcab40f0d8bb6413bad7b6c079312a3e3988a3ab640ef6c4d6b700755a30a06034326854df3e5c3b00da2f927e57fd45e074df28afaa9404fdaf4a2ff4bb65b54e0393b2782482a5a76c4ba710480e8079d46d66c7e95893052d53240fc6f9ea1fae5e168622e5fadbf65a343ffb05ce0afe268dcdd3946f5b16959131608fa1e835ded02f590c13c28f81e8ec9b4a7d098f2293c7c979c1df4f29c1e92b11542c89d071eb32ae93b9b206cabc4f64b292b301ad67cc01ffd9cf2e7b6cd4379c4539d65b0aac798af9adb6972b611dae34d6d476eada54146b3f506ccaed6630d458293fc7d002496f5b15b99a36ca462dc7b4a966064a57cb3f189ae37f0251ef4634da98aada63c96abc6f17e1e116730a72697a89ed79f1e02c59f64e90774b234c10bfa016c796ac9b6f58fe5286f17acb608151fda9b3359ed3cf528be2756da157d1d6f70f90b7d3a9cf45716a4e60a1839fa1714f1aa5493708fba0f39a9a1621399ca5d9af613956f308163121af2d472c429aa2330a8fc9714b906bce803002ad6358fefc779bfd7223c21f1fdf9bf4f6d30034c20");
+    return r;
+}
+
+/*
+ * Multiply two similarly sized natural numbers, large enough to use the Toom-Cook 3-way
+ * multiplier.  We choose values whose product we can compute using shifts and subtractions.
+ */
+auto test_natural_multiply_7a() -> result {
+    result r("nat mul 7a");
+    c8::natural mu0 = (c8::natural(1) << 8300) - (c8::natural(1) << 4321) - 1;
+    c8::natural mu1 = (c8::natural(1) << 8000) - (c8::natural(1) << 1234) - 1;
+
+    r.start_clock();
+    auto mu2 = mu0 * mu1;
+    r.stop_clock();
+
+    r.get_stream() << (mu2 == ((mu0 << 8000) - (mu0 << 1234) - mu0));
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Multiply two natural numbers, where one is about one and a half times the size of the
+ * other, large enough to use the Toom-Cook 3-way by 2-way multiplier.
+ */
+auto test_natural_multiply_7b() -> result {
+    result r("nat mul 7b");
+    c8::natural mu0 = (c8::natural(1) << 12000) - (c8::natural(1) << 7777) - 1;
+    c8::natural mu1 = (c8::natural(1) << 8000) - (c8::natural(1) << 4444) - 1;
+
+    r.start_clock();
+    auto mu2 = mu0 * mu1;
+    r.stop_clock();
+
+    r.get_stream() << (mu2 == ((mu0 << 8000) - (mu0 << 4444) - mu0));
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Multiply two similarly sized natural numbers, large enough to use the Toom-Cook 4-way
+ * multiplier.
+ */
+auto test_natural_multiply_7c() -> result {
+    result r("nat mul 7c");
+    c8::natural mu0 = (c8::natural(1) << 30000) - (c8::natural(1) << 12345) - 1;
+    c8::natural mu1 = (c8::natural(1) << 28000) - (c8::natural(1) << 23456) - 1;
+
+    r.start_clock();
+    auto mu2 = mu0 * mu1;
+    r.stop_clock();
+
+    r.get_stream() << (mu2 == ((mu0 << 28000) - (mu0 << 23456) - mu0));
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Multiply two very large natural numbers, large enough to use the number-theoretic
+ * transform multiplier.
+ */
+auto test_natural_multiply_8a() -> result {
+    result r("nat mul 8a");
+    c8::natural mu0 = (c8::natural(1) << 200000) - (c8::natural(1) << 123456) - 1;
+    c8::natural mu1 = (c8::natural(1) << 150000) - (c8::natural(1) << 65432) - 1;
+
+    r.start_clock();
+    auto mu2 = mu0 * mu1;
+    r.stop_clock();
+
+    r.get_stream() << (mu2 == ((mu0 << 150000) - (mu0 << 65432) - mu0));
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Multiply two very large natural numbers, in place, large enough to use the
+ * number-theoretic transform multiplier.
+ */
+auto test_natural_multiply_8b() -> result {
+    result r("nat mul 8b");
+    c8::natural mu0 = (c8::natural(1) << 200000) - (c8::natural(1) << 123456) - 1;
+    c8::natural mu1 = (c8::natural(1) << 150000) - (c8::natural(1) << 65432) - 1;
+    auto mu2 = (mu0 << 150000) - (mu0 << 65432) - mu0;
+
+    r.start_clock();
+    mu0 *= mu1;
+    r.stop_clock();
+
+    r.get_stream() << (mu0 == mu2);
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Multiply a large natural number by a much smaller one, where both are large enough
+ * that we chunk the larger number.
+ */
+auto test_natural_multiply_9a() -> result {
+    result r("nat mul 9a");
+    c8::natural mu0 = (c8::natural(1) << 60000) - (c8::natural(1) << 31415) - 1;
+    c8::natural mu1 = (c8::natural(1) << 3000) - (c8::natural(1) << 2718) - 1;
+
+    r.start_clock();
+    auto mu2 = mu0 * mu1;
+    r.stop_clock();
+
+    r.get_stream() << (mu2 == ((mu0 << 3000) - (mu0 << 2718) - mu0));
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Multiply a small natural number by a much larger one, in place, where both are large
+ * enough that we chunk the larger number, and where the chunks use Toom-Cook 3-way.
+ */
+auto test_natural_multiply_9b() -> result {
+    result r("nat mul 9b");
+    c8::natural mu0 = (c8::natural(1) << 8000) - (c8::natural(1) << 1618) - 1;
+    c8::natural mu1 = (c8::natural(1) << 40000) - (c8::natural(1) << 14142) - 1;
+    auto mu2 = (mu1 << 8000) - (mu1 << 1618) - mu1;
+
+    r.start_clock();
+    mu0 *= mu1;
+    r.stop_clock();
+
+    r.get_stream() << (mu0 == mu2);
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Square a 3 digit natural number.
+ */
+auto test_natural_square_0a() -> result {
+    result r("nat sqr 0a");
+    c8::natural sq0("0x1e0a7c4d8ff3c9a1b2e63d7f55a0c41e9b2d37a6f");
+
+    r.start_clock();
+    auto sq1 = sq0.square();
+    r.stop_clock();
+
+    r.get_stream() << std::hex << sq1;
+    r.check_pass("386759020279d41bb7e24665dbee2f0d00cced6eeb528dc5db6cf0198a6e6c285ec7401036987fc21");
+    return r;
+}
+
+/*
+ * Square a natural number by multiplying it by itself, in place.
+ */
+auto test_natural_square_0b() -> result {
+    result r("nat sqr 0b");
+    c8::natural sq0("0x1e0a7c4d8ff3c9a1b2e63d7f55a0c41e9b2d37a6f");
+
+    r.start_clock();
+    sq0 *= sq0;
+    r.stop_clock();
+
+    r.get_stream() << std::hex << sq0;
+    r.check_pass("386759020279d41bb7e24665dbee2f0d00cced6eeb528dc5db6cf0198a6e6c285ec7401036987fc21");
+    return r;
+}
+
+/*
+ * Square a large natural number, large enough to use the Toom-Cook 3-way squaring
+ * algorithm.  We choose a value whose square we can compute using shifts and subtractions.
+ */
+auto test_natural_square_1a() -> result {
+    result r("nat sqr 1a");
+    c8::natural sq0 = (c8::natural(1) << 12000) - (c8::natural(1) << 5678) - 1;
+
+    r.start_clock();
+    auto sq1 = sq0.square();
+    r.stop_clock();
+
+    r.get_stream() << (sq1 == ((sq0 << 12000) - (sq0 << 5678) - sq0));
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Square a very large natural number, large enough to use the number-theoretic transform
+ * multiplier.
+ */
+auto test_natural_square_1b() -> result {
+    result r("nat sqr 1b");
+    c8::natural sq0 = (c8::natural(1) << 200000) - (c8::natural(1) << 98765) - 1;
+
+    r.start_clock();
+    auto sq1 = sq0 * sq0;
+    r.stop_clock();
+
+    r.get_stream() << (sq1 == ((sq0 << 200000) - (sq0 << 98765) - sq0));
+    r.check_pass("1");
+    return r;
+}
+
 /*
  * Divide a 2 digit natural number by another 2 digit natural number.
  */
@@ -2187,197 +2491,1193 @@ auto test_natural_divide_8c() -> result {
 }
 
 /*
- * Test greatest common divisor.
+ * Divide a very large natural number by another very large natural number.
  */
-auto test_natural_gcd_0() -> result {
-    result r("nat gcd 0");
-    c8::natural g0(2000);
-    c8::natural g1(56);
+auto test_natural_divide_9a() -> result {
+    result r("nat div 9a");
+    c8::natural d0 = (c8::natural(1) << 4000) - (c8::natural(1) << 1234) - 1;
+    c8::natural q0 = (c8::natural(1) << 6000) - (c8::natural(1) << 17) - 3;
+    c8::natural mo0 = d0 - 5;
+    c8::natural d1 = q0 * d0 + mo0;
 
     r.start_clock();
-    c8::natural g2 = gcd(g0, g1);
+    auto d2 = d1 / d0;
+    auto mo2 = d1 % d0;
     r.stop_clock();
 
-    r.get_stream() << g2;
-    r.check_pass("8");
+    r.get_stream() << ((d2 == q0) && (mo2 == mo0));
+    r.check_pass("1");
     return r;
 }
 
 /*
- * Test greatest common divisor.
+ * Divide a very large natural number by another very large natural number.
  */
-auto test_natural_gcd_1() -> result {
-    result r("nat gcd 1");
-    c8::natural g0("47598475892456783750932574388878478947978888888");
-    c8::natural g1("87987922283");
+auto test_natural_divide_9b() -> result {
+    result r("nat div 9b");
+    c8::natural d0 = (c8::natural(1) << 5000) - (c8::natural(1) << 3000) + (c8::natural(1) << 77);
+    c8::natural q0 = (c8::natural(1) << 20000) - (c8::natural(1) << 9999) - 1;
+    c8::natural mo0 = (c8::natural(1) << 4321) + 1;
+    c8::natural d1 = q0 * d0 + mo0;
 
     r.start_clock();
-    c8::natural g2 = gcd(g0, g1);
+    auto dm = d1.divide_modulus(d0);
     r.stop_clock();
 
-    r.get_stream() << g2;
+    r.get_stream() << ((dm.first == q0) && (dm.second == mo0));
     r.check_pass("1");
     return r;
 }
 
 /*
- * Test greatest common divisor.
+ * Divide a large natural number by a small single digit natural number.
  */
-auto test_natural_gcd_2() -> result {
-    result r("nat gcd 2");
-    c8::natural g0("8888888");
-    c8::natural g1("8888888");
+auto test_natural_divide_10a() -> result {
+    result r("nat div 10a");
+    c8::natural d0("0x8e5b6f7bc3f2a9f3c2b7a15d36e9b4a2c37c0e1f4d2b5a69");
+    c8::natural d1(7);
 
     r.start_clock();
-    c8::natural g2 = gcd(g0, g1);
+    auto dm = d0.divide_modulus(d1);
     r.stop_clock();
 
-    r.get_stream() << g2;
-    r.check_pass("8888888");
+    r.get_stream() << std::hex << dm.first << ',' << dm.second;
+    r.check_pass("1456347f6522aa908987f27b07d83e606511b8dfe673e858,1");
     return r;
 }
 
 /*
- * Test greatest common divisor.
+ * Divide a large natural number by a large single digit natural number.
  */
-auto test_natural_gcd_3() -> result {
-    result r("nat gcd 3");
-    c8::natural g0("2038355020176327696765561949673186971898109715960816150233379221718753632190267");
-    c8::natural g1("1957628088684195906794648605131674616575412301467318480917205787195238636855999");
+auto test_natural_divide_10b() -> result {
+    result r("nat div 10b");
+    c8::natural d0("0x8e5b6f7bc3f2a9f3c2b7a15d36e9b4a2c37c0e1f4d2b5a69");
+    c8::natural d1(0xfedcba9876543211ULL);
 
     r.start_clock();
-    c8::natural g2 = gcd(g0, g1);
+    auto dm = d0.divide_modulus(d1);
     r.stop_clock();
 
-    r.get_stream() << g2;
-    r.check_pass("20181732873032947492728336135378088830674353623374417329043358630878748833567");
+    r.get_stream() << std::hex << dm.first << ',' << dm.second;
+    r.check_pass("8efe211fbf1bbf47ad2b9b049e1e09ee,5f55502ff924359b");
     return r;
 }
 
 /*
- * Test greatest common divisor.
+ * Divide a natural number by a larger one with more digits, where normalizing the divisor
+ * shifts the dividend up to the same number of digits.
  */
-auto test_natural_gcd_4() -> result {
-    result r("nat gcd 4");
-    c8::natural g0("0x199999999999999a");
-    c8::natural g1("0x1000000000000000");
+auto test_natural_divide_11() -> result {
+    result r("nat div 11");
+    c8::natural d0("0x8000000000000000");
+    c8::natural d1("0x10000000000000001");
 
     r.start_clock();
-    c8::natural g2 = gcd(g0, g1);
+    auto dm = d0.divide_modulus(d1);
     r.stop_clock();
 
-    r.get_stream() << g2;
-    r.check_pass("2");
+    r.get_stream() << std::hex << dm.first << ',' << dm.second;
+    r.check_pass("0,8000000000000000");
     return r;
 }
 
 /*
- * Test to_unsigned_long_long functionality.
+ * Divide a large natural number by a precomputed divisor.
  */
-auto test_natural_to_unsigned_long_long_0() -> result {
-    result r("nat toull 0");
-    c8::natural n(0);
+auto test_natural_divisor_0a() -> result {
+    result r("nat divisor 0a");
+    c8::natural d0("0x7fffffffffffffff80000000000000000000000000000000");
+    c8::natural_divisor d1(c8::natural("0x8000000000000000ffffffffffffffff"));
 
     r.start_clock();
-    unsigned long long u = to_unsigned_long_long(n);
+    auto d2 = d0 / d1;
+    auto mo2 = d0 % d1;
     r.stop_clock();
 
-    r.get_stream() << u;
-    r.check_pass("0");
+    r.get_stream() << std::hex << d2 << ',' << mo2;
+    r.check_pass("fffffffffffffffd,3fffffffffffffffd");
     return r;
 }
 
 /*
- * Test to_unsigned_long_long functionality.
+ * Divide a large natural number by a precomputed divisor.
  */
-auto test_natural_to_unsigned_long_long_1() -> result {
-    result r("nat toull 1");
-    c8::natural n(2000);
+auto test_natural_divisor_0b() -> result {
+    result r("nat divisor 0b");
+    c8::natural d0("0x7fffffffffffffff80000000000000000000000000000000");
+    auto mo0 = d0;
+    c8::natural_divisor d1(c8::natural("0x8000000000000000ffffffffffffffff"));
 
     r.start_clock();
-    unsigned long long u = to_unsigned_long_long(n);
+    d0 /= d1;
+    mo0 %= d1;
     r.stop_clock();
 
-    r.get_stream() << u;
-    r.check_pass("2000");
+    r.get_stream() << std::hex << d0 << ',' << mo0;
+    r.check_pass("fffffffffffffffd,3fffffffffffffffd");
     return r;
 }
 
 /*
- * Test to_unsigned_long_long functionality.
+ * Divide a large natural number by a precomputed divisor.
  */
-auto test_natural_to_unsigned_long_long_2() -> result {
-    result r("nat toull 2");
-    c8::natural n("47895748574857485728747548237543205782573485472759047548275024574207");
+auto test_natural_divisor_0c() -> result {
+    result r("nat divisor 0c");
+    c8::natural d0("0x7fffffffffffffff80000000000000000000000000000000");
+    c8::natural_divisor d1(c8::natural("0x8000000000000000ffffffffffffffff"));
 
     r.start_clock();
-    try {
-        unsigned long long u = to_unsigned_long_long(n);
-        r.stop_clock();
-
-        r.get_stream() << u << " (failed to throw exception)";
-        r.set_pass(false);
-    } catch (const c8::overflow_error &e) {
-        r.stop_clock();
+    auto dm = d0.divide_modulus(d1);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << dm.first << ',' << dm.second;
+    r.check_pass("fffffffffffffffd,3fffffffffffffffd");
+    return r;
+}
+
+/*
+ * Divide a natural number by a small precomputed divisor.
+ */
+auto test_natural_divisor_1() -> result {
+    result r("nat divisor 1");
+    c8::natural d0("0x83895729589772897429772838957236");
+    c8::natural_divisor d1(c8::natural(1000000007));
+
+    r.start_clock();
+    auto dm = d0.divide_modulus(d1);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << dm.first << ',' << dm.second;
+    r.check_pass("234f1e52385a822880f0d7b70,1a70b226");
+    return r;
+}
+
+/*
+ * Attempt to construct a zero divisor.
+ */
+auto test_natural_divisor_2() -> result {
+    result r("nat divisor 2");
+    c8::natural d0(0);
+
+    r.start_clock();
+    try {
+        c8::natural_divisor d1(d0);
+        r.stop_clock();
+
+        r.get_stream() << "failed to throw exception";
+        r.set_pass(false);
+    } catch (const c8::divide_by_zero &e) {
+        r.stop_clock();
 
         r.get_stream() << "exception thrown: " + std::string(e.what());
         r.set_pass(true);
     } catch (...) {
         r.stop_clock();
 
-        r.get_stream() << "unexpected exception thrown";
-        r.set_pass(false);
+        r.get_stream() << "unexpected exception thrown";
+        r.set_pass(false);
+    }
+
+    return r;
+}
+
+/*
+ * Divide several very large natural numbers by the same very large precomputed divisor.
+ */
+auto test_natural_divisor_3() -> result {
+    result r("nat divisor 3");
+    c8::natural d0 = (c8::natural(1) << 80000) - (c8::natural(1) << 30011) + (c8::natural(1) << 77);
+    c8::natural q0 = (c8::natural(1) << 100000) - (c8::natural(1) << 9999) - 1;
+    c8::natural q1 = (c8::natural(1) << 70000) + (c8::natural(1) << 12345);
+    c8::natural mo0 = (c8::natural(1) << 64321) + 1;
+    c8::natural mo1 = d0 - 1;
+    c8::natural d1 = q0 * d0 + mo0;
+    c8::natural d2 = q1 * d0 + mo1;
+
+    r.start_clock();
+    c8::natural_divisor d3(d0);
+    auto dm1 = d1.divide_modulus(d3);
+    auto dm2 = d2.divide_modulus(d3);
+    r.stop_clock();
+
+    r.get_stream() << ((dm1.first == q0) && (dm1.second == mo0) && (dm2.first == q1) && (dm2.second == mo1));
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Divide by a precomputed divisor that is larger, and has more digits, than the dividend,
+ * where normalizing shifts the dividend up to the same number of digits.
+ */
+auto test_natural_divisor_4() -> result {
+    result r("nat divisor 4");
+    c8::natural d0("0x8000000000000000");
+    c8::natural_divisor d1(c8::natural("0x10000000000000001"));
+
+    r.start_clock();
+    auto dm = d0.divide_modulus(d1);
+    c8::natural q = d0 / d1;
+    c8::natural m = d0 % d1;
+    r.stop_clock();
+
+    r.get_stream() << std::hex << dm.first << ',' << dm.second << ',' << q << ',' << m;
+    r.check_pass("0,8000000000000000,0,8000000000000000");
+    return r;
+}
+
+/*
+ * Test greatest common divisor.
+ */
+auto test_natural_gcd_0() -> result {
+    result r("nat gcd 0");
+    c8::natural g0(2000);
+    c8::natural g1(56);
+
+    r.start_clock();
+    c8::natural g2 = gcd(g0, g1);
+    r.stop_clock();
+
+    r.get_stream() << g2;
+    r.check_pass("8");
+    return r;
+}
+
+/*
+ * Test greatest common divisor.
+ */
+auto test_natural_gcd_1() -> result {
+    result r("nat gcd 1");
+    c8::natural g0("47598475892456783750932574388878478947978888888");
+    c8::natural g1("87987922283");
+
+    r.start_clock();
+    c8::natural g2 = gcd(g0, g1);
+    r.stop_clock();
+
+    r.get_stream() << g2;
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Test greatest common divisor.
+ */
+auto test_natural_gcd_2() -> result {
+    result r("nat gcd 2");
+    c8::natural g0("8888888");
+    c8::natural g1("8888888");
+
+    r.start_clock();
+    c8::natural g2 = gcd(g0, g1);
+    r.stop_clock();
+
+    r.get_stream() << g2;
+    r.check_pass("8888888");
+    return r;
+}
+
+/*
+ * Test greatest common divisor.
+ */
+auto test_natural_gcd_3() -> result {
+    result r("nat gcd 3");
+    c8::natural g0("2038355020176327696765561949673186971898109715960816150233379221718753632190267");
+    c8::natural g1("1957628088684195906794648605131674616575412301467318480917205787195238636855999");
+
+    r.start_clock();
+    c8::natural g2 = gcd(g0, g1);
+    r.stop_clock();
+
+    r.get_stream() << g2;
+    r.check_pass("20181732873032947492728336135378088830674353623374417329043358630878748833567");
+    return r;
+}
+
+/*
+ * Test greatest common divisor.
+ */
+auto test_natural_gcd_4() -> result {
+    result r("nat gcd 4");
+    c8::natural g0("0x199999999999999a");
+    c8::natural g1("0x1000000000000000");
+
+    r.start_clock();
+    c8::natural g2 = gcd(g0, g1);
+    r.stop_clock();
+
+    r.get_stream() << g2;
+    r.check_pass("2");
+    return r;
+}
+
+/*
+ * Calculate the GCD of two multi-digit numbers with a large common factor.
+ */
+auto test_natural_gcd_5() -> result {
+    result r("nat gcd 5");
+    c8::natural g0("0x8e6b59586889bbffaab3e063ebed12a22d4bf1eaf2e784866f34bd78454578dfad7137445a9dd23d0d94e6bed8f0c208");
+    c8::natural g1("0xa2c3d3d2c09d6892fc9d9a911ee1767ce5a2b419d3e243e7130aa95165475a7878e94999da0a2a3a3b2c0cdd9e4eef8");
+
+    r.start_clock();
+    c8::natural g2 = gcd(g0, g1);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << g2;
+    r.check_pass("8f0e1d2c3b4a59687766554433221100ffeeddccbbaa9988");
+    return r;
+}
+
+/*
+ * Calculate the GCD of a large number and a much smaller one.
+ */
+auto test_natural_gcd_6() -> result {
+    result r("nat gcd 6");
+    c8::natural g0("0x300000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000090ab");
+    c8::natural g1("0x2a5784b1df0c396693c0ee1b4875a2d");
+
+    r.start_clock();
+    c8::natural g2 = gcd(g0, g1);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << g2;
+    r.check_pass("3");
+    return r;
+}
+
+/*
+ * Calculate the GCD of two very large Fibonacci numbers.  These are the worst case for
+ * Euclid's algorithm, and are large enough to need the half-GCD.  gcd(F(m), F(n)) is
+ * F(gcd(m, n)).
+ */
+auto test_natural_gcd_7() -> result {
+    result r("nat gcd 7");
+    c8::natural f0(0);
+    c8::natural f1(1);
+    c8::natural g0;
+    c8::natural g1;
+    c8::natural g2;
+    for (int i = 1; i <= 60000; i++) {
+        f0 += f1;
+        std::swap(f0, f1);
+
+        if (i == 15000) {
+            g2 = f0;
+        } else if (i == 45000) {
+            g1 = f0;
+        }
+    }
+
+    g0 = f0;
+
+    r.start_clock();
+    c8::natural g3 = gcd(g0, g1);
+    r.stop_clock();
+
+    r.get_stream() << g3.size_bits() << ',' << ((g3 == g2) ? "equal" : "not equal");
+    r.check_pass("10413,equal");
+    return r;
+}
+
+/*
+ * Test modular inverses.
+ */
+auto test_natural_inverse_mod_0() -> result {
+    result r("nat invmod 0");
+    c8::natural p0(17);
+    c8::natural p1(3120);
+
+    r.start_clock();
+    c8::natural p2 = inverse_mod(p0, p1);
+    r.stop_clock();
+
+    r.get_stream() << p2;
+    r.check_pass("2753");
+    return r;
+}
+
+/*
+ * Test modular inverses with a larger modulus.
+ */
+auto test_natural_inverse_mod_1() -> result {
+    result r("nat invmod 1");
+    c8::natural p0("0x123456789abcdef");
+    c8::natural p1("0x100000000000000000061");
+
+    r.start_clock();
+    c8::natural p2 = inverse_mod(p0, p1);
+    r.stop_clock();
+
+    r.get_stream() << p2;
+    r.check_pass("1038212814513005257160756");
+    return r;
+}
+
+/*
+ * Attempt to find a modular inverse that does not exist.  This will throw an exception!
+ */
+auto test_natural_inverse_mod_2() -> result {
+    result r("nat invmod 2");
+    c8::natural p0(12);
+    c8::natural p1(3120);
+
+    r.start_clock();
+    try {
+        c8::natural p2 = inverse_mod(p0, p1);
+        r.stop_clock();
+
+        r.get_stream() << "failed to throw exception";
+        r.set_pass(false);
+    } catch (const c8::invalid_argument &e) {
+        r.stop_clock();
+
+        r.get_stream() << "exception thrown: " + std::string(e.what());
+        r.set_pass(true);
+    } catch (...) {
+        r.stop_clock();
+
+        r.get_stream() << "unexpected exception thrown";
+        r.set_pass(false);
+    }
+
+    return r;
+}
+
+/*
+ * Test modular exponentiation.
+ */
+auto test_natural_pow_mod_0() -> result {
+    result r("nat powmod 0");
+    c8::natural p0(4);
+    c8::natural p1(13);
+    c8::natural p2(497);
+
+    r.start_clock();
+    auto p3 = pow_mod(p0, p1, p2);
+    r.stop_clock();
+
+    r.get_stream() << p3;
+    r.check_pass("445");
+    return r;
+}
+
+/*
+ * Test modular exponentiation with an even modulus.
+ */
+auto test_natural_pow_mod_1() -> result {
+    result r("nat powmod 1");
+    c8::natural p0("0x123456789abcdef0123456789");
+    c8::natural p1(0x10001);
+    c8::natural p2("0x10000000000000000000000000000");
+
+    r.start_clock();
+    auto p3 = pow_mod(p0, p1, p2);
+    r.stop_clock();
+
+    r.get_stream() << p3;
+    r.check_pass("2571519212260506279433458324170633");
+    return r;
+}
+
+/*
+ * Test modular exponentiation with a large prime modulus.
+ */
+auto test_natural_pow_mod_2() -> result {
+    result r("nat powmod 2");
+    c8::natural p0(3);
+    c8::natural p1("0x7ffffffffffffffffffffffffffffffe");
+    c8::natural p2("0x7fffffffffffffffffffffffffffffff");
+
+    r.start_clock();
+    auto p3 = pow_mod(p0, p1, p2);
+    r.stop_clock();
+
+    r.get_stream() << p3;
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Test modular multiplies and squares using a Montgomery context.
+ */
+auto test_natural_pow_mod_3() -> result {
+    result r("nat powmod 3");
+    c8::natural p0("0x123456789abcdef0fedcba9876543210");
+    c8::natural p1("0xfedcba98765432100123456789abcdef");
+    c8::montgomery_context mc(c8::natural("0xc7f1a2b3c4d5e6f708192a3b4c5d6e7f8091a2b3c4d5e6f7"));
+
+    r.start_clock();
+    auto p2 = mc.mul_mod(p0, p1);
+    auto p3 = mc.sqr_mod(p0);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << p2 << ',' << p3;
+    r.check_pass("667976f8f619f0cf5804dd5f40b94ea4138f3a8ed2660059,7f87d907f1a25bff989df95847cbdbb643a0697083cecc3e");
+    return r;
+}
+
+/*
+ * Attempt to construct a Montgomery context with an even modulus.  This will throw an exception!
+ */
+auto test_natural_pow_mod_4() -> result {
+    result r("nat powmod 4");
+    c8::natural p0(1000);
+
+    r.start_clock();
+    try {
+        c8::montgomery_context mc(p0);
+        r.stop_clock();
+
+        r.get_stream() << "failed to throw exception";
+        r.set_pass(false);
+    } catch (const c8::invalid_argument &e) {
+        r.stop_clock();
+
+        r.get_stream() << "exception thrown: " + std::string(e.what());
+        r.set_pass(true);
+    } catch (...) {
+        r.stop_clock();
+
+        r.get_stream() << "unexpected exception thrown";
+        r.set_pass(false);
+    }
+
+    return r;
+}
+
+/*
+ * Test Barrett modular multiplication and squaring with an even modulus.
+ */
+auto test_natural_pow_mod_5() -> result {
+    result r("nat powmod 5");
+    c8::natural p0("0x123456789abcdef0fedcba9876543210");
+    c8::natural p1("0xfedcba98765432100123456789abcdef");
+    c8::barrett_context bc(c8::natural("0xc7f1a2b3c4d5e6f708192a3b4c5d6e7f8091a2b3c4d5e6f8"));
+
+    r.start_clock();
+    auto p2 = bc.mul_mod(p0, p1);
+    auto p3 = bc.sqr_mod(p0);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << p2 << ',' << p3;
+    r.check_pass("667976f8f619f0cf5804dd5f40b94ea3fc5ad7882b0c00f8,7f87d907f1a25bff989df95847cbdbb641f819392eb61570");
+    return r;
+}
+
+/*
+ * Test Barrett reduction, including with a modulus that is a power of the digit base.
+ */
+auto test_natural_pow_mod_6() -> result {
+    result r("nat powmod 6");
+    c8::natural p0("0x9f8e7d6c5b4a39281706f5e4d3c2b1a0123456789abcdef0fedcba98765432100123456789abcdef");
+    c8::natural p1("0xfedcba98765432100123456789abcdef");
+    c8::barrett_context bc0(c8::natural("0xc7f1a2b3c4d5e6f708192a3b4c5d6e7f8091a2b3c4d5e6f8"));
+    c8::barrett_context bc1(c8::natural(1) << 128);
+
+    r.start_clock();
+    auto p2 = bc0.reduce(p0 * p1);
+    auto p3 = bc1.reduce(p0 * p0);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << p2 << ',' << p3;
+    r.check_pass("375d214e15905cc7baa620313dd4b85b78ebe3fb5b26d29,446efc86a6f7108cdca5e20890f2a521");
+    return r;
+}
+
+/*
+ * Test Barrett modular exponentiation.
+ */
+auto test_natural_pow_mod_7() -> result {
+    result r("nat powmod 7");
+    c8::natural p0("0x123456789abcdef0fedcba9876543210");
+    c8::natural p1("0xfedcba98765432100123456789abcdef");
+    c8::barrett_context bc(c8::natural("0xc7f1a2b3c4d5e6f708192a3b4c5d6e7f8091a2b3c4d5e6f8"));
+
+    r.start_clock();
+    auto p2 = bc.pow_mod(p0, p1);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << p2;
+    r.check_pass("62df149c9e086b0a0a1dc6a568c79c060b5a6bedb3524fb8");
+    return r;
+}
+
+/*
+ * Test to_unsigned_long_long functionality.
+ */
+auto test_natural_to_unsigned_long_long_0() -> result {
+    result r("nat toull 0");
+    c8::natural n(0);
+
+    r.start_clock();
+    unsigned long long u = to_unsigned_long_long(n);
+    r.stop_clock();
+
+    r.get_stream() << u;
+    r.check_pass("0");
+    return r;
+}
+
+/*
+ * Test to_unsigned_long_long functionality.
+ */
+auto test_natural_to_unsigned_long_long_1() -> result {
+    result r("nat toull 1");
+    c8::natural n(2000);
+
+    r.start_clock();
+    unsigned long long u = to_unsigned_long_long(n);
+    r.stop_clock();
+
+    r.get_stream() << u;
+    r.check_pass("2000");
+    return r;
+}
+
+/*
+ * Test to_unsigned_long_long functionality.
+ */
+auto test_natural_to_unsigned_long_long_2() -> result {
+    result r("nat toull 2");
+    c8::natural n("47895748574857485728747548237543205782573485472759047548275024574207");
+
+    r.start_clock();
+    try {
+        unsigned long long u = to_unsigned_long_long(n);
+        r.stop_clock();
+
+        r.get_stream() << u << " (failed to throw exception)";
+        r.set_pass(false);
+    } catch (const c8::overflow_error &e) {
+        r.stop_clock();
+
+        r.get_stream() << "exception thrown: " + std::string(e.what());
+        r.set_pass(true);
+    } catch (...) {
+        r.stop_clock();
+
+        r.get_stream() << "unexpected exception thrown";
+        r.set_pass(false);
+    }
+
+    return r;
+}
+
+/*
+ * Test to_unsigned_long_long functionality.
+ */
+auto test_natural_to_unsigned_long_long_3() -> result {
+    result r("nat toull 3");
+    c8::natural n(0x123456789a);
+
+    r.start_clock();
+    unsigned long long u = to_unsigned_long_long(n);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << u;
+    r.check_pass("123456789a");
+    return r;
+}
+
+/*
+ * Test to_unsigned_long_long functionality.
+ */
+auto test_natural_to_unsigned_long_long_4() -> result {
+    result r("nat toull 4");
+    c8::natural n0(1);
+    c8::natural n1 = n0 << (sizeof(unsigned long long) * 8);
+
+    /*
+     * Construct a natural number that is one bit too large to be able to convert.
+     */
+    r.start_clock();
+    try {
+        unsigned long long u = to_unsigned_long_long(n1);
+        r.stop_clock();
+
+        r.get_stream() << u << " (failed to throw exception)";
+        r.set_pass(false);
+    } catch (const c8::overflow_error &e) {
+        r.stop_clock();
+
+        r.get_stream() << "exception thrown: " + std::string(e.what());
+        r.set_pass(true);
+    } catch (...) {
+        r.stop_clock();
+
+        r.get_stream() << "unexpected exception thrown";
+        r.set_pass(false);
+    }
+
+    return r;
+}
+
+/*
+ * A natural allocator that counts the digits that are currently allocated, and the number
+ * of allocations made.
+ */
+class counting_allocator : public c8::natural_allocator {
+public:
+    auto allocate(std::size_t num_digits) -> c8::natural_digit * override {
+        allocated_ += num_digits;
+        allocations_++;
+        return c8::natural_allocator::heap().allocate(num_digits);
+    }
+
+    auto deallocate(c8::natural_digit *p, std::size_t num_digits) noexcept -> void override {
+        allocated_ -= num_digits;
+        c8::natural_allocator::heap().deallocate(p, num_digits);
+    }
+
+    std::size_t allocated_ = 0;
+    std::size_t allocations_ = 0;
+};
+
+/*
+ * Test that large numbers take their digits from the current allocator, and return them to
+ * the same allocator even after it is no longer current.
+ */
+auto test_natural_allocator_0() -> result {
+    result r("nat alloc 0");
+    counting_allocator a;
+    std::size_t in_scope;
+    c8::natural v2;
+
+    r.start_clock();
+    {
+        c8::natural_allocator_scope scope(a);
+        c8::natural v0("0x123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+        c8::natural v1 = v0 * v0;
+        v2 = std::move(v1);
+        in_scope = a.allocated_;
+    }
+
+    c8::natural v3 = v2 * v2;
+    std::size_t after_scope = a.allocated_;
+    v2 = 0;
+    r.stop_clock();
+
+    r.get_stream() << ((in_scope != 0) ? "allocated" : "not allocated") << ','
+                   << ((after_scope != 0) ? "held" : "not held") << ','
+                   << a.allocated_;
+    r.check_pass("allocated,held,0");
+    return r;
+}
+
+/*
+ * Test calculations using an arena allocator.
+ */
+auto test_natural_allocator_1() -> result {
+    result r("nat alloc 1");
+    c8::natural_arena_allocator a(256);
+    c8::natural f;
+
+    r.start_clock();
+    {
+        c8::natural_allocator_scope scope(a);
+        c8::natural f0(0);
+        c8::natural f1(1);
+        for (int i = 0; i < 1000; i++) {
+            f0 += f1;
+            std::swap(f0, f1);
+        }
+
+        c8::natural_allocator_scope heap_scope(c8::natural_allocator::heap());
+        f = f0;
+    }
+    r.stop_clock();
+
+    r.get_stream() << (f % c8::natural(1000000007));
+    r.check_pass("517691607");
+    return r;
+}
+
+/*
+ * Test that arithmetic on temporaries reuses their digits.
+ */
+auto test_natural_temporary_0() -> result {
+    result r("nat temp 0");
+    c8::natural a("0x123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+    c8::natural b("0xfedcba9876543210fedcba9876543210fedcba9876543210fedcba9876543210fedcba9876543210");
+    c8::natural c("0x1111111111111111111111111111111111111111111111111111111111111111111111111111111");
+    counting_allocator alloc;
+    c8::natural d;
+    c8::natural e;
+
+    r.start_clock();
+    {
+        c8::natural_allocator_scope scope(alloc);
+        d = a * b + c;
+        e = ((c + a * b) - c) / b;
+    }
+    r.stop_clock();
+
+    c8::natural ab = a * b;
+    r.get_stream() << alloc.allocations_ << ',' << ((d == (ab + c)) ? "equal" : "not equal")
+                   << ',' << ((e == a) ? "equal" : "not equal");
+    r.check_pass("2,equal,equal");
+    return r;
+}
+
+/*
+ * Add a product to a natural number, with carries through every digit.
+ */
+auto test_natural_addmul_0() -> result {
+    result r("nat addmul 0");
+    c8::natural v("0xffffffffffffffffffffffffffffffff");
+    c8::natural x = v;
+
+    r.start_clock();
+    x.addmul(v, v);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << x;
+    r.check_pass("ffffffffffffffffffffffffffffffff00000000000000000000000000000000");
+    return r;
+}
+
+/*
+ * Add a product to a natural number, using both the row-by-row and the sub-quadratic
+ * multiplies, and with the natural number also being one of the operands.
+ */
+auto test_natural_addmul_1() -> result {
+    result r("nat addmul 1");
+    c8::natural a = (c8::natural(1) << 3000) / c8::natural(7);
+    c8::natural b = (c8::natural(1) << 2500) / c8::natural(11);
+    c8::natural c("0x123456789abcdef0123456789abcdef0123456789abcdef");
+    c8::natural x0 = c;
+    c8::natural x1 = c;
+    c8::natural x2 = a;
+
+    r.start_clock();
+    x0.addmul(a, b);
+    x1.addmul(a, c);
+    x2.addmul(x2, b);
+    r.stop_clock();
+
+    r.get_stream() << ((x0 == (c + a * b)) ? "equal" : "not equal") << ','
+                   << ((x1 == (c + a * c)) ? "equal" : "not equal") << ','
+                   << ((x2 == (a + a * b)) ? "equal" : "not equal");
+    r.check_pass("equal,equal,equal");
+    return r;
+}
+
+/*
+ * Subtract a product from a natural number, with borrows through every digit.
+ */
+auto test_natural_submul_0() -> result {
+    result r("nat submul 0");
+    c8::natural v("0xffffffffffffffffffffffffffffffff");
+    c8::natural x = c8::natural(1) << 256;
+
+    r.start_clock();
+    x.submul(v, v);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << x;
+    r.check_pass("1ffffffffffffffffffffffffffffffff");
+    return r;
+}
+
+/*
+ * Subtract a product from a natural number, using both the row-by-row and the
+ * sub-quadratic multiplies.
+ */
+auto test_natural_submul_1() -> result {
+    result r("nat submul 1");
+    c8::natural a = (c8::natural(1) << 3000) / c8::natural(7);
+    c8::natural b = (c8::natural(1) << 2500) / c8::natural(11);
+    c8::natural c("0x123456789abcdef0123456789abcdef0123456789abcdef");
+    c8::natural ab = a * b;
+    c8::natural ac = a * c;
+    c8::natural x0 = ab + c;
+    c8::natural x1 = ac + c;
+
+    r.start_clock();
+    x0.submul(a, b);
+    x1.submul(c, a);
+    r.stop_clock();
+
+    r.get_stream() << ((x0 == c) ? "equal" : "not equal") << ','
+                   << ((x1 == c) ? "equal" : "not equal");
+    r.check_pass("equal,equal");
+    return r;
+}
+
+/*
+ * Subtract a product that is larger than the natural number it is subtracted from.
+ */
+auto test_natural_submul_2() -> result {
+    result r("nat submul 2");
+    c8::natural v("0xffffffffffffffffffffffffffffffff");
+    c8::natural x = v * v - c8::natural(1);
+
+    r.start_clock();
+    try {
+        x.submul(v, v);
+        r.stop_clock();
+        r.get_stream() << "failed to throw exception";
+    } catch (const c8::not_a_number &e) {
+        r.stop_clock();
+        r.get_stream() << "exception: " << e.what() << ',' << ((x == (v * v - c8::natural(1))) ? "unchanged" : "changed");
+    } catch (...) {
+        r.stop_clock();
+        r.get_stream() << "unexpected exception";
+    }
+
+    r.check_pass("exception: not a number,unchanged");
+    return r;
+}
+
+/*
+ * Test that a sum of products is evaluated directly into its destination.
+ */
+auto test_natural_expr_0() -> result {
+    result r("nat expr 0");
+    c8::natural a("0x123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+    c8::natural b("0xfedcba9876543210fedcba9876543210fedcba9876543210fedcba9876543210fedcba9876543210");
+    c8::natural c("0x1111111111111111111111111111111111111111111111111111111111111111");
+    c8::natural d("0x2222222222222222222222222222222222222222222222222222222222222222");
+    counting_allocator alloc;
+    c8::natural e;
+
+    r.start_clock();
+    {
+        c8::natural_allocator_scope scope(alloc);
+        c8::expr::assign(e, c8::expr::lazy(c) * d + c8::expr::lazy(a) * b);
     }
+    r.stop_clock();
 
+    r.get_stream() << alloc.allocations_ << ',' << ((e == (a * b + c * d)) ? "equal" : "not equal");
+    r.check_pass("1,equal");
     return r;
 }
 
 /*
- * Test to_unsigned_long_long functionality.
+ * Test that a modular product can be evaluated back into one of its operands.
  */
-auto test_natural_to_unsigned_long_long_3() -> result {
-    result r("nat toull 3");
-    c8::natural n(0x123456789a);
+auto test_natural_expr_1() -> result {
+    result r("nat expr 1");
+    c8::natural x("0x123456789abcdef0123456789abcdef0123456789abcdef");
+    c8::natural y("0xfedcba9876543210fedcba9876543210fedcba9876543210");
+    c8::natural m("0xf123456789abcdef0123456789abcdef0123456789abcdeb");
+    c8::natural z = x;
+    counting_allocator alloc;
 
     r.start_clock();
-    unsigned long long u = to_unsigned_long_long(n);
+    {
+        c8::natural_allocator_scope scope(alloc);
+        for (int i = 0; i < 100; i++) {
+            c8::expr::assign(x, c8::expr::lazy(x) * y % m);
+        }
+    }
     r.stop_clock();
 
-    r.get_stream() << std::hex << u;
-    r.check_pass("123456789a");
+    for (int i = 0; i < 100; i++) {
+        z = z * y % m;
+    }
+
+    r.get_stream() << alloc.allocations_ << ',' << ((x == z) ? "equal" : "not equal");
+    r.check_pass("0,equal");
     return r;
 }
 
 /*
- * Test to_unsigned_long_long functionality.
+ * Test expressions whose destination is also one of their operands.
  */
-auto test_natural_to_unsigned_long_long_4() -> result {
-    result r("nat toull 4");
-    c8::natural n0(1);
-    c8::natural n1 = n0 << (sizeof(unsigned long long) * 8);
+auto test_natural_expr_2() -> result {
+    result r("nat expr 2");
+    c8::natural a("0x123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+    c8::natural b("0xfedcba9876543210fedcba9876543210fedcba9876543210");
+    c8::natural c("0x1111111111111111111111111111111111111111111111111111111111111111");
+    c8::natural m("0xf123456789abcdef0123456789abcdef0123456789abcdeb");
+    c8::natural x0 = a;
+    c8::natural x1 = a;
+    c8::natural x2 = a * a;
+    c8::natural x3 = a;
+
+    r.start_clock();
+    c8::expr::assign(x0, c8::expr::lazy(c) + c8::expr::lazy(x0) * x0);
+    c8::expr::assign(x1, c8::expr::lazy(x1) * b + c8::expr::lazy(x1) * c);
+    c8::expr::assign(x2, c8::expr::lazy(x2) - c8::expr::lazy(b) * b);
+    c8::expr::assign(x3, (c8::expr::lazy(x3) + b) * (c8::expr::lazy(c) - x3) % m);
+    r.stop_clock();
+
+    r.get_stream() << ((x0 == (c + a * a)) ? "equal" : "not equal") << ','
+                   << ((x1 == (a * b + a * c)) ? "equal" : "not equal") << ','
+                   << ((x2 == (a * a - b * b)) ? "equal" : "not equal") << ','
+                   << ((x3 == ((a + b) * (c - a) % m)) ? "equal" : "not equal");
+    r.check_pass("equal,equal,equal,equal");
+    return r;
+}
+
+/*
+ * Test that subtracting a larger product throws an exception.
+ */
+auto test_natural_expr_3() -> result {
+    result r("nat expr 3");
+    c8::natural a("0x123456789abcdef0123456789abcdef");
+    c8::natural b("0xfedcba9876543210fedcba9876543210");
+    c8::natural x = a;
 
-    /*
-     * Construct a natural number that is one bit too large to be able to convert.
-     */
     r.start_clock();
     try {
-        unsigned long long u = to_unsigned_long_long(n1);
+        c8::expr::assign(x, c8::expr::lazy(x) - c8::expr::lazy(a) * b);
         r.stop_clock();
-
-        r.get_stream() << u << " (failed to throw exception)";
-        r.set_pass(false);
-    } catch (const c8::overflow_error &e) {
+        r.get_stream() << "failed to throw exception";
+    } catch (const c8::not_a_number &e) {
         r.stop_clock();
-
-        r.get_stream() << "exception thrown: " + std::string(e.what());
-        r.set_pass(true);
+        r.get_stream() << "exception: " << e.what() << ',' << ((x == a) ? "unchanged" : "changed");
     } catch (...) {
         r.stop_clock();
+        r.get_stream() << "unexpected exception";
+    }
 
-        r.get_stream() << "unexpected exception thrown";
-        r.set_pass(false);
+    r.check_pass("exception: not a number,unchanged");
+    return r;
+}
+
+/*
+ * Test that a negative difference leaves a destination that isn't the value subtracted
+ * from unchanged.
+ */
+auto test_natural_expr_4() -> result {
+    result r("nat expr 4");
+    c8::natural a("0x123456789abcdef0123456789abcdef");
+    c8::natural b("0xfedcba9876543210fedcba9876543210");
+    c8::natural c(12345);
+    c8::natural x(42);
+    c8::natural y(43);
+    c8::natural z(44);
+
+    r.start_clock();
+    bool thrown_x = false;
+    try {
+        c8::expr::assign(x, c8::expr::lazy(c) - c8::expr::lazy(a) * b);
+    } catch (const c8::not_a_number &) {
+        thrown_x = true;
+    }
+
+    bool thrown_y = false;
+    try {
+        c8::expr::assign(y, c8::expr::lazy(c) + c - c8::expr::lazy(a) * b);
+    } catch (const c8::not_a_number &) {
+        thrown_y = true;
+    }
+
+    bool thrown_z = false;
+    try {
+        c8::expr::assign(z, c8::expr::lazy(c) * c - a);
+    } catch (const c8::not_a_number &) {
+        thrown_z = true;
+    }
+
+    c8::expr::assign(c, c8::expr::lazy(a) * b - c);
+    r.stop_clock();
+
+    r.get_stream() << thrown_x << thrown_y << thrown_z << ',' << x << ',' << y << ',' << z << ','
+                   << (c == a * b - 12345);
+    r.check_pass("111,42,43,44,1");
+    return r;
+}
+
+/*
+ * Test arithmetic with unsigned long long operands.
+ */
+auto test_natural_word_0() -> result {
+    result r("nat word 0");
+    c8::natural v("0x123456789abcdef0123456789abcdef0123456789abcdef");
+    unsigned long long w = 0xfedcba9876543210ULL;
+
+    r.start_clock();
+    c8::natural a = v + w;
+    c8::natural s = v - w;
+    c8::natural m = v * w;
+    c8::natural q = v / w;
+    c8::natural rem = v % w;
+    r.stop_clock();
+
+    r.get_stream() << a << ',' << s << ',' << m << ',' << q << ',' << rem;
+    r.check_pass("27898229935051914142968983831921934153765785580712493055,"
+                 "27898229935051914142968983831921934117036268491726363615,"
+                 "512344256575976838272066073586653241835882379646115693457312906530556841200,"
+                 "1519117709468475263548385737342778053,"
+                 "9838681799494838175");
+    return r;
+}
+
+/*
+ * Test compound assignment with unsigned long long operands.
+ */
+auto test_natural_word_1() -> result {
+    result r("nat word 1");
+    c8::natural x("0x123456789abcdef0123456789abcdef0123456789abcdef");
+    unsigned long long w = 0xfedcba9876543210ULL;
+
+    r.start_clock();
+    x += w;
+    r.get_stream() << x << ',';
+    x -= 1;
+    r.get_stream() << x << ',';
+    x *= w;
+    r.get_stream() << x << ',';
+    x /= 7;
+    r.get_stream() << x << ',';
+    x %= w;
+    r.stop_clock();
+
+    r.get_stream() << x;
+    r.check_pass("27898229935051914142968983831921934153765785580712493055,"
+                 "27898229935051914142968983831921934153765785580712493054,"
+                 "512344256575976838272066073586653242173146736043646722433921196164172454880,"
+                 "73192036653710976896009439083807606024735248006235246061988742309167493554,"
+                 "2623536934927580674");
+    return r;
+}
+
+/*
+ * Test comparisons with unsigned long long operands.
+ */
+auto test_natural_word_2() -> result {
+    result r("nat word 2");
+    c8::natural v("0x123456789abcdef0123456789abcdef");
+    c8::natural n(0xfedcba9876543210ULL);
+    unsigned long long w = 0xfedcba9876543210ULL;
+
+    r.start_clock();
+    r.get_stream() << (n == w) << (n != w) << (n > w) << (n >= w) << (n < w) << (n <= w) << ','
+                   << (n == (w - 1)) << (n > (w - 1)) << (n < (w + 1)) << ','
+                   << (v == w) << (v > w) << (v < w) << ','
+                   << (c8::natural(0) == 0) << (c8::natural(0) < 1);
+    r.stop_clock();
+
+    r.check_pass("100101,011,010,11");
+    return r;
+}
+
+/*
+ * Test that unsigned long long operands report errors in the same way as natural numbers.
+ */
+auto test_natural_word_3() -> result {
+    result r("nat word 3");
+    c8::natural v(5);
+
+    r.start_clock();
+    try {
+        c8::natural x = v - 6;
+        r.get_stream() << "failed to throw exception,";
+    } catch (const c8::not_a_number &e) {
+        r.get_stream() << "exception: " << e.what() << ',';
+    }
+
+    try {
+        c8::natural x = v / 0;
+        r.get_stream() << "failed to throw exception";
+    } catch (const c8::divide_by_zero &e) {
+        r.get_stream() << "exception: " << e.what();
     }
+    r.stop_clock();
 
+    r.check_pass("exception: not a number,exception: divide by zero");
     return r;
 }
 
@@ -2501,3 +3801,299 @@ auto test_natural_print_7() -> result {
     return r;
 }
 
+
+/*
+ * Test printing a very large decimal number.  This is large enough to need the recursive
+ * decimal conversion, and 10^n has long runs of zeros that need to be padded correctly.
+ */
+auto test_natural_print_8() -> result {
+    result r("nat prn 8");
+    c8::natural v(1);
+    for (int i = 0; i < 5000; i++) {
+        v *= 10;
+    }
+
+    c8::natural u = v - 1;
+
+    std::stringstream sv;
+    std::stringstream su;
+
+    r.start_clock();
+    sv << v;
+    su << u;
+    r.stop_clock();
+
+    r.get_stream() << ((sv.str() == ("1" + std::string(5000, '0'))) ? "equal" : "not equal") << ','
+                   << ((su.str() == std::string(5000, '9')) ? "equal" : "not equal");
+    r.check_pass("equal,equal");
+    return r;
+}
+
+/*
+ * Test printing a very large hexadecimal number.  The value has a bit pattern that doesn't
+ * line up with the digit boundaries, so each character has to be extracted across them.
+ */
+auto test_natural_print_9() -> result {
+    result r("nat prn 9");
+    std::string s = "0x" + std::string(2000, '0');
+    for (std::size_t i = 2; i < s.size(); i++) {
+        s[i] = "0123456789abcdef"[(i * 7) % 16];
+    }
+
+    c8::natural v(s);
+    std::stringstream sv;
+    std::stringstream su;
+
+    r.start_clock();
+    sv << std::showbase << std::hex << v;
+    su << std::oct << (v >> 1);
+    r.stop_clock();
+
+    c8::natural u("0" + su.str());
+
+    r.get_stream() << ((sv.str() == s) ? "equal" : "not equal") << ','
+                   << (((u << 1) + (v % 2) == v) ? "equal" : "not equal");
+    r.check_pass("equal,equal");
+    return r;
+}
+
+/*
+ * Test conversion to characters.
+ */
+auto test_natural_to_chars_0() -> result {
+    result r("nat tch 0");
+    c8::natural v("0xfedcfedc0123456789");
+    char buf[64];
+
+    r.start_clock();
+    auto res = to_chars(buf, buf + sizeof(buf), v);
+    r.stop_clock();
+
+    r.get_stream() << std::string(buf, res.ptr);
+    r.check_pass("4701397401952099592073");
+    return r;
+}
+
+/*
+ * Test conversion to characters in power-of-two bases.
+ */
+auto test_natural_to_chars_1() -> result {
+    result r("nat tch 1");
+    c8::natural v("0xfedcfedc0123456789");
+    char buf[256];
+
+    r.start_clock();
+    auto res0 = to_chars(buf, buf + sizeof(buf), v, 16);
+    *res0.ptr++ = ',';
+    auto res1 = to_chars(res0.ptr, buf + sizeof(buf), v, 8);
+    *res1.ptr++ = ',';
+    auto res2 = to_chars(res1.ptr, buf + sizeof(buf), v, 2);
+    r.stop_clock();
+
+    r.get_stream() << std::string(buf, res2.ptr);
+    r.check_pass("fedcfedc0123456789,775563766700044321263611,"
+                 "111111101101110011111110110111000000000100100011010001010110011110001001");
+    return r;
+}
+
+/*
+ * Test conversion to characters in bases 4 and 32.
+ */
+auto test_natural_to_chars_2() -> result {
+    result r("nat tch 2");
+    c8::natural v("0xfedcfedc0123456789");
+    char buf[256];
+
+    r.start_clock();
+    auto res0 = to_chars(buf, buf + sizeof(buf), v, 4);
+    *res0.ptr++ = ',';
+    auto res1 = to_chars(res0.ptr, buf + sizeof(buf), v, 32);
+    r.stop_clock();
+
+    r.get_stream() << std::string(buf, res1.ptr);
+    r.check_pass("333231303332313000010203101112132021,3vdpvms04hkaps9");
+    return r;
+}
+
+/*
+ * Test conversion to characters with buffers that are only just large enough, or too small.
+ */
+auto test_natural_to_chars_3() -> result {
+    result r("nat tch 3");
+    c8::natural v0(999);
+    c8::natural v1(1000);
+    char buf[3];
+
+    r.start_clock();
+    auto res0 = to_chars(buf, buf + sizeof(buf), v0);
+    auto res1 = to_chars(buf, buf + sizeof(buf), v1);
+    r.stop_clock();
+
+    r.get_stream() << std::string(buf, res0.ptr) << ','
+                   << ((res1.ec == std::errc::value_too_large) ? "too large" : "fits");
+    r.check_pass("999,too large");
+    return r;
+}
+
+/*
+ * Test decimal conversion of large values into exact-size and one-short buffers.  These
+ * sizes are where our initial width estimate can be several characters too large.
+ */
+auto test_natural_to_chars_4() -> result {
+    result r("nat tch 4");
+    c8::natural p10(1);
+    for (int i = 0; i < 3000; i++) {
+        p10 *= 10;
+    }
+
+    c8::natural p2 = c8::natural(1) << 12345;
+    c8::natural p3 = c8::natural(3) << 30000;
+    c8::natural vals[] = {p10, p10 - 1, p2, p2 - 1, p3};
+
+    r.start_clock();
+    for (const auto &v : vals) {
+        std::ostringstream s;
+        s << v;
+        std::string expected = s.str();
+        std::vector<char> buf(expected.size());
+        auto res0 = to_chars(buf.data(), buf.data() + buf.size(), v);
+        auto res1 = to_chars(buf.data(), buf.data() + buf.size() - 1, v);
+        r.get_stream() << ((res0.ec == std::errc()) && (std::string(buf.data(), res0.ptr) == expected))
+                       << (res1.ec == std::errc::value_too_large) << ',';
+    }
+    r.stop_clock();
+
+    r.check_pass("11,11,11,11,11,");
+    return r;
+}
+
+/*
+ * Test that small conversions don't allocate, including ones into exact-size buffers that
+ * need the exact decimal width to be found.
+ */
+auto test_natural_to_chars_5() -> result {
+    result r("nat tch 5");
+    c8::natural v0(99999);
+    c8::natural v1 = c8::natural(1) << 199;
+    c8::integer v2(-12345);
+    c8::rational v3(22, 7);
+    char buf0[5];
+    char buf1[60];
+    char buf2[16];
+    char buf3[16];
+    char buf4[64];
+
+    std::size_t calls = operator_new_calls;
+    r.start_clock();
+    auto res0 = to_chars(buf0, buf0 + sizeof(buf0), v0);
+    auto res1 = to_chars(buf1, buf1 + sizeof(buf1), v1);
+    auto res2 = to_chars(buf2, buf2 + sizeof(buf2), v2);
+    auto res3 = to_chars(buf3, buf3 + sizeof(buf3), v3);
+    auto res4 = to_chars(buf4, buf4 + sizeof(buf4), v1, 16);
+    r.stop_clock();
+    calls = operator_new_calls - calls;
+
+    r.get_stream() << std::string(buf0, res0.ptr) << ',' << (res1.ptr - buf1) << ',' << std::string(buf2, res2.ptr) << ','
+                   << std::string(buf3, res3.ptr) << ',' << std::string(buf4, res4.ptr) << ',' << calls;
+    r.check_pass("99999,60,-12345,22/7,80000000000000000000000000000000000000000000000000,0");
+    return r;
+}
+
+/*
+ * Test divides and GCDs that mix operands too large for the per-thread scratch arena with
+ * operands that fit within it.  A remainder whose scratch space fits in the arena should
+ * only allocate the remainder itself, both before and after the larger operations, which
+ * checks that all of their scratch space has been released.
+ */
+auto test_natural_scratch_0() -> result {
+    result r("nat scratch 0");
+    unsigned int fit_bits = static_cast<unsigned int>(1000 * c8::natural_digit_bits);
+    unsigned int big_bits = static_cast<unsigned int>(40000 * c8::natural_digit_bits);
+    c8::natural fit_n = (c8::natural(1) << (2 * fit_bits)) / 3 + 6789;
+    c8::natural fit_d = (c8::natural(1) << fit_bits) / 11 + 3;
+    c8::natural big_n = (c8::natural(1) << (2 * big_bits)) / 3 + 12345;
+    c8::natural big_d = (c8::natural(1) << big_bits) / 7 + 1;
+    c8::natural big_x = (c8::natural(1) << big_bits) + 1;
+    c8::natural big_y = (c8::natural(1) << big_bits) - 1;
+
+    std::size_t fit_calls = operator_new_calls;
+    c8::natural fit_rem = fit_n % fit_d;
+    fit_calls = operator_new_calls - fit_calls;
+
+    r.start_clock();
+    c8::natural q0 = big_n / big_d;
+    c8::natural m0 = big_n % big_d;
+    c8::natural q1 = big_n / fit_d;
+    c8::natural m1 = big_n % fit_d;
+    c8::natural q2 = fit_n / fit_d;
+    c8::natural m2 = fit_n % fit_d;
+    c8::natural g0 = gcd(big_x * fit_d, big_y * fit_d);
+    c8::natural g1 = gcd(big_n, fit_d * 3);
+    c8::natural g2 = gcd(fit_n * 3, fit_d * 3);
+    r.stop_clock();
+
+    std::size_t calls = operator_new_calls;
+    fit_rem = fit_n % fit_d;
+    calls = operator_new_calls - calls;
+
+    r.get_stream() << ((q0 * big_d + m0) == big_n) << (m0 < big_d) << ','
+                   << ((q1 * fit_d + m1) == big_n) << (m1 < fit_d) << ','
+                   << ((q2 * fit_d + m2) == fit_n) << (m2 < fit_d) << ','
+                   << (g0 == fit_d) << (g1 == gcd(big_n % (fit_d * 3), fit_d * 3)) << (g2 == gcd(fit_d * 3, m2 * 3))
+                   << ','
+                   << (fit_rem == m2) << ',' << fit_calls << calls;
+    r.check_pass("11,11,11,111,1,11");
+    return r;
+}
+
+/*
+ * Test conversion from characters.
+ */
+auto test_natural_from_chars_0() -> result {
+    result r("nat fch 0");
+    std::string s = "4701397401952099592073xyz";
+    c8::natural v;
+
+    r.start_clock();
+    auto res = from_chars(s.data(), s.data() + s.size(), v);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << v << ',' << std::dec << (res.ptr - s.data());
+    r.check_pass("fedcfedc0123456789,22");
+    return r;
+}
+
+/*
+ * Test conversion from characters in base 32.
+ */
+auto test_natural_from_chars_1() -> result {
+    result r("nat fch 1");
+    std::string s = "3VDPVms04hkaps9!";
+    c8::natural v;
+
+    r.start_clock();
+    auto res = from_chars(s.data(), s.data() + s.size(), v, 32);
+    r.stop_clock();
+
+    r.get_stream() << std::hex << v << ',' << std::dec << (res.ptr - s.data());
+    r.check_pass("fedcfedc0123456789,15");
+    return r;
+}
+
+/*
+ * Test conversion from characters with invalid input.
+ */
+auto test_natural_from_chars_2() -> result {
+    result r("nat fch 2");
+    std::string s = "9fe";
+    c8::natural v(42);
+
+    r.start_clock();
+    auto res = from_chars(s.data(), s.data() + s.size(), v, 8);
+    r.stop_clock();
+
+    r.get_stream() << v << ',' << (res.ptr - s.data()) << ','
+                   << ((res.ec == std::errc::invalid_argument) ? "invalid" : "valid");
+    r.check_pass("42,0,invalid");
+    return r;
+}
@@ -14,6 +14,8 @@ auto test_natural_construct_4() -> result;
 auto test_natural_construct_5() -> result;
 auto test_natural_construct_6() -> result;
 auto test_natural_construct_7() -> result;
+auto test_natural_construct_8() -> result;
+auto test_natural_construct_9() -> result;
 auto test_natural_size_bits_0() -> result;
 auto test_natural_size_bits_1() -> result;
 auto test_natural_size_bits_2() -> result;
@@ -104,6 +106,19 @@ auto test_natural_multiply_4a() -> result;
 auto test_natural_multiply_4b() -> result;
 auto test_natural_multiply_5a() -> result;
 auto test_natural_multiply_5b() -> result;
+auto test_natural_multiply_6a() -> result;
+auto test_natural_multiply_6b() -> result;
+auto test_natural_multiply_7a() -> result;
+auto test_natural_multiply_7b() -> result;
+auto test_natural_multiply_7c() -> result;
+auto test_natural_multiply_8a() -> result;
+auto test_natural_multiply_8b() -> result;
+auto test_natural_multiply_9a() -> result;
+auto test_natural_multiply_9b() -> result;
+auto test_natural_square_0a() -> result;
+auto test_natural_square_0b() -> result;
+auto test_natural_square_1a() -> result;
+auto test_natural_square_1b() -> result;
 auto test_natural_divide_0a() -> result;
 auto test_natural_divide_0b() -> result;
 auto test_natural_divide_0c() -> result;
@@ -131,16 +146,59 @@ auto test_natural_divide_7c() -> result;
 auto test_natural_divide_8a() -> result;
 auto test_natural_divide_8b() -> result;
 auto test_natural_divide_8c() -> result;
+auto test_natural_divide_9a() -> result;
+auto test_natural_divide_9b() -> result;
+auto test_natural_divide_10a() -> result;
+auto test_natural_divide_10b() -> result;
+auto test_natural_divide_11() -> result;
+auto test_natural_divisor_0a() -> result;
+auto test_natural_divisor_0b() -> result;
+auto test_natural_divisor_0c() -> result;
+auto test_natural_divisor_1() -> result;
+auto test_natural_divisor_2() -> result;
+auto test_natural_divisor_3() -> result;
+auto test_natural_divisor_4() -> result;
 auto test_natural_gcd_0() -> result;
 auto test_natural_gcd_1() -> result;
 auto test_natural_gcd_2() -> result;
 auto test_natural_gcd_3() -> result;
 auto test_natural_gcd_4() -> result;
+auto test_natural_gcd_5() -> result;
+auto test_natural_gcd_6() -> result;
+auto test_natural_gcd_7() -> result;
+auto test_natural_inverse_mod_0() -> result;
+auto test_natural_inverse_mod_1() -> result;
+auto test_natural_inverse_mod_2() -> result;
+auto test_natural_pow_mod_0() -> result;
+auto test_natural_pow_mod_1() -> result;
+auto test_natural_pow_mod_2() -> result;
+auto test_natural_pow_mod_3() -> result;
+auto test_natural_pow_mod_4() -> result;
+auto test_natural_pow_mod_5() -> result;
+auto test_natural_pow_mod_6() -> result;
+auto test_natural_pow_mod_7() -> result;
 auto test_natural_to_unsigned_long_long_0() -> result;
 auto test_natural_to_unsigned_long_long_1() -> result;
 auto test_natural_to_unsigned_long_long_2() -> result;
 auto test_natural_to_unsigned_long_long_3() -> result;
 auto test_natural_to_unsigned_long_long_4() -> result;
+auto test_natural_allocator_0() -> result;
+auto test_natural_allocator_1() -> result;
+auto test_natural_temporary_0() -> result;
+auto test_natural_addmul_0() -> result;
+auto test_natural_addmul_1() -> result;
+auto test_natural_submul_0() -> result;
+auto test_natural_submul_1() -> result;
+auto test_natural_submul_2() -> result;
+auto test_natural_expr_0() -> result;
+auto test_natural_expr_1() -> result;
+auto test_natural_expr_2() -> result;
+auto test_natural_expr_3() -> result;
+auto test_natural_expr_4() -> result;
+auto test_natural_word_0() -> result;
+auto test_natural_word_1() -> result;
+auto test_natural_word_2() -> result;
+auto test_natural_word_3() -> result;
 auto test_natural_print_0() -> result;
 auto test_natural_print_1() -> result;
 auto test_natural_print_2() -> result;
@@ -149,6 +207,18 @@ auto test_natural_print_4() -> result;
 auto test_natural_print_5() -> result;
 auto test_natural_print_6() -> result;
 auto test_natural_print_7() -> result;
+auto test_natural_print_8() -> result;
+auto test_natural_print_9() -> result;
+auto test_natural_to_chars_0() -> result;
+auto test_natural_to_chars_1() -> result;
+auto test_natural_to_chars_2() -> result;
+auto test_natural_to_chars_3() -> result;
+auto test_natural_to_chars_4() -> result;
+auto test_natural_to_chars_5() -> result;
+auto test_natural_scratch_0() -> result;
+auto test_natural_from_chars_0() -> result;
+auto test_natural_from_chars_1() -> result;
+auto test_natural_from_chars_2() -> result;
 
 #endif // __NATURAL_CHECK_H
 
@@ -1,6 +1,9 @@
 /*
  * rational_check.cpp
  */
+#include <limits>
+#include <sstream>
+
 #include <c8.h>
 
 #include "result.h"
@@ -332,6 +335,23 @@ auto test_rational_add_3b() -> result {
     return r;
 }
 
+/*
+ * Add two values with a common factor in their denominators.
+ */
+auto test_rational_add_4() -> result {
+    result r("rat add 4");
+    c8::rational a0(7, 12);
+    c8::rational a1(5, 18);
+
+    r.start_clock();
+    auto a2 = a0 + a1;
+    r.stop_clock();
+
+    r.get_stream() << a2;
+    r.check_pass("31/36");
+    return r;
+}
+
 /*
  * Subtract a 1 digit value from another 1 digit value.
  */
@@ -468,6 +488,23 @@ auto test_rational_subtract_3b() -> result {
     return r;
 }
 
+/*
+ * Subtract a value from itself.  The result must have a denominator of 1.
+ */
+auto test_rational_subtract_4() -> result {
+    result r("rat sub 4");
+    c8::rational s0("-123456789012345678901234567890/97");
+    c8::rational s1("-123456789012345678901234567890/97");
+
+    r.start_clock();
+    auto s2 = s0 - s1;
+    r.stop_clock();
+
+    r.get_stream() << s2;
+    r.check_pass("0/1");
+    return r;
+}
+
 /*
  * Compare two positive values.
  */
@@ -876,6 +913,74 @@ auto test_rational_compare_3f() -> result {
     return r;
 }
 
+/*
+ * Compare two large values that are very close together.
+ */
+auto test_rational_compare_4a() -> result {
+    result r("rat comp 4a");
+    c8::rational co0("1234567890123456789012345678901234567890123/987654321098765432109876543210987");
+    c8::rational co1("1234567890123456789012345678901234567890124/987654321098765432109876543210987");
+
+    r.start_clock();
+    auto co2 = (co0 < co1);
+    r.stop_clock();
+
+    r.get_stream() << co2;
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Compare two large values that are very close together, but have different denominators.
+ */
+auto test_rational_compare_4b() -> result {
+    result r("rat comp 4b");
+    c8::rational co0("1234567890123456789012345678901234567890123/987654321098765432109876543210987");
+    c8::rational co1("1234567890123456789012345678901234567890125/987654321098765432109876543210989");
+
+    r.start_clock();
+    auto co2 = (co0 > co1);
+    r.stop_clock();
+
+    r.get_stream() << co2;
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Compare two negative values with the same numerator.
+ */
+auto test_rational_compare_4c() -> result {
+    result r("rat comp 4c");
+    c8::rational co0(-17, 5);
+    c8::rational co1(-17, 6);
+
+    r.start_clock();
+    auto co2 = (co0 < co1);
+    r.stop_clock();
+
+    r.get_stream() << co2;
+    r.check_pass("1");
+    return r;
+}
+
+/*
+ * Compare two values of very different sizes.
+ */
+auto test_rational_compare_4d() -> result {
+    result r("rat comp 4d");
+    c8::rational co0("100000000000000000000000000000000000000/3");
+    c8::rational co1("-7/100000000000000000000000000000000000000");
+
+    r.start_clock();
+    auto co2 = (co0 <= co1);
+    r.stop_clock();
+
+    r.get_stream() << co2;
+    r.check_pass("0");
+    return r;
+}
+
 /*
  * Test multiplication.
  */
@@ -1012,6 +1117,23 @@ auto test_rational_multiply_3b() -> result {
     return r;
 }
 
+/*
+ * Multiply two values where the numerator of each shares factors with the denominator of the other.
+ */
+auto test_rational_multiply_4() -> result {
+    result r("rat mul 4");
+    c8::rational mu0(-21, 22);
+    c8::rational mu1(55, -14);
+
+    r.start_clock();
+    auto mu2 = mu0 * mu1;
+    r.stop_clock();
+
+    r.get_stream() << mu2;
+    r.check_pass("15/4");
+    return r;
+}
+
 /*
  * Test division.
  */
@@ -1436,3 +1558,203 @@ auto test_rational_print_7() -> result {
     return r;
 }
 
+
+/*
+ * Test conversion to characters.
+ */
+auto test_rational_to_chars_0() -> result {
+    result r("rat tch 0");
+    c8::rational v("-0xfedcfedc0123456789/65689");
+    char buf[64];
+
+    r.start_clock();
+    auto res = to_chars(buf, buf + sizeof(buf), v);
+    r.stop_clock();
+
+    r.get_stream() << std::string(buf, res.ptr);
+    r.check_pass("-4701397401952099592073/65689");
+    return r;
+}
+
+/*
+ * Test decimal conversion of a rational with large numerator and denominator into exact-size
+ * and one-short buffers.
+ */
+auto test_rational_to_chars_1() -> result {
+    result r("rat tch 1");
+    c8::integer p10(1);
+    for (int i = 0; i < 3000; i++) {
+        p10 *= 10;
+    }
+
+    c8::integer p2 = c8::integer(1) << 12345;
+    c8::rational vals[] = {c8::rational(-p2, p10 - 1), c8::rational(p10 - 1, p2)};
+
+    r.start_clock();
+    for (const auto &v : vals) {
+        std::ostringstream s;
+        s << v;
+        std::string expected = s.str();
+        std::vector<char> buf(expected.size());
+        auto res0 = to_chars(buf.data(), buf.data() + buf.size(), v);
+        auto res1 = to_chars(buf.data(), buf.data() + buf.size() - 1, v);
+        r.get_stream() << ((res0.ec == std::errc()) && (std::string(buf.data(), res0.ptr) == expected))
+                       << (res1.ec == std::errc::value_too_large) << ',';
+    }
+    r.stop_clock();
+
+    r.check_pass("11,11,");
+    return r;
+}
+
+/*
+ * Test that an unsupported base is rejected before anything is written.
+ */
+auto test_rational_to_chars_2() -> result {
+    result r("rat tch 2");
+    c8::rational v0(-22, 7);
+    c8::rational v1(22, 7);
+    char buf[2] = {'x', 'x'};
+
+    r.start_clock();
+    auto res0 = to_chars(buf, buf + 1, v0, 7);
+    auto res1 = to_chars(buf, buf + 2, v1, 9);
+    r.stop_clock();
+
+    r.get_stream() << (res0.ec == std::errc::invalid_argument) << (res1.ec == std::errc::invalid_argument) << ','
+                   << std::string(buf, 2);
+    r.check_pass("11,xx");
+    return r;
+}
+
+/*
+ * Test conversion from characters.
+ */
+auto test_rational_from_chars_0() -> result {
+    result r("rat fch 0");
+    std::string s0 = "-6/4 ";
+    std::string s1 = "5/x";
+    c8::rational v0;
+    c8::rational v1;
+
+    r.start_clock();
+    auto res0 = from_chars(s0.data(), s0.data() + s0.size(), v0);
+    auto res1 = from_chars(s1.data(), s1.data() + s1.size(), v1);
+    r.stop_clock();
+
+    r.get_stream() << v0 << ',' << (res0.ptr - s0.data()) << ',' << v1 << ',' << (res1.ptr - s1.data());
+    r.check_pass("-3/2,4,5/1,1");
+    return r;
+}
+
+/*
+ * Test arithmetic on temporaries.
+ */
+auto test_rational_temporary_0() -> result {
+    result r("rat temp 0");
+    c8::rational a(5, 1);
+    c8::rational b(-12, 1);
+    c8::rational c("3/4");
+
+    r.start_clock();
+    c8::rational d = (a + b) + c;
+    c8::rational e = (a - b) - a + b;
+    c8::rational f = a + (c + b);
+    r.stop_clock();
+
+    r.get_stream() << d << ',' << e << ',' << f;
+    r.check_pass("-25/4,0/1,-25/4");
+    return r;
+}
+
+/*
+ * Test arithmetic with long long operands.
+ */
+auto test_rational_word_0() -> result {
+    result r("rat word 0");
+    c8::rational v("-7/12");
+
+    r.start_clock();
+    c8::rational a = v + 2;
+    c8::rational s = v - 2;
+    c8::rational p = v * 8;
+    c8::rational q = v / -14;
+    c8::rational z0 = v * 0;
+    c8::rational z1 = c8::rational(3, 1) - 3;
+    c8::rational m = c8::rational(1, 2) * std::numeric_limits<long long>::min();
+    r.stop_clock();
+
+    r.get_stream() << a << ',' << s << ',' << p << ',' << q << ',' << z0 << ',' << z1 << ',' << m;
+    r.check_pass("17/12,-31/12,-14/3,1/24,0/1,0/1,-4611686018427387904/1");
+    return r;
+}
+
+/*
+ * Test compound assignment and comparisons with long long operands.
+ */
+auto test_rational_word_1() -> result {
+    result r("rat word 1");
+    c8::rational x("5/3");
+
+    r.start_clock();
+    r.get_stream() << (x > 1) << (x < 2) << (x == 1) << (x != 2) << (x >= -1) << (x <= 1) << ',';
+    x *= 3;
+    r.get_stream() << x << ',' << (x == 5) << ',';
+    x /= -10;
+    r.get_stream() << x << ',' << (x < 0) << (x > -1) << ',';
+    x += 1;
+    r.get_stream() << x << ',';
+    x -= 1;
+    r.get_stream() << x << ',';
+    x *= -2;
+    x -= 1;
+    r.stop_clock();
+
+    r.get_stream() << x << ',' << (x == 0);
+    r.check_pass("110110,5/1,1,-1/2,11,1/2,-1/2,0/1,1");
+    return r;
+}
+
+/*
+ * Test that floating point operands are converted exactly, rather than being truncated to
+ * long long.
+ */
+auto test_rational_word_2() -> result {
+    result r("rat word 2");
+    c8::rational v(1, 3);
+    c8::rational h(1, 2);
+
+    r.start_clock();
+    r.get_stream() << (v + 0.5) << ',' << (v - 0.5) << ',' << (v * 2.5) << ',' << (v / 0.5) << ',' << (v + 0.5f) << ','
+                   << (h == 0.5) << (h != 0.5) << (v < 0.5) << (v > 0.25) << (v >= 0.5) << (v <= 0.25) << ',';
+    c8::rational x = v;
+    x += 0.5;
+    r.get_stream() << x << ',';
+    x *= 1.5;
+    r.get_stream() << x << ',';
+    x -= 0.25;
+    r.get_stream() << x << ',';
+    x /= 0.5;
+    r.get_stream() << x << ',' << ((v + v) + 0.5) << ',' << ((v + v) - 0.5);
+    r.stop_clock();
+
+    r.check_pass("5/6,-1/6,5/6,2/3,5/6,101100,5/6,5/4,1/1,2/1,7/6,1/6");
+    return r;
+}
+
+/*
+ * Test comparisons of a zero with a negative sign against long long operands.
+ */
+auto test_rational_word_3() -> result {
+    result r("rat word 3");
+    c8::rational v(0, -41);
+
+    r.start_clock();
+    r.get_stream() << (v == 0) << (v != 0) << (v < 0) << (v <= 0) << (v > 0) << (v >= 0) << ','
+                   << (v == -1) << (v != -1) << (v < -1) << (v <= -1) << (v > -1) << (v >= -1) << ','
+                   << (v == 1) << (v != 1) << (v < 1) << (v <= 1) << (v > 1) << (v >= 1);
+    r.stop_clock();
+
+    r.check_pass("100101,010011,011100");
+    return r;
+}
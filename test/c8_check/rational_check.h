@@ -25,6 +25,7 @@ auto test_rational_add_2a() -> result;
 auto test_rational_add_2b() -> result;
 auto test_rational_add_3a() -> result;
 auto test_rational_add_3b() -> result;
+auto test_rational_add_4() -> result;
 auto test_rational_subtract_0a() -> result;
 auto test_rational_subtract_0b() -> result;
 auto test_rational_subtract_1a() -> result;
@@ -33,6 +34,7 @@ auto test_rational_subtract_2a() -> result;
 auto test_rational_subtract_2b() -> result;
 auto test_rational_subtract_3a() -> result;
 auto test_rational_subtract_3b() -> result;
+auto test_rational_subtract_4() -> result;
 auto test_rational_compare_0a() -> result;
 auto test_rational_compare_0b() -> result;
 auto test_rational_compare_0c() -> result;
@@ -57,6 +59,10 @@ auto test_rational_compare_3c() -> result;
 auto test_rational_compare_3d() -> result;
 auto test_rational_compare_3e() -> result;
 auto test_rational_compare_3f() -> result;
+auto test_rational_compare_4a() -> result;
+auto test_rational_compare_4b() -> result;
+auto test_rational_compare_4c() -> result;
+auto test_rational_compare_4d() -> result;
 auto test_rational_multiply_0a() -> result;
 auto test_rational_multiply_0b() -> result;
 auto test_rational_multiply_1a() -> result;
@@ -65,6 +71,7 @@ auto test_rational_multiply_2a() -> result;
 auto test_rational_multiply_2b() -> result;
 auto test_rational_multiply_3a() -> result;
 auto test_rational_multiply_3b() -> result;
+auto test_rational_multiply_4() -> result;
 auto test_rational_divide_0a() -> result;
 auto test_rational_divide_0b() -> result;
 auto test_rational_divide_1a() -> result;
@@ -90,6 +97,15 @@ auto test_rational_print_4() -> result;
 auto test_rational_print_5() -> result;
 auto test_rational_print_6() -> result;
 auto test_rational_print_7() -> result;
+auto test_rational_to_chars_0() -> result;
+auto test_rational_to_chars_1() -> result;
+auto test_rational_to_chars_2() -> result;
+auto test_rational_from_chars_0() -> result;
+auto test_rational_temporary_0() -> result;
+auto test_rational_word_0() -> result;
+auto test_rational_word_1() -> result;
+auto test_rational_word_2() -> result;
+auto test_rational_word_3() -> result;
 
 #endif // __RATIONAL_CHECK_H
 